@@ -0,0 +1,46 @@
+#pragma once
+
+#include <benchmark/benchmark.h>
+#include "../include/simdlib/simd_perf.hpp"
+
+// Hardware counters of the timed loop as per-iteration benchmark counters. Construct right
+// before `for (auto _ : state)`; the counters are added when it goes out of scope. Does
+// nothing unless the library was built with SIMDLIB_PERF.
+class perf_report
+{
+  public:
+#ifdef SIMDLIB_PERF
+    explicit perf_report(benchmark::State &state)
+        : state_(state), begin_(simdlib::perf_counters::thread_local_instance().read())
+    {
+    }
+
+    perf_report(const perf_report &) = delete;
+    perf_report &operator=(const perf_report &) = delete;
+
+    ~perf_report()
+    {
+        const simdlib::perf_sample delta =
+            simdlib::perf_counters::thread_local_instance().read() - begin_;
+        for (size_t e = 0; e < simdlib::perf_event_count; ++e)
+        {
+            const auto event = static_cast<simdlib::perf_event>(e);
+            if (delta.has(event))
+                state_.counters[simdlib::perf_event_name(event)] = benchmark::Counter(
+                    static_cast<double>(delta[event]), benchmark::Counter::kAvgIterations);
+        }
+        if (delta.has(simdlib::perf_event::cycles) && delta[simdlib::perf_event::cycles] != 0 &&
+            delta.has(simdlib::perf_event::instructions))
+            state_.counters["ipc"] = static_cast<double>(delta[simdlib::perf_event::instructions]) /
+                                     static_cast<double>(delta[simdlib::perf_event::cycles]);
+    }
+
+  private:
+    benchmark::State &state_;
+    simdlib::perf_sample begin_;
+#else
+    explicit perf_report(benchmark::State &)
+    {
+    }
+#endif
+};
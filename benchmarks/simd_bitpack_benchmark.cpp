@@ -0,0 +1,125 @@
+#include <benchmark/benchmark.h>
+#include "../include/simdlib/simd_bitpack.hpp"
+#include <random>
+#include <vector>
+
+// column decode at several widths: the scalar loop over a horizontally packed bit stream that
+// the column store used before, against packed_column's vertical blocks into int32 and float
+
+namespace
+{
+
+constexpr size_t value_count = size_t{1} << 20;
+
+std::vector<int32_t> column(unsigned bits)
+{
+    std::mt19937 rng(3);
+    std::vector<int32_t> values(value_count);
+    for (auto &v : values)
+        v = 1000 + static_cast<int32_t>(rng() & simdlib::detail::low_bits_mask(bits));
+    return values;
+}
+
+// values - 1000 packed one after another into 64-bit words
+std::vector<uint64_t> pack_horizontal(const std::vector<int32_t> &values, unsigned bits)
+{
+    std::vector<uint64_t> words((values.size() * bits + 63) / 64 + 1);
+    for (size_t i = 0; i < values.size(); ++i)
+    {
+        const auto v = static_cast<uint64_t>(values[i] - 1000);
+        const size_t bit = i * bits;
+        words[bit / 64] |= v << (bit % 64);
+        if (bit % 64 + bits > 64)
+            words[bit / 64 + 1] |= v >> (64 - bit % 64);
+    }
+    return words;
+}
+
+void set_items(benchmark::State &state)
+{
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * value_count));
+}
+
+} // namespace
+
+static void BM_UnpackScalar(benchmark::State &state)
+{
+    const auto bits = static_cast<unsigned>(state.range(0));
+    const auto words = pack_horizontal(column(bits), bits);
+    const uint64_t mask = simdlib::detail::low_bits_mask(bits);
+    std::vector<int32_t> out(value_count);
+    for (auto _ : state)
+    {
+        for (size_t i = 0; i < value_count; ++i)
+        {
+            const size_t bit = i * bits;
+            const unsigned shift = bit % 64;
+            uint64_t v = words[bit / 64] >> shift;
+            if (shift + bits > 64)
+                v |= words[bit / 64 + 1] << (64 - shift);
+            out[i] = 1000 + static_cast<int32_t>(v & mask);
+        }
+        benchmark::DoNotOptimize(out.data());
+    }
+    set_items(state);
+}
+BENCHMARK(BM_UnpackScalar)->Arg(5)->Arg(13)->Arg(27);
+
+static void BM_PackedColumnDecode(benchmark::State &state)
+{
+    const simdlib::packed_column packed(column(static_cast<unsigned>(state.range(0))));
+    simdlib::aligned_vector<int32_t> out(value_count);
+    for (auto _ : state)
+    {
+        packed.decode(out);
+        benchmark::DoNotOptimize(out.data());
+    }
+    set_items(state);
+}
+BENCHMARK(BM_PackedColumnDecode)->Arg(5)->Arg(13)->Arg(27);
+
+static void BM_PackedColumnDecodeFloat(benchmark::State &state)
+{
+    const simdlib::packed_column packed(column(static_cast<unsigned>(state.range(0))));
+    simdlib::aligned_vector<float> out(value_count);
+    for (auto _ : state)
+    {
+        packed.decode(out);
+        benchmark::DoNotOptimize(out.data());
+    }
+    set_items(state);
+}
+BENCHMARK(BM_PackedColumnDecodeFloat)->Arg(5)->Arg(13)->Arg(27);
+
+static void BM_PackedColumnDecodeDelta(benchmark::State &state)
+{
+    // sorted ids with small gaps
+    std::vector<int32_t> ids(value_count);
+    std::mt19937 rng(5);
+    int32_t id = 0;
+    for (auto &v : ids)
+        v = id += static_cast<int32_t>(rng() % 8);
+    const simdlib::packed_column packed(ids, simdlib::bitpack_encoding::delta);
+    simdlib::aligned_vector<int32_t> out(value_count);
+    for (auto _ : state)
+    {
+        packed.decode(out);
+        benchmark::DoNotOptimize(out.data());
+    }
+    set_items(state);
+    state.counters["bytes_per_value"] =
+        static_cast<double>(packed.packed_bytes()) / static_cast<double>(value_count);
+}
+BENCHMARK(BM_PackedColumnDecodeDelta);
+
+static void BM_PackedColumnEncode(benchmark::State &state)
+{
+    const auto values = column(static_cast<unsigned>(state.range(0)));
+    for (auto _ : state)
+    {
+        const simdlib::packed_column packed(values);
+        benchmark::DoNotOptimize(packed.packed_bytes());
+    }
+    set_items(state);
+}
+BENCHMARK(BM_PackedColumnEncode)->Arg(13);
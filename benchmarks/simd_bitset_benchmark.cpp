@@ -0,0 +1,118 @@
+#include <benchmark/benchmark.h>
+#include "../include/simdlib/simd_bitset.hpp"
+#include <bit>
+#include <random>
+#include <vector>
+
+// bitmap intersections with a fused popcount against the scalar 64-bit loop, on maps that fit
+// in L2 and on 128M-bit maps that stream from memory
+
+namespace
+{
+
+std::vector<uint64_t> bitmap(size_t words, unsigned seed)
+{
+    std::mt19937_64 rng(seed);
+    std::vector<uint64_t> map(words);
+    for (auto &w : map)
+        w = rng();
+    return map;
+}
+
+void set_bytes(benchmark::State &state, size_t streams)
+{
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations()) * state.range(0) *
+                            static_cast<int64_t>(streams * sizeof(uint64_t)));
+}
+
+} // namespace
+
+static void BM_BitmapAndScalar(benchmark::State &state)
+{
+    const auto words = static_cast<size_t>(state.range(0));
+    const auto a = bitmap(words, 1);
+    const auto b = bitmap(words, 2);
+    std::vector<uint64_t> out(words);
+    for (auto _ : state)
+    {
+        uint64_t count = 0;
+        for (size_t i = 0; i < words; ++i)
+        {
+            out[i] = a[i] & b[i];
+            count += static_cast<uint64_t>(std::popcount(out[i]));
+        }
+        benchmark::DoNotOptimize(count);
+        benchmark::DoNotOptimize(out.data());
+    }
+    set_bytes(state, 3);
+}
+BENCHMARK(BM_BitmapAndScalar)->Arg(1 << 14)->Arg(1 << 21);
+
+static void BM_BitmapAnd(benchmark::State &state)
+{
+    const auto words = static_cast<size_t>(state.range(0));
+    const auto a = bitmap(words, 1);
+    const auto b = bitmap(words, 2);
+    std::vector<uint64_t> out(words);
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(simdlib::bitmap_and(a, b, out));
+        benchmark::DoNotOptimize(out.data());
+    }
+    set_bytes(state, 3);
+}
+BENCHMARK(BM_BitmapAnd)->Arg(1 << 14)->Arg(1 << 21);
+
+static void BM_BitmapAndCountScalar(benchmark::State &state)
+{
+    const auto words = static_cast<size_t>(state.range(0));
+    const auto a = bitmap(words, 1);
+    const auto b = bitmap(words, 2);
+    for (auto _ : state)
+    {
+        uint64_t count = 0;
+        for (size_t i = 0; i < words; ++i)
+            count += static_cast<uint64_t>(std::popcount(a[i] & b[i]));
+        benchmark::DoNotOptimize(count);
+    }
+    set_bytes(state, 2);
+}
+BENCHMARK(BM_BitmapAndCountScalar)->Arg(1 << 14)->Arg(1 << 21);
+
+static void BM_BitmapAndCount(benchmark::State &state)
+{
+    const auto words = static_cast<size_t>(state.range(0));
+    const auto a = bitmap(words, 1);
+    const auto b = bitmap(words, 2);
+    for (auto _ : state)
+        benchmark::DoNotOptimize(simdlib::bitmap_and_count(a, b));
+    set_bytes(state, 2);
+}
+BENCHMARK(BM_BitmapAndCount)->Arg(1 << 14)->Arg(1 << 21);
+
+static void BM_BitmapPopcount(benchmark::State &state)
+{
+    const auto words = static_cast<size_t>(state.range(0));
+    const auto a = bitmap(words, 1);
+    for (auto _ : state)
+        benchmark::DoNotOptimize(simdlib::bitmap_popcount(a));
+    set_bytes(state, 1);
+}
+BENCHMARK(BM_BitmapPopcount)->Arg(1 << 14)->Arg(1 << 21);
+
+static void BM_SetBitPositions(benchmark::State &state)
+{
+    const auto words = static_cast<size_t>(1) << 14;
+    // about one bit in eight set
+    auto a = bitmap(words, 1);
+    const auto b = bitmap(words, 2);
+    const auto c = bitmap(words, 3);
+    for (size_t i = 0; i < words; ++i)
+        a[i] &= b[i] & c[i];
+    std::vector<uint32_t> positions(simdlib::bitmap_popcount(a) + 3);
+    for (auto _ : state)
+        benchmark::DoNotOptimize(simdlib::set_bit_positions(a, positions));
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations()) *
+                            static_cast<int64_t>(positions.size() - 3));
+}
+BENCHMARK(BM_SetBitPositions);
@@ -0,0 +1,128 @@
+#include <benchmark/benchmark.h>
+#include "../include/simdlib/simd_complex.hpp"
+#include <complex>
+#include <random>
+#include <vector>
+
+// complex multiply-accumulate and dot products over interleaved and split arrays, against the
+// plain std::complex loops
+
+namespace
+{
+
+std::vector<std::complex<float>> signal(size_t n, unsigned seed)
+{
+    std::mt19937 rng(seed);
+    std::uniform_real_distribution<float> dist(-1.0f, 1.0f);
+    std::vector<std::complex<float>> z(n);
+    for (auto &v : z)
+        v = {dist(rng), dist(rng)};
+    return z;
+}
+
+void set_items(benchmark::State &state)
+{
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations()) * state.range(0));
+}
+
+} // namespace
+
+static void BM_ComplexMacScalar(benchmark::State &state)
+{
+    const auto n = static_cast<size_t>(state.range(0));
+    const auto a = signal(n, 1);
+    const auto b = signal(n, 2);
+    std::vector<std::complex<float>> acc(n);
+    for (auto _ : state)
+    {
+        for (size_t i = 0; i < n; ++i)
+            acc[i] += a[i] * b[i];
+        benchmark::DoNotOptimize(acc.data());
+    }
+    set_items(state);
+}
+BENCHMARK(BM_ComplexMacScalar)->Arg(4096)->Arg(1 << 20);
+
+static void BM_ComplexMac(benchmark::State &state)
+{
+    const auto n = static_cast<size_t>(state.range(0));
+    const auto a = signal(n, 1);
+    const auto b = signal(n, 2);
+    std::vector<std::complex<float>> acc(n);
+    for (auto _ : state)
+    {
+        simdlib::complex_multiply_accumulate(a, b, acc);
+        benchmark::DoNotOptimize(acc.data());
+    }
+    set_items(state);
+}
+BENCHMARK(BM_ComplexMac)->Arg(4096)->Arg(1 << 20);
+
+static void BM_ComplexMacSplit(benchmark::State &state)
+{
+    const auto n = static_cast<size_t>(state.range(0));
+    std::vector<float> are(n), aim(n), bre(n), bim(n), cre(n), cim(n);
+    simdlib::deinterleave(signal(n, 1), {are, aim});
+    simdlib::deinterleave(signal(n, 2), {bre, bim});
+    for (auto _ : state)
+    {
+        simdlib::complex_multiply_accumulate({are, aim}, {bre, bim}, {cre, cim});
+        benchmark::DoNotOptimize(cre.data());
+        benchmark::DoNotOptimize(cim.data());
+    }
+    set_items(state);
+}
+BENCHMARK(BM_ComplexMacSplit)->Arg(4096)->Arg(1 << 20);
+
+static void BM_ComplexDotConjScalar(benchmark::State &state)
+{
+    const auto n = static_cast<size_t>(state.range(0));
+    const auto a = signal(n, 1);
+    const auto b = signal(n, 2);
+    for (auto _ : state)
+    {
+        std::complex<float> sum;
+        for (size_t i = 0; i < n; ++i)
+            sum += std::conj(a[i]) * b[i];
+        benchmark::DoNotOptimize(sum);
+    }
+    set_items(state);
+}
+BENCHMARK(BM_ComplexDotConjScalar)->Arg(4096)->Arg(1 << 20);
+
+static void BM_ComplexDotConj(benchmark::State &state)
+{
+    const auto n = static_cast<size_t>(state.range(0));
+    const auto a = signal(n, 1);
+    const auto b = signal(n, 2);
+    for (auto _ : state)
+        benchmark::DoNotOptimize(simdlib::complex_dot_conj(a, b));
+    set_items(state);
+}
+BENCHMARK(BM_ComplexDotConj)->Arg(4096)->Arg(1 << 20);
+
+static void BM_ComplexDotConjSplit(benchmark::State &state)
+{
+    const auto n = static_cast<size_t>(state.range(0));
+    std::vector<float> are(n), aim(n), bre(n), bim(n);
+    simdlib::deinterleave(signal(n, 1), {are, aim});
+    simdlib::deinterleave(signal(n, 2), {bre, bim});
+    for (auto _ : state)
+        benchmark::DoNotOptimize(simdlib::complex_dot_conj({are, aim}, {bre, bim}));
+    set_items(state);
+}
+BENCHMARK(BM_ComplexDotConjSplit)->Arg(4096)->Arg(1 << 20);
+
+static void BM_ComplexAbs(benchmark::State &state)
+{
+    const auto n = static_cast<size_t>(state.range(0));
+    const auto z = signal(n, 3);
+    std::vector<float> out(n);
+    for (auto _ : state)
+    {
+        simdlib::complex_abs(z, out);
+        benchmark::DoNotOptimize(out.data());
+    }
+    set_items(state);
+}
+BENCHMARK(BM_ComplexAbs)->Arg(4096)->Arg(1 << 20);
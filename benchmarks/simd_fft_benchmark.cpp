@@ -0,0 +1,154 @@
+#include <benchmark/benchmark.h>
+#include "../include/simdlib/simd_fft.hpp"
+#include <bit>
+#include <cmath>
+#include <complex>
+#include <numbers>
+#include <random>
+#include <vector>
+
+// complex and real FFTs through a cached plan against a textbook scalar radix-2 transform
+// (bit reversal, then in-place butterflies on std::complex with precomputed twiddles)
+
+namespace
+{
+
+std::vector<std::complex<float>> signal(size_t n)
+{
+    std::mt19937 rng(5);
+    std::uniform_real_distribution<float> dist(-1.0f, 1.0f);
+    std::vector<std::complex<float>> z(n);
+    for (auto &v : z)
+        v = {dist(rng), dist(rng)};
+    return z;
+}
+
+size_t reverse_bits(size_t i, int bits)
+{
+    size_t r = 0;
+    for (int b = 0; b < bits; ++b, i >>= 1)
+        r = (r << 1) | (i & 1);
+    return r;
+}
+
+void scalar_fft(std::vector<std::complex<float>> &x, const std::vector<std::complex<float>> &roots)
+{
+    const size_t n = x.size();
+    const int bits = std::countr_zero(n);
+    for (size_t i = 0; i < n; ++i)
+    {
+        const size_t j = reverse_bits(i, bits);
+        if (i < j)
+            std::swap(x[i], x[j]);
+    }
+    for (size_t length = 2; length <= n; length *= 2)
+    {
+        const size_t step = n / length;
+        for (size_t base = 0; base < n; base += length)
+        {
+            for (size_t j = 0; j < length / 2; ++j)
+            {
+                const std::complex<float> a = x[base + j];
+                const std::complex<float> b = x[base + j + length / 2] * roots[j * step];
+                x[base + j] = a + b;
+                x[base + j + length / 2] = a - b;
+            }
+        }
+    }
+}
+
+// items are complex values transformed, flops follow the usual 5 n log2 n convention
+void set_counters(benchmark::State &state, size_t n, size_t transforms)
+{
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * n * transforms));
+    state.counters["gflops"] = benchmark::Counter(
+        static_cast<double>(state.iterations() * transforms) * 5.0 * static_cast<double>(n) *
+            std::log2(static_cast<double>(n)) / 1e9,
+        benchmark::Counter::kIsRate);
+}
+
+} // namespace
+
+static void BM_FftScalar(benchmark::State &state)
+{
+    const auto n = static_cast<size_t>(state.range(0));
+    const auto x = signal(n);
+    std::vector<std::complex<float>> roots(n / 2);
+    for (size_t j = 0; j < n / 2; ++j)
+        roots[j] = std::polar(1.0f, static_cast<float>(-2.0 * std::numbers::pi *
+                                                       static_cast<double>(j) /
+                                                       static_cast<double>(n)));
+    std::vector<std::complex<float>> work(n);
+    for (auto _ : state)
+    {
+        work = x;
+        scalar_fft(work, roots);
+        benchmark::DoNotOptimize(work.data());
+    }
+    set_counters(state, n, 1);
+}
+BENCHMARK(BM_FftScalar)->Arg(256)->Arg(1024)->Arg(4096)->Arg(1 << 16)->Arg(1 << 20);
+
+static void BM_Fft(benchmark::State &state)
+{
+    const auto n = static_cast<size_t>(state.range(0));
+    const auto x = signal(n);
+    const simdlib::fft_plan &plan = simdlib::fft_plan::cached(n);
+    std::vector<std::complex<float>> out(n);
+    for (auto _ : state)
+    {
+        plan.forward(x, out);
+        benchmark::DoNotOptimize(out.data());
+    }
+    set_counters(state, n, 1);
+}
+BENCHMARK(BM_Fft)->Arg(256)->Arg(1024)->Arg(4096)->Arg(1 << 16)->Arg(1 << 20);
+
+static void BM_FftSplit(benchmark::State &state)
+{
+    const auto n = static_cast<size_t>(state.range(0));
+    std::vector<float> re(n), im(n), out_re(n), out_im(n);
+    simdlib::deinterleave(signal(n), {re, im});
+    const simdlib::fft_plan &plan = simdlib::fft_plan::cached(n);
+    for (auto _ : state)
+    {
+        plan.forward({re, im}, {out_re, out_im});
+        benchmark::DoNotOptimize(out_re.data());
+    }
+    set_counters(state, n, 1);
+}
+BENCHMARK(BM_FftSplit)->Arg(1024)->Arg(1 << 16);
+
+static void BM_RealFft(benchmark::State &state)
+{
+    const auto n = static_cast<size_t>(state.range(0));
+    std::vector<float> x(n);
+    for (size_t i = 0; i < n; ++i)
+        x[i] = std::sin(0.01f * static_cast<float>(i));
+    const simdlib::real_fft_plan &plan = simdlib::real_fft_plan::cached(n);
+    std::vector<std::complex<float>> out(n / 2 + 1);
+    for (auto _ : state)
+    {
+        plan.forward(x, out);
+        benchmark::DoNotOptimize(out.data());
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * n));
+}
+BENCHMARK(BM_RealFft)->Arg(1024)->Arg(1 << 16);
+
+static void BM_FftBatch(benchmark::State &state)
+{
+    constexpr size_t n = 256;
+    constexpr size_t count = 4096;
+    const auto x = signal(n * count);
+    const simdlib::fft_plan &plan = simdlib::fft_plan::cached(n);
+    std::vector<std::complex<float>> out(x.size());
+    const auto threads = static_cast<size_t>(state.range(0));
+    for (auto _ : state)
+    {
+        plan.forward_batch(x, out, threads);
+        benchmark::DoNotOptimize(out.data());
+    }
+    set_counters(state, n, count);
+}
+BENCHMARK(BM_FftBatch)->Arg(1)->Arg(0)->Unit(benchmark::kMillisecond);
@@ -0,0 +1,147 @@
+#include <benchmark/benchmark.h>
+#include "../include/simdlib/simd_hash.hpp"
+#include <random>
+#include <vector>
+
+// eight-lane key hashing against the scalar finalizer loop, and the three-stream CRC32C against
+// a single dependent chain of crc32 instructions
+
+namespace
+{
+
+template <typename Key> std::vector<Key> random_keys(size_t n)
+{
+    std::mt19937_64 rng(7);
+    std::vector<Key> keys(n);
+    for (auto &k : keys)
+        k = static_cast<Key>(rng());
+    return keys;
+}
+
+std::vector<std::byte> random_bytes(size_t n)
+{
+    std::mt19937 rng(8);
+    std::vector<std::byte> bytes(n);
+    for (auto &b : bytes)
+        b = static_cast<std::byte>(rng());
+    return bytes;
+}
+
+constexpr size_t key_count = size_t{1} << 16;
+
+} // namespace
+
+static void BM_HashKeys32Scalar(benchmark::State &state)
+{
+    const auto keys = random_keys<uint32_t>(key_count);
+    std::vector<uint32_t> out(key_count);
+    for (auto _ : state)
+    {
+        for (size_t i = 0; i < key_count; ++i)
+            out[i] = simdlib::hash32(keys[i]);
+        benchmark::DoNotOptimize(out.data());
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * key_count));
+}
+BENCHMARK(BM_HashKeys32Scalar);
+
+static void BM_HashKeys32(benchmark::State &state)
+{
+    const auto keys = random_keys<uint32_t>(key_count);
+    std::vector<uint32_t> out(key_count);
+    for (auto _ : state)
+    {
+        simdlib::hash_keys(keys, out);
+        benchmark::DoNotOptimize(out.data());
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * key_count));
+}
+BENCHMARK(BM_HashKeys32);
+
+static void BM_HashKeys64Scalar(benchmark::State &state)
+{
+    const auto keys = random_keys<uint64_t>(key_count);
+    std::vector<uint32_t> out(key_count);
+    for (auto _ : state)
+    {
+        for (size_t i = 0; i < key_count; ++i)
+            out[i] = simdlib::hash64(keys[i]);
+        benchmark::DoNotOptimize(out.data());
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * key_count));
+}
+BENCHMARK(BM_HashKeys64Scalar);
+
+static void BM_HashKeys64(benchmark::State &state)
+{
+    const auto keys = random_keys<uint64_t>(key_count);
+    std::vector<uint32_t> out(key_count);
+    for (auto _ : state)
+    {
+        simdlib::hash_keys(keys, out);
+        benchmark::DoNotOptimize(out.data());
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * key_count));
+}
+BENCHMARK(BM_HashKeys64);
+
+static void BM_PartitionKeysScalar(benchmark::State &state)
+{
+    const auto keys = random_keys<uint64_t>(key_count);
+    std::vector<uint32_t> out(key_count);
+    for (auto _ : state)
+    {
+        for (size_t i = 0; i < key_count; ++i)
+            out[i] = simdlib::hash64(keys[i]) % 1000;
+        benchmark::DoNotOptimize(out.data());
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * key_count));
+}
+BENCHMARK(BM_PartitionKeysScalar);
+
+static void BM_PartitionKeys(benchmark::State &state)
+{
+    const auto keys = random_keys<uint64_t>(key_count);
+    std::vector<uint32_t> out(key_count);
+    for (auto _ : state)
+    {
+        simdlib::partition_keys(keys, 1000, out);
+        benchmark::DoNotOptimize(out.data());
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * key_count));
+}
+BENCHMARK(BM_PartitionKeys);
+
+static void BM_Crc32cSerial(benchmark::State &state)
+{
+    const auto bytes = random_bytes(static_cast<size_t>(state.range(0)));
+    const auto *p = reinterpret_cast<const unsigned char *>(bytes.data());
+    for (auto _ : state)
+        benchmark::DoNotOptimize(~simdlib::detail::crc32c_serial(~uint32_t{0}, p, bytes.size()));
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * bytes.size()));
+}
+BENCHMARK(BM_Crc32cSerial)->Arg(4096)->Arg(1 << 16)->Arg(1 << 24);
+
+static void BM_Crc32c(benchmark::State &state)
+{
+    const auto bytes = random_bytes(static_cast<size_t>(state.range(0)));
+    for (auto _ : state)
+        benchmark::DoNotOptimize(simdlib::crc32c(bytes));
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * bytes.size()));
+}
+BENCHMARK(BM_Crc32c)->Arg(4096)->Arg(1 << 16)->Arg(1 << 24);
+
+static void BM_Crc32cBlocks(benchmark::State &state)
+{
+    const auto bytes = random_bytes(size_t{1} << 26);
+    constexpr size_t block = size_t{1} << 16;
+    std::vector<uint32_t> out(bytes.size() / block);
+    const auto threads = static_cast<size_t>(state.range(0));
+    for (auto _ : state)
+    {
+        simdlib::crc32c_blocks(bytes, block, out, threads);
+        benchmark::DoNotOptimize(out.data());
+    }
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * bytes.size()));
+}
+BENCHMARK(BM_Crc32cBlocks)->Arg(1)->Arg(0)->Unit(benchmark::kMillisecond);
@@ -0,0 +1,124 @@
+#include <benchmark/benchmark.h>
+#include "../include/simdlib/simd_image.hpp"
+#include <algorithm>
+#include <cmath>
+#include <random>
+#include <vector>
+
+// one 1080p RGBA8 frame to normalized planar RGB and back, against the three scalar passes the
+// preprocessing did before: widen to interleaved floats, split the channels, normalize
+
+namespace
+{
+
+constexpr size_t frame_pixels = 1920 * 1080;
+
+std::vector<uint8_t> frame()
+{
+    std::mt19937 rng(4);
+    std::vector<uint8_t> rgba(4 * frame_pixels);
+    for (auto &b : rgba)
+        b = static_cast<uint8_t>(rng());
+    return rgba;
+}
+
+simdlib::pixel_normalization imagenet()
+{
+    simdlib::pixel_normalization norm;
+    norm.mean = {0.485f, 0.456f, 0.406f, 0.5f};
+    norm.stddev = {0.229f, 0.224f, 0.225f, 0.5f};
+    return norm;
+}
+
+void set_bytes(benchmark::State &state)
+{
+    // the frame read plus three float planes written, or the reverse
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * frame_pixels *
+                                                 (4 + 3 * sizeof(float))));
+}
+
+} // namespace
+
+static void BM_Rgba8ToPlanarScalar(benchmark::State &state)
+{
+    const auto rgba = frame();
+    const auto norm = imagenet();
+    std::vector<float> interleaved(rgba.size());
+    std::vector<float> planar(3 * frame_pixels);
+    for (auto _ : state)
+    {
+        for (size_t i = 0; i < rgba.size(); ++i)
+            interleaved[i] = static_cast<float>(rgba[i]);
+        for (size_t i = 0; i < frame_pixels; ++i)
+        {
+            for (size_t c = 0; c < 3; ++c)
+                planar[c * frame_pixels + i] = interleaved[4 * i + c];
+        }
+        for (size_t c = 0; c < 3; ++c)
+        {
+            for (size_t i = 0; i < frame_pixels; ++i)
+            {
+                float &v = planar[c * frame_pixels + i];
+                v = (v * norm.scale - norm.mean[c]) / norm.stddev[c];
+            }
+        }
+        benchmark::DoNotOptimize(planar.data());
+    }
+    set_bytes(state);
+}
+BENCHMARK(BM_Rgba8ToPlanarScalar)->Unit(benchmark::kMillisecond);
+
+static void BM_Rgba8ToPlanar(benchmark::State &state)
+{
+    const auto rgba = frame();
+    const auto norm = imagenet();
+    std::vector<float> planar(3 * frame_pixels);
+    const auto threads = static_cast<size_t>(state.range(0));
+    for (auto _ : state)
+    {
+        simdlib::rgba8_to_planar(rgba, planar, norm, threads);
+        benchmark::DoNotOptimize(planar.data());
+    }
+    set_bytes(state);
+}
+BENCHMARK(BM_Rgba8ToPlanar)->Arg(1)->Arg(0)->Unit(benchmark::kMillisecond);
+
+static void BM_PlanarToRgba8Scalar(benchmark::State &state)
+{
+    const auto norm = imagenet();
+    std::vector<float> planar(3 * frame_pixels);
+    simdlib::rgba8_to_planar(frame(), planar, norm);
+    std::vector<uint8_t> rgba(4 * frame_pixels);
+    for (auto _ : state)
+    {
+        for (size_t i = 0; i < frame_pixels; ++i)
+        {
+            for (size_t c = 0; c < 3; ++c)
+            {
+                const float v =
+                    (planar[c * frame_pixels + i] * norm.stddev[c] + norm.mean[c]) / norm.scale;
+                rgba[4 * i + c] = static_cast<uint8_t>(std::clamp(std::nearbyint(v), 0.0f, 255.0f));
+            }
+            rgba[4 * i + 3] = 255;
+        }
+        benchmark::DoNotOptimize(rgba.data());
+    }
+    set_bytes(state);
+}
+BENCHMARK(BM_PlanarToRgba8Scalar)->Unit(benchmark::kMillisecond);
+
+static void BM_PlanarToRgba8(benchmark::State &state)
+{
+    const auto norm = imagenet();
+    std::vector<float> planar(3 * frame_pixels);
+    simdlib::rgba8_to_planar(frame(), planar, norm);
+    std::vector<uint8_t> rgba(4 * frame_pixels);
+    const auto threads = static_cast<size_t>(state.range(0));
+    for (auto _ : state)
+    {
+        simdlib::planar_to_rgba8(planar, rgba, norm, threads);
+        benchmark::DoNotOptimize(rgba.data());
+    }
+    set_bytes(state);
+}
+BENCHMARK(BM_PlanarToRgba8)->Arg(1)->Arg(0)->Unit(benchmark::kMillisecond);
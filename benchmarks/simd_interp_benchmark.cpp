@@ -0,0 +1,102 @@
+#include <benchmark/benchmark.h>
+#include "../include/simdlib/simd_interp.hpp"
+#include <algorithm>
+#include <random>
+#include <vector>
+
+// piecewise-linear tables of several sizes over 1M random inputs: the std::upper_bound and lerp
+// loop the calibration code ran before, against interp1d on knot and uniform tables
+
+namespace
+{
+
+constexpr size_t input_count = size_t{1} << 20;
+
+struct curve
+{
+    std::vector<float> knots;
+    std::vector<float> values;
+};
+
+curve random_curve(size_t n)
+{
+    std::mt19937 rng(6);
+    std::uniform_real_distribution<float> gap(0.1f, 1.0f);
+    curve c;
+    float x = 0.0f;
+    for (size_t k = 0; k < n; ++k)
+    {
+        c.knots.push_back(x += gap(rng));
+        c.values.push_back(gap(rng));
+    }
+    return c;
+}
+
+std::vector<float> inputs(const curve &c)
+{
+    std::mt19937 rng(7);
+    std::uniform_real_distribution<float> dist(c.knots.front(), c.knots.back());
+    std::vector<float> xs(input_count);
+    for (auto &x : xs)
+        x = dist(rng);
+    return xs;
+}
+
+void set_items(benchmark::State &state)
+{
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * input_count));
+}
+
+} // namespace
+
+static void BM_InterpScalar(benchmark::State &state)
+{
+    const auto c = random_curve(static_cast<size_t>(state.range(0)));
+    const auto xs = inputs(c);
+    std::vector<float> out(input_count);
+    for (auto _ : state)
+    {
+        for (size_t i = 0; i < input_count; ++i)
+        {
+            const float x = std::clamp(xs[i], c.knots.front(), c.knots.back());
+            const size_t k = static_cast<size_t>(std::upper_bound(c.knots.begin() + 1,
+                                                                  c.knots.end() - 1, x) -
+                                                 c.knots.begin()) - 1;
+            const float f = (x - c.knots[k]) / (c.knots[k + 1] - c.knots[k]);
+            out[i] = c.values[k] + f * (c.values[k + 1] - c.values[k]);
+        }
+        benchmark::DoNotOptimize(out.data());
+    }
+    set_items(state);
+}
+BENCHMARK(BM_InterpScalar)->Arg(8)->Arg(16)->Arg(64)->Arg(128)->Arg(4096);
+
+static void BM_InterpKnots(benchmark::State &state)
+{
+    const auto c = random_curve(static_cast<size_t>(state.range(0)));
+    const auto xs = inputs(c);
+    const simdlib::interp_table table(c.knots, c.values);
+    std::vector<float> out(input_count);
+    for (auto _ : state)
+    {
+        simdlib::interp1d(xs, table, out);
+        benchmark::DoNotOptimize(out.data());
+    }
+    set_items(state);
+}
+BENCHMARK(BM_InterpKnots)->Arg(8)->Arg(16)->Arg(64)->Arg(128)->Arg(4096);
+
+static void BM_InterpUniform(benchmark::State &state)
+{
+    const auto c = random_curve(static_cast<size_t>(state.range(0)));
+    const auto xs = inputs(c);
+    const simdlib::interp_table table(c.knots.front(), c.knots.back(), c.values);
+    std::vector<float> out(input_count);
+    for (auto _ : state)
+    {
+        simdlib::interp1d(xs, table, out);
+        benchmark::DoNotOptimize(out.data());
+    }
+    set_items(state);
+}
+BENCHMARK(BM_InterpUniform)->Arg(8)->Arg(16)->Arg(64)->Arg(4096);
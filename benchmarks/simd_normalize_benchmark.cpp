@@ -0,0 +1,132 @@
+#include <benchmark/benchmark.h>
+#include "../include/simdlib/simd_normalize.hpp"
+#include <algorithm>
+#include <cmath>
+#include <random>
+#include <vector>
+
+// softmax, log-sum-exp and layer norm over a [rows][cols] batch: the fused kernels against the
+// separate max, exp, sum and scale passes they replace
+
+namespace
+{
+
+constexpr size_t batch_rows = 4096;
+
+std::vector<float> batch(size_t cols)
+{
+    std::mt19937 rng(7);
+    std::uniform_real_distribution<float> dist(-8.0f, 8.0f);
+    std::vector<float> values(batch_rows * cols);
+    for (auto &v : values)
+        v = dist(rng);
+    return values;
+}
+
+void set_bytes(benchmark::State &state, size_t cols)
+{
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations()) *
+                            static_cast<int64_t>(batch_rows * cols * sizeof(float)));
+}
+
+} // namespace
+
+static void BM_SoftmaxRows(benchmark::State &state)
+{
+    const auto cols = static_cast<size_t>(state.range(0));
+    const std::vector<float> src = batch(cols);
+    std::vector<float> dst(src.size());
+    for (auto _ : state)
+    {
+        simdlib::softmax_rows(src, dst, cols);
+        benchmark::DoNotOptimize(dst.data());
+    }
+    set_bytes(state, cols);
+}
+BENCHMARK(BM_SoftmaxRows)->Arg(128)->Arg(1024)->Arg(16384);
+
+static void BM_SoftmaxSeparatePasses(benchmark::State &state)
+{
+    const auto cols = static_cast<size_t>(state.range(0));
+    const std::vector<float> src = batch(cols);
+    std::vector<float> dst(src.size());
+    for (auto _ : state)
+    {
+        for (size_t r = 0; r < batch_rows; ++r)
+        {
+            const float *x = src.data() + r * cols;
+            float *y = dst.data() + r * cols;
+            const float m = *std::max_element(x, x + cols);
+            for (size_t i = 0; i < cols; ++i)
+                y[i] = std::exp(x[i] - m);
+            float s = 0.0f;
+            for (size_t i = 0; i < cols; ++i)
+                s += y[i];
+            for (size_t i = 0; i < cols; ++i)
+                y[i] /= s;
+        }
+        benchmark::DoNotOptimize(dst.data());
+    }
+    set_bytes(state, cols);
+}
+BENCHMARK(BM_SoftmaxSeparatePasses)->Arg(128)->Arg(1024)->Arg(16384);
+
+static void BM_LogSumExpRows(benchmark::State &state)
+{
+    const auto cols = static_cast<size_t>(state.range(0));
+    const std::vector<float> src = batch(cols);
+    std::vector<float> dst(batch_rows);
+    for (auto _ : state)
+    {
+        simdlib::log_sum_exp_rows(src, cols, dst);
+        benchmark::DoNotOptimize(dst.data());
+    }
+    set_bytes(state, cols);
+}
+BENCHMARK(BM_LogSumExpRows)->Arg(128)->Arg(1024)->Arg(16384);
+
+static void BM_LayerNormRows(benchmark::State &state)
+{
+    const auto cols = static_cast<size_t>(state.range(0));
+    const std::vector<float> src = batch(cols);
+    const std::vector<float> gamma(cols, 1.5f);
+    const std::vector<float> beta(cols, 0.25f);
+    std::vector<float> dst(src.size());
+    for (auto _ : state)
+    {
+        simdlib::layer_norm_rows(src, dst, cols, gamma, beta);
+        benchmark::DoNotOptimize(dst.data());
+    }
+    set_bytes(state, cols);
+}
+BENCHMARK(BM_LayerNormRows)->Arg(128)->Arg(1024)->Arg(16384);
+
+static void BM_LayerNormSeparatePasses(benchmark::State &state)
+{
+    const auto cols = static_cast<size_t>(state.range(0));
+    const std::vector<float> src = batch(cols);
+    const std::vector<float> gamma(cols, 1.5f);
+    const std::vector<float> beta(cols, 0.25f);
+    std::vector<float> dst(src.size());
+    for (auto _ : state)
+    {
+        for (size_t r = 0; r < batch_rows; ++r)
+        {
+            const float *x = src.data() + r * cols;
+            float *y = dst.data() + r * cols;
+            float mean = 0.0f;
+            for (size_t i = 0; i < cols; ++i)
+                mean += x[i];
+            mean /= static_cast<float>(cols);
+            float var = 0.0f;
+            for (size_t i = 0; i < cols; ++i)
+                var += (x[i] - mean) * (x[i] - mean);
+            const float rstd = 1.0f / std::sqrt(var / static_cast<float>(cols) + 1e-5f);
+            for (size_t i = 0; i < cols; ++i)
+                y[i] = (x[i] - mean) * rstd * gamma[i] + beta[i];
+        }
+        benchmark::DoNotOptimize(dst.data());
+    }
+    set_bytes(state, cols);
+}
+BENCHMARK(BM_LayerNormSeparatePasses)->Arg(128)->Arg(1024)->Arg(16384);
@@ -0,0 +1,87 @@
+#include <benchmark/benchmark.h>
+#include "../include/simdlib/simd_parse.hpp"
+#include <charconv>
+#include <cstdio>
+#include <map>
+#include <random>
+#include <string>
+#include <vector>
+
+// parse_floats against a scalar tokenizer feeding std::from_chars, on CSV text of 64 MiB and
+// 2 GiB; the large input repeats a 16 MiB block so generating it stays cheap
+
+namespace
+{
+
+const std::string &csv_text(size_t mib)
+{
+    static std::map<size_t, std::string> cache;
+    auto it = cache.find(mib);
+    if (it != cache.end())
+        return it->second;
+
+    std::mt19937 rng(42);
+    std::uniform_real_distribution<float> dist(-1000.0f, 1000.0f);
+    std::string block;
+    char buf[32];
+    for (size_t i = 0; block.size() < (size_t{16} << 20); ++i)
+    {
+        const char *format = i % 4 == 0 ? "%.6e" : "%.4f";
+        std::snprintf(buf, sizeof(buf), format, static_cast<double>(dist(rng)));
+        block += buf;
+        block += i % 8 == 7 ? '\n' : ',';
+    }
+    std::string text;
+    text.reserve(mib << 20);
+    while (text.size() + block.size() <= (mib << 20))
+        text += block;
+    return cache.emplace(mib, std::move(text)).first->second;
+}
+
+std::vector<float> parse_from_chars(std::string_view text)
+{
+    std::vector<float> values;
+    values.reserve(text.size() / 8);
+    const char *p = text.data();
+    const char *end = p + text.size();
+    while (p < end)
+    {
+        while (p < end && (*p == ',' || *p == '\n' || *p == ' ' || *p == '\r' || *p == '\t'))
+            ++p;
+        if (p == end)
+            break;
+        float value = 0.0f;
+        const auto result = std::from_chars(p, end, value);
+        values.push_back(value);
+        p = result.ptr;
+    }
+    return values;
+}
+
+} // namespace
+
+static void BM_ParseFloats(benchmark::State &state)
+{
+    const std::string &text = csv_text(static_cast<size_t>(state.range(0)));
+    for (auto _ : state)
+    {
+        const simdlib::aligned_vector<float> values = simdlib::parse_floats(text);
+        benchmark::DoNotOptimize(values.data());
+    }
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations()) *
+                            static_cast<int64_t>(text.size()));
+}
+BENCHMARK(BM_ParseFloats)->Arg(64)->Arg(2048)->Unit(benchmark::kMillisecond);
+
+static void BM_FromChars(benchmark::State &state)
+{
+    const std::string &text = csv_text(static_cast<size_t>(state.range(0)));
+    for (auto _ : state)
+    {
+        const std::vector<float> values = parse_from_chars(text);
+        benchmark::DoNotOptimize(values.data());
+    }
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations()) *
+                            static_cast<int64_t>(text.size()));
+}
+BENCHMARK(BM_FromChars)->Arg(64)->Arg(2048)->Unit(benchmark::kMillisecond);
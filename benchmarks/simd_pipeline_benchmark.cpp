@@ -0,0 +1,114 @@
+#include <benchmark/benchmark.h>
+#include "../include/simdlib/simd_half.hpp"
+#include "../include/simdlib/simd_pipeline.hpp"
+#include <algorithm>
+#include <random>
+#include <vector>
+
+// read -> decode -> compute -> write over a 16M-value half-precision column: each stage's full
+// output materialized before the next runs, as the streaming jobs did before, against the
+// chunked pipeline at several chunk sizes
+
+namespace
+{
+
+constexpr size_t value_count = size_t{1} << 24;
+
+std::vector<uint16_t> column()
+{
+    std::mt19937 rng(8);
+    std::uniform_real_distribution<float> dist(-4.0f, 4.0f);
+    std::vector<uint16_t> halves(value_count);
+    for (auto &h : halves)
+        h = simdlib::float_to_f16(dist(rng));
+    return halves;
+}
+
+// the compute stage, a clamped affine map
+simdlib::simd_vector<float, simdlib::AVX_SIZE> compute(
+    const simdlib::simd_vector<float, simdlib::AVX_SIZE> &x)
+{
+    const simdlib::simd_vector<float, simdlib::AVX_SIZE> scale(0.25f);
+    const simdlib::simd_vector<float, simdlib::AVX_SIZE> shift(0.5f);
+    const __m256 y = x.fmadd(scale, shift).data;
+    return simdlib::simd_vector<float, simdlib::AVX_SIZE>(
+        _mm256_min_ps(_mm256_max_ps(y, _mm256_setzero_ps()), _mm256_set1_ps(1.0f)));
+}
+
+void set_bytes(benchmark::State &state)
+{
+    // halves read and halves written
+    state.SetBytesProcessed(
+        static_cast<int64_t>(state.iterations() * value_count * 2 * sizeof(uint16_t)));
+}
+
+} // namespace
+
+static void BM_StagesMaterialized(benchmark::State &state)
+{
+    const auto input = column();
+    std::vector<uint16_t> output(value_count);
+    // each stage's output lives in full between the stages; the buffers are reused across
+    // iterations so only the cache misses are measured, not the page faults
+    std::vector<uint16_t> read(value_count);
+    std::vector<float> decoded(value_count);
+    for (auto _ : state)
+    {
+        std::copy(input.begin(), input.end(), read.begin());
+        simdlib::f16_to_float(read, decoded);
+        simdlib::transform_values(decoded, decoded, compute);
+        simdlib::float_to_f16(decoded, output);
+        benchmark::DoNotOptimize(output.data());
+    }
+    set_bytes(state);
+    state.counters["peak_MiB"] = static_cast<double>(value_count * (2 + 4)) / (1 << 20);
+}
+BENCHMARK(BM_StagesMaterialized)->UseRealTime()->Unit(benchmark::kMillisecond);
+
+static void BM_StagesPipelined(benchmark::State &state)
+{
+    const auto input = column();
+    std::vector<uint16_t> output(value_count);
+    simdlib::pipeline_options options;
+    options.chunk_bytes = static_cast<size_t>(state.range(0));
+    const size_t per_chunk = options.chunk_bytes / sizeof(float);
+    for (auto _ : state)
+    {
+        simdlib::run_pipeline(
+            options,
+            [&](simdlib::pipeline_chunk &chunk)
+            {
+                const size_t begin = chunk.index() * per_chunk;
+                if (begin >= value_count)
+                    return false;
+                const size_t n = std::min(per_chunk, value_count - begin);
+                std::copy_n(input.begin() + static_cast<std::ptrdiff_t>(begin), n,
+                            chunk.resize<uint16_t>(n).begin());
+                return true;
+            },
+            [](simdlib::pipeline_chunk &chunk)
+            {
+                const auto halves = chunk.values<uint16_t>();
+                simdlib::f16_to_float(halves, chunk.spare<float>(halves.size()));
+                chunk.commit<float>(halves.size());
+            },
+            simdlib::pipeline_transform(compute),
+            [&](simdlib::pipeline_chunk &chunk)
+            {
+                const auto values = chunk.values<float>();
+                simdlib::float_to_f16(
+                    values, std::span<uint16_t>(output).subspan(chunk.index() * per_chunk,
+                                                                values.size()));
+            });
+        benchmark::DoNotOptimize(output.data());
+    }
+    set_bytes(state);
+    // eight chunks in flight, each with its spare
+    state.counters["peak_MiB"] = static_cast<double>(8 * 2 * options.chunk_bytes) / (1 << 20);
+}
+BENCHMARK(BM_StagesPipelined)
+    ->Arg(size_t{1} << 14)
+    ->Arg(size_t{1} << 16)
+    ->Arg(size_t{1} << 18)
+    ->UseRealTime()
+    ->Unit(benchmark::kMillisecond);
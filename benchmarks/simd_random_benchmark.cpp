@@ -0,0 +1,100 @@
+#include <benchmark/benchmark.h>
+#include "../include/simdlib/simd_random.hpp"
+#include <random>
+#include <vector>
+
+// filling a float array with uniform and normal variates: std::mt19937 with the standard
+// distributions against the eight-lane xoshiro128+ and Philox generators
+
+namespace
+{
+
+constexpr size_t fill_count = size_t{1} << 20;
+
+void set_items(benchmark::State &state)
+{
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations()) *
+                            static_cast<int64_t>(fill_count));
+}
+
+} // namespace
+
+static void BM_Mt19937Uniform(benchmark::State &state)
+{
+    std::vector<float> out(fill_count);
+    std::mt19937 rng(1);
+    std::uniform_real_distribution<float> dist(0.0f, 1.0f);
+    for (auto _ : state)
+    {
+        for (float &v : out)
+            v = dist(rng);
+        benchmark::DoNotOptimize(out.data());
+    }
+    set_items(state);
+}
+BENCHMARK(BM_Mt19937Uniform);
+
+static void BM_XoshiroUniform(benchmark::State &state)
+{
+    std::vector<float> out(fill_count);
+    simdlib::xoshiro128p_x8 gen(1);
+    for (auto _ : state)
+    {
+        gen.fill_uniform(out);
+        benchmark::DoNotOptimize(out.data());
+    }
+    set_items(state);
+}
+BENCHMARK(BM_XoshiroUniform);
+
+static void BM_PhiloxUniform(benchmark::State &state)
+{
+    std::vector<float> out(fill_count);
+    for (auto _ : state)
+    {
+        simdlib::fill_uniform(out, 1);
+        benchmark::DoNotOptimize(out.data());
+    }
+    set_items(state);
+}
+BENCHMARK(BM_PhiloxUniform);
+
+static void BM_Mt19937Normal(benchmark::State &state)
+{
+    std::vector<float> out(fill_count);
+    std::mt19937 rng(1);
+    std::normal_distribution<float> dist(0.0f, 1.0f);
+    for (auto _ : state)
+    {
+        for (float &v : out)
+            v = dist(rng);
+        benchmark::DoNotOptimize(out.data());
+    }
+    set_items(state);
+}
+BENCHMARK(BM_Mt19937Normal);
+
+static void BM_XoshiroNormal(benchmark::State &state)
+{
+    std::vector<float> out(fill_count);
+    simdlib::xoshiro128p_x8 gen(1);
+    for (auto _ : state)
+    {
+        gen.fill_normal(out);
+        benchmark::DoNotOptimize(out.data());
+    }
+    set_items(state);
+}
+BENCHMARK(BM_XoshiroNormal);
+
+static void BM_PhiloxNormal(benchmark::State &state)
+{
+    std::vector<float> out(fill_count);
+    for (auto _ : state)
+    {
+        simdlib::fill_normal(out, 1);
+        benchmark::DoNotOptimize(out.data());
+    }
+    set_items(state);
+}
+BENCHMARK(BM_PhiloxNormal);
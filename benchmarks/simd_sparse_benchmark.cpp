@@ -0,0 +1,120 @@
+#include <benchmark/benchmark.h>
+#include "../include/simdlib/simd_sparse.hpp"
+#include <algorithm>
+#include <cmath>
+#include <random>
+#include <vector>
+
+// SpMV on a power-law matrix shaped like a web graph: Pareto row lengths (mean about 16) and
+// column indices skewed towards a few popular nodes. Scalar CSR against the gathered CSR
+// kernel and SELL-8-sigma.
+
+namespace
+{
+
+constexpr size_t graph_nodes = size_t{1} << 21;
+
+const simdlib::csr_matrix &power_law_matrix()
+{
+    static const simdlib::csr_matrix matrix = []
+    {
+        std::mt19937 rng(11);
+        std::uniform_real_distribution<double> unit(1e-9, 1.0);
+        simdlib::csr_matrix a;
+        a.rows = graph_nodes;
+        a.cols = graph_nodes;
+        a.row_ptr.reserve(graph_nodes + 1);
+        for (size_t r = 0; r < graph_nodes; ++r)
+        {
+            // Pareto with shape 1.5 and scale 5.5, capped at 64k entries
+            const auto length = static_cast<size_t>(
+                std::min(65536.0, 5.5 / std::pow(unit(rng), 1.0 / 1.5)));
+            for (size_t j = 0; j < length; ++j)
+            {
+                const double u = unit(rng);
+                a.col_idx.push_back(static_cast<uint32_t>(static_cast<double>(graph_nodes - 1) *
+                                                          u * u * u));
+                a.values.push_back(static_cast<float>(u));
+            }
+            a.row_ptr.push_back(a.values.size());
+        }
+        return a;
+    }();
+    return matrix;
+}
+
+const std::vector<float> &input_vector()
+{
+    static const std::vector<float> x(graph_nodes, 1.0f / static_cast<float>(graph_nodes));
+    return x;
+}
+
+void set_counters(benchmark::State &state, size_t stored)
+{
+    state.counters["nnz"] = static_cast<double>(power_law_matrix().nonzeros());
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations()) *
+                            static_cast<int64_t>(power_law_matrix().nonzeros()));
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations()) *
+                            static_cast<int64_t>(stored * (sizeof(float) + sizeof(uint32_t))));
+}
+
+} // namespace
+
+static void BM_SpmvCsrScalar(benchmark::State &state)
+{
+    const simdlib::csr_matrix &a = power_law_matrix();
+    const std::vector<float> &x = input_vector();
+    std::vector<float> y(a.rows);
+    for (auto _ : state)
+    {
+        for (size_t r = 0; r < a.rows; ++r)
+        {
+            float sum = 0.0f;
+            for (uint64_t j = a.row_ptr[r]; j < a.row_ptr[r + 1]; ++j)
+                sum += a.values[j] * x[a.col_idx[j]];
+            y[r] = sum;
+        }
+        benchmark::DoNotOptimize(y.data());
+    }
+    set_counters(state, a.nonzeros());
+}
+BENCHMARK(BM_SpmvCsrScalar)->Unit(benchmark::kMillisecond);
+
+static void BM_SpmvCsr(benchmark::State &state)
+{
+    const simdlib::csr_matrix &a = power_law_matrix();
+    const std::vector<float> &x = input_vector();
+    std::vector<float> y(a.rows);
+    const auto threads = static_cast<size_t>(state.range(0));
+    for (auto _ : state)
+    {
+        simdlib::spmv(a, x, y, threads);
+        benchmark::DoNotOptimize(y.data());
+    }
+    set_counters(state, a.nonzeros());
+}
+BENCHMARK(BM_SpmvCsr)->Arg(1)->Arg(0)->Unit(benchmark::kMillisecond);
+
+static void BM_SpmvSell(benchmark::State &state)
+{
+    const simdlib::sell_matrix a =
+        simdlib::to_sell(power_law_matrix(), static_cast<size_t>(state.range(0)));
+    const std::vector<float> &x = input_vector();
+    std::vector<float> y(a.rows);
+    const auto threads = static_cast<size_t>(state.range(1));
+    for (auto _ : state)
+    {
+        simdlib::spmv(a, x, y, threads);
+        benchmark::DoNotOptimize(y.data());
+    }
+    set_counters(state, a.stored());
+    state.counters["padding"] =
+        static_cast<double>(a.stored()) / static_cast<double>(power_law_matrix().nonzeros());
+}
+BENCHMARK(BM_SpmvSell)
+    ->Args({1, 1})
+    ->Args({64, 1})
+    ->Args({4096, 1})
+    ->Args({1 << 21, 1})
+    ->Args({1 << 21, 0})
+    ->Unit(benchmark::kMillisecond);
@@ -0,0 +1,291 @@
+#include <benchmark/benchmark.h>
+#include "../include/simdlib/simd_vector.hpp"
+#include "benchmark_perf.hpp"
+#include <algorithm>
+#include <random>
+#include <string>
+#include <utility>
+#include <vector>
+
+// Array kernels swept over working sets sized to each cache level and to DRAM, reporting
+// GB/s and GFLOP/s for a scalar loop, the SSE simd_vector<float, 4> and the AVX
+// simd_vector<float, 8>; hardware counters are added with -DSIMDLIB_ENABLE_PERF=ON.
+
+#if defined(__clang__)
+#define SCALAR_BASELINE
+#define SCALAR_LOOP _Pragma("clang loop vectorize(disable) interleave(disable)")
+#else
+#define SCALAR_BASELINE __attribute__((optimize("no-tree-vectorize")))
+#define SCALAR_LOOP
+#endif
+
+namespace
+{
+
+// element counts are rounded to this so every kernel runs without a tail
+constexpr size_t kernel_granularity = 64;
+
+struct regime
+{
+    std::string name;
+    size_t bytes; // working set targeted by this regime
+};
+
+// half of each data cache level, then twice the last level (at least 64 MiB, at most 1 GiB)
+const std::vector<regime> &cache_regimes()
+{
+    static const std::vector<regime> regimes = []
+    {
+        std::vector<regime> result;
+        size_t largest = 0;
+        int last_level = 0;
+        for (const auto &cache : benchmark::CPUInfo::Get().caches)
+        {
+            if (cache.type == "Instruction" || cache.level <= last_level || cache.size <= 0)
+                continue;
+            last_level = cache.level;
+            largest = static_cast<size_t>(cache.size);
+            result.push_back({"L" + std::to_string(cache.level), largest / 2});
+        }
+        if (result.empty())
+        {
+            // no cache topology reported, fall back to typical desktop sizes
+            result = {{"L1", 16 << 10}, {"L2", 512 << 10}, {"L3", 8 << 20}};
+            largest = 16 << 20;
+        }
+        result.push_back({"DRAM", std::clamp<size_t>(2 * largest, 64 << 20, 1 << 30)});
+        return result;
+    }();
+    return regimes;
+}
+
+// one argument per regime, the element count that fills it with `Streams` float arrays
+template <size_t Streams> void cache_sweep(benchmark::internal::Benchmark *bench)
+{
+    for (const auto &r : cache_regimes())
+    {
+        const size_t n = r.bytes / (Streams * sizeof(float));
+        bench->Arg(static_cast<int64_t>(
+            std::max(kernel_granularity, n / kernel_granularity * kernel_granularity)));
+    }
+}
+
+std::string regime_label(size_t bytes)
+{
+    for (const auto &r : cache_regimes())
+    {
+        if (bytes <= r.bytes)
+            return r.name;
+    }
+    return "DRAM";
+}
+
+std::vector<float> random_array(size_t n, unsigned seed)
+{
+    std::mt19937 rng(seed);
+    std::uniform_real_distribution<float> dist(-1.0f, 1.0f);
+    std::vector<float> values(n);
+    for (auto &v : values)
+        v = dist(rng);
+    return values;
+}
+
+void set_counters(benchmark::State &state, size_t streams, size_t flops_per_element)
+{
+    const auto n = static_cast<double>(state.range(0));
+    // rates print with SI prefixes, so bytes=12.3G/s reads as GB/s and flops as GFLOP/s
+    state.counters["bytes"] =
+        benchmark::Counter(n * static_cast<double>(streams * sizeof(float)),
+                           benchmark::Counter::kIsIterationInvariantRate);
+    state.counters["flops"] = benchmark::Counter(n * static_cast<double>(flops_per_element),
+                                                 benchmark::Counter::kIsIterationInvariantRate);
+    state.SetLabel(regime_label(static_cast<size_t>(state.range(0)) * streams * sizeof(float)));
+}
+
+template <size_t N> simdlib::simd_vector<float, N> load(const float *src);
+
+template <> simdlib::simd_vector<float, 4> load<4>(const float *src)
+{
+    return simdlib::simd_vector<float, 4>(_mm_loadu_ps(src));
+}
+
+template <> simdlib::simd_vector<float, 8> load<8>(const float *src)
+{
+    return simdlib::simd_vector<float, 8>(_mm256_loadu_ps(src));
+}
+
+void store(float *dst, const simdlib::simd_vector<float, 4> &vec)
+{
+    _mm_storeu_ps(dst, vec.data);
+}
+
+void store(float *dst, const simdlib::simd_vector<float, 8> &vec)
+{
+    _mm256_storeu_ps(dst, vec.data);
+}
+
+// plain loops with auto-vectorization disabled, the baseline the SIMD paths are measured against
+struct scalar_kernels
+{
+    SCALAR_BASELINE static void add(const float *a, const float *b, float *c, size_t n)
+    {
+        SCALAR_LOOP
+        for (size_t i = 0; i < n; ++i)
+            c[i] = a[i] + b[i];
+    }
+
+    SCALAR_BASELINE static void triad(const float *a, const float *b, const float *c, float *d,
+                                      size_t n)
+    {
+        SCALAR_LOOP
+        for (size_t i = 0; i < n; ++i)
+            d[i] = a[i] * b[i] + c[i];
+    }
+
+    SCALAR_BASELINE static float sum(const float *a, size_t n)
+    {
+        float total = 0.0f;
+        SCALAR_LOOP
+        for (size_t i = 0; i < n; ++i)
+            total += a[i];
+        return total;
+    }
+
+    SCALAR_BASELINE static float dot(const float *a, const float *b, size_t n)
+    {
+        float total = 0.0f;
+        SCALAR_LOOP
+        for (size_t i = 0; i < n; ++i)
+            total += a[i] * b[i];
+        return total;
+    }
+};
+
+// the same kernels on simd_vector<float, N>, reductions with four accumulators
+template <size_t N> struct simd_kernels
+{
+    using vec = simdlib::simd_vector<float, N>;
+
+    static void add(const float *a, const float *b, float *c, size_t n)
+    {
+        for (size_t i = 0; i < n; i += N)
+            store(c + i, load<N>(a + i) + load<N>(b + i));
+    }
+
+    static void triad(const float *a, const float *b, const float *c, float *d, size_t n)
+    {
+        for (size_t i = 0; i < n; i += N)
+            store(d + i, load<N>(a + i).fmadd(load<N>(b + i), load<N>(c + i)));
+    }
+
+    static float sum(const float *a, size_t n)
+    {
+        vec acc0;
+        vec acc1;
+        vec acc2;
+        vec acc3;
+        for (size_t i = 0; i < n; i += 4 * N)
+        {
+            acc0 += load<N>(a + i);
+            acc1 += load<N>(a + i + N);
+            acc2 += load<N>(a + i + 2 * N);
+            acc3 += load<N>(a + i + 3 * N);
+        }
+        return ((acc0 + acc1) + (acc2 + acc3)).horizontal_sum();
+    }
+
+    static float dot(const float *a, const float *b, size_t n)
+    {
+        vec acc0;
+        vec acc1;
+        vec acc2;
+        vec acc3;
+        for (size_t i = 0; i < n; i += 4 * N)
+        {
+            acc0 = load<N>(a + i).fmadd(load<N>(b + i), acc0);
+            acc1 = load<N>(a + i + N).fmadd(load<N>(b + i + N), acc1);
+            acc2 = load<N>(a + i + 2 * N).fmadd(load<N>(b + i + 2 * N), acc2);
+            acc3 = load<N>(a + i + 3 * N).fmadd(load<N>(b + i + 3 * N), acc3);
+        }
+        return ((acc0 + acc1) + (acc2 + acc3)).horizontal_sum();
+    }
+};
+
+using sse_kernels = simd_kernels<simdlib::SSE_SIZE>;
+using avx_kernels = simd_kernels<simdlib::AVX_SIZE>;
+
+} // namespace
+
+// c = a + b: two reads, one write, one flop per element
+template <typename Kernels> static void BM_ArrayAdd(benchmark::State &state)
+{
+    const auto n = static_cast<size_t>(state.range(0));
+    const std::vector<float> a = random_array(n, 1);
+    const std::vector<float> b = random_array(n, 2);
+    std::vector<float> c(n);
+    const perf_report perf(state);
+    for (auto _ : state)
+    {
+        Kernels::add(a.data(), b.data(), c.data(), n);
+        benchmark::DoNotOptimize(c.data());
+        benchmark::ClobberMemory();
+    }
+    set_counters(state, 3, 1);
+}
+BENCHMARK_TEMPLATE(BM_ArrayAdd, scalar_kernels)->Apply(cache_sweep<3>);
+BENCHMARK_TEMPLATE(BM_ArrayAdd, sse_kernels)->Apply(cache_sweep<3>);
+BENCHMARK_TEMPLATE(BM_ArrayAdd, avx_kernels)->Apply(cache_sweep<3>);
+
+// d = a * b + c: three reads, one write, two flops per element
+template <typename Kernels> static void BM_ArrayTriad(benchmark::State &state)
+{
+    const auto n = static_cast<size_t>(state.range(0));
+    const std::vector<float> a = random_array(n, 1);
+    const std::vector<float> b = random_array(n, 2);
+    const std::vector<float> c = random_array(n, 3);
+    std::vector<float> d(n);
+    const perf_report perf(state);
+    for (auto _ : state)
+    {
+        Kernels::triad(a.data(), b.data(), c.data(), d.data(), n);
+        benchmark::DoNotOptimize(d.data());
+        benchmark::ClobberMemory();
+    }
+    set_counters(state, 4, 2);
+}
+BENCHMARK_TEMPLATE(BM_ArrayTriad, scalar_kernels)->Apply(cache_sweep<4>);
+BENCHMARK_TEMPLATE(BM_ArrayTriad, sse_kernels)->Apply(cache_sweep<4>);
+BENCHMARK_TEMPLATE(BM_ArrayTriad, avx_kernels)->Apply(cache_sweep<4>);
+
+// sum of a: one read, one flop per element
+template <typename Kernels> static void BM_ArraySum(benchmark::State &state)
+{
+    const auto n = static_cast<size_t>(state.range(0));
+    const std::vector<float> a = random_array(n, 1);
+    const perf_report perf(state);
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(Kernels::sum(a.data(), n));
+    }
+    set_counters(state, 1, 1);
+}
+BENCHMARK_TEMPLATE(BM_ArraySum, scalar_kernels)->Apply(cache_sweep<1>);
+BENCHMARK_TEMPLATE(BM_ArraySum, sse_kernels)->Apply(cache_sweep<1>);
+BENCHMARK_TEMPLATE(BM_ArraySum, avx_kernels)->Apply(cache_sweep<1>);
+
+// dot product of a and b: two reads, two flops per element
+template <typename Kernels> static void BM_ArrayDot(benchmark::State &state)
+{
+    const auto n = static_cast<size_t>(state.range(0));
+    const std::vector<float> a = random_array(n, 1);
+    const std::vector<float> b = random_array(n, 2);
+    const perf_report perf(state);
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(Kernels::dot(a.data(), b.data(), n));
+    }
+    set_counters(state, 2, 2);
+}
+BENCHMARK_TEMPLATE(BM_ArrayDot, scalar_kernels)->Apply(cache_sweep<2>);
+BENCHMARK_TEMPLATE(BM_ArrayDot, sse_kernels)->Apply(cache_sweep<2>);
+BENCHMARK_TEMPLATE(BM_ArrayDot, avx_kernels)->Apply(cache_sweep<2>);
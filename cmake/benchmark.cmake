@@ -9,4 +9,5 @@ FetchContent_MakeAvailable(benchmark)
 # Create benchmark executable
 file(GLOB_RECURSE BenchmarkFiles CONFIGURE_DEPENDS "${CMAKE_CURRENT_SOURCE_DIR}/benchmarks/*.cpp")
 add_executable(benchmarks ${BenchmarkFiles})
+target_compile_options(benchmarks PRIVATE -mavx -mavx2 -mfma -mf16c -msse4.2)
 target_link_libraries(benchmarks PRIVATE benchmark::benchmark simdlib)
\ No newline at end of file
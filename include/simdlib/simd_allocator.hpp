@@ -0,0 +1,51 @@
+#pragma once
+
+#include "simd_traits.hpp"
+#include <cstddef>
+#include <limits>
+#include <new>
+#include <vector>
+
+namespace simdlib
+{
+
+// allocator handing out Alignment-aligned storage, so vector data can take aligned loads
+template <typename T, size_t Alignment = AVX_ALIGNMENT> struct aligned_allocator
+{
+    static_assert(is_power_of_two<Alignment>::value && Alignment >= alignof(T),
+                  "alignment must be a power of two no smaller than the type's");
+
+    using value_type = T;
+
+    template <typename U> struct rebind
+    {
+        using other = aligned_allocator<U, Alignment>;
+    };
+
+    aligned_allocator() noexcept = default;
+
+    template <typename U> aligned_allocator(const aligned_allocator<U, Alignment> &) noexcept
+    {
+    }
+
+    T *allocate(size_t n)
+    {
+        if (n > std::numeric_limits<size_t>::max() / sizeof(T))
+            throw std::bad_array_new_length();
+        return static_cast<T *>(::operator new(n * sizeof(T), std::align_val_t{Alignment}));
+    }
+
+    void deallocate(T *p, size_t) noexcept
+    {
+        ::operator delete(p, std::align_val_t{Alignment});
+    }
+
+    template <typename U> bool operator==(const aligned_allocator<U, Alignment> &) const noexcept
+    {
+        return true;
+    }
+};
+
+template <typename T> using aligned_vector = std::vector<T, aligned_allocator<T>>;
+
+} // namespace simdlib
@@ -0,0 +1,422 @@
+#pragma once
+
+#include "simd_allocator.hpp"
+#include "simd_parallel.hpp"
+#include "simd_perf.hpp"
+#include "simd_traits.hpp"
+#include <immintrin.h>
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cstdint>
+#include <span>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace simdlib
+{
+
+// values per packed block. A block is 32 rows of eight 32-bit lanes, value i in lane i % 8 of
+// row i / 8; each lane's rows are packed back to back into that lane's words, so a block of
+// b-bit values takes 8 b words and every row unpacks with shifts on whole vectors. This is the
+// SIMD-BP128 layout widened from four lanes to AVX2's eight.
+constexpr size_t bitpack_block_size = 256;
+
+// how packed_column turns a block into small non-negative residuals
+enum class bitpack_encoding
+{
+    // value - the block minimum
+    frame_of_reference,
+    // value - the value eight places earlier (one row up, same lane), the first row against
+    // its minimum; small for sorted or slowly changing columns
+    delta,
+};
+
+namespace detail
+{
+
+constexpr size_t bitpack_row_count = bitpack_block_size / AVX_SIZE;
+
+// blocks per chunk handed to a worker thread
+constexpr size_t bitpack_min_chunk = 256;
+
+inline uint32_t low_bits_mask(unsigned bits)
+{
+    return bits >= 32 ? ~uint32_t{0} : (uint32_t{1} << bits) - 1;
+}
+
+// calls f(std::integral_constant<unsigned, Bits>{}) for the runtime width bits in [0, 32], so
+// every width gets its own fully unrolled kernel
+template <typename F> inline void with_bit_width(unsigned bits, F &&f)
+{
+    [&]<unsigned... B>(std::integer_sequence<unsigned, B...>)
+    {
+        ((bits == B ? (f(std::integral_constant<unsigned, B>{}), true) : false) || ...);
+    }(std::make_integer_sequence<unsigned, 33>{});
+}
+
+#ifdef __AVX2__
+template <unsigned Bits, size_t R> inline void bitpack_row(__m256i v, __m256i &acc, uint32_t *out)
+{
+    constexpr unsigned shift = (R * Bits) % 32;
+    constexpr size_t word = R * Bits / 32;
+    if constexpr (Bits < 32)
+        v = _mm256_and_si256(v, _mm256_set1_epi32(static_cast<int>(low_bits_mask(Bits))));
+    if constexpr (shift == 0)
+        acc = v;
+    else
+        acc = _mm256_or_si256(acc, _mm256_slli_epi32(v, shift));
+    if constexpr (shift + Bits >= 32)
+    {
+        _mm256_storeu_si256(reinterpret_cast<__m256i *>(out) + word, acc);
+        // the bits that did not fit start the next word
+        if constexpr (shift + Bits > 32)
+            acc = _mm256_srli_epi32(v, 32 - shift);
+    }
+}
+
+template <unsigned Bits, size_t... R>
+inline void bitpack_rows(const uint32_t *values, uint32_t *out, std::index_sequence<R...>)
+{
+    __m256i acc = _mm256_setzero_si256();
+    (bitpack_row<Bits, R>(
+         _mm256_loadu_si256(reinterpret_cast<const __m256i *>(values + R * AVX_SIZE)), acc, out),
+     ...);
+}
+
+template <unsigned Bits> inline void bitpack_vectors(const uint32_t *values, uint32_t *out)
+{
+    if constexpr (Bits > 0)
+        bitpack_rows<Bits>(values, out, std::make_index_sequence<bitpack_row_count>{});
+}
+
+template <unsigned Bits, size_t R> inline __m256i bitunpack_row(const uint32_t *in)
+{
+    constexpr unsigned shift = (R * Bits) % 32;
+    constexpr size_t word = R * Bits / 32;
+    if constexpr (Bits == 0)
+    {
+        return _mm256_setzero_si256();
+    }
+    else
+    {
+        const auto *p = reinterpret_cast<const __m256i *>(in) + word;
+        __m256i v = _mm256_srli_epi32(_mm256_loadu_si256(p), shift);
+        if constexpr (shift + Bits > 32)
+            v = _mm256_or_si256(v, _mm256_slli_epi32(_mm256_loadu_si256(p + 1), 32 - shift));
+        if constexpr (shift + Bits != 32)
+            v = _mm256_and_si256(v, _mm256_set1_epi32(static_cast<int>(low_bits_mask(Bits))));
+        return v;
+    }
+}
+
+template <unsigned Bits, typename Sink, size_t... R>
+inline void bitunpack_rows(const uint32_t *in, Sink sink, std::index_sequence<R...>)
+{
+    (sink(R, bitunpack_row<Bits, R>(in)), ...);
+}
+
+// sink(r, row) for the 32 rows of a block, in order; sinks are taken by value, so state they
+// carry from row to row stays in registers rather than behind a pointer the stores may alias
+template <unsigned Bits, typename Sink> inline void bitunpack_vectors(const uint32_t *in, Sink sink)
+{
+    bitunpack_rows<Bits>(in, sink, std::make_index_sequence<bitpack_row_count>{});
+}
+
+inline void store_row(int32_t *dst, __m256i v)
+{
+    _mm256_storeu_si256(reinterpret_cast<__m256i *>(dst), v);
+}
+
+inline void store_row(float *dst, __m256i v)
+{
+    _mm256_storeu_ps(dst, _mm256_cvtepi32_ps(v));
+}
+#endif
+
+// value i of a packed block, for targets without AVX2
+inline uint32_t bitunpack_value(const uint32_t *in, unsigned bits, size_t i)
+{
+    if (bits == 0)
+        return 0;
+    const size_t lane = i % AVX_SIZE;
+    const size_t bit = (i / AVX_SIZE) * bits;
+    const size_t word = bit / 32;
+    const auto shift = static_cast<unsigned>(bit % 32);
+    uint64_t v = in[word * AVX_SIZE + lane] >> shift;
+    if (shift + bits > 32)
+        v |= uint64_t{in[(word + 1) * AVX_SIZE + lane]} << (32 - shift);
+    return static_cast<uint32_t>(v) & low_bits_mask(bits);
+}
+
+inline void bitpack_words(const uint32_t *values, unsigned bits, uint32_t *out)
+{
+#ifdef __AVX2__
+    with_bit_width(bits,
+                   [&](auto width) { bitpack_vectors<decltype(width)::value>(values, out); });
+#else
+    const uint32_t mask = low_bits_mask(bits);
+    std::fill(out, out + bits * AVX_SIZE, 0u);
+    for (size_t i = 0; i < bitpack_block_size && bits > 0; ++i)
+    {
+        const uint64_t v = values[i] & mask;
+        const size_t lane = i % AVX_SIZE;
+        const size_t bit = (i / AVX_SIZE) * bits;
+        const size_t word = bit / 32;
+        const auto shift = static_cast<unsigned>(bit % 32);
+        out[word * AVX_SIZE + lane] |= static_cast<uint32_t>(v << shift);
+        if (shift + bits > 32)
+            out[(word + 1) * AVX_SIZE + lane] |= static_cast<uint32_t>(v >> (32 - shift));
+    }
+#endif
+}
+
+inline void bitunpack_words(const uint32_t *in, unsigned bits, uint32_t *values)
+{
+#ifdef __AVX2__
+    auto *dst = reinterpret_cast<int32_t *>(values);
+    with_bit_width(bits,
+                   [&](auto width)
+                   {
+                       bitunpack_vectors<decltype(width)::value>(
+                           in, [dst](size_t r, __m256i v) { store_row(dst + r * AVX_SIZE, v); });
+                   });
+#else
+    for (size_t i = 0; i < bitpack_block_size; ++i)
+        values[i] = bitunpack_value(in, bits, i);
+#endif
+}
+
+} // namespace detail
+
+// packs bitpack_block_size values into bits * 8 words in the block layout; only the low bits
+// of each value are kept
+inline void bitpack_block(std::span<const uint32_t> values, unsigned bits,
+                          std::span<uint32_t> words)
+{
+    if (values.size() != bitpack_block_size || bits > 32 || words.size() != bits * AVX_SIZE)
+        throw std::invalid_argument("bitpack_block: need 256 values, bits <= 32, 8 bits words");
+    detail::bitpack_words(values.data(), bits, words.data());
+}
+
+// the inverse of bitpack_block
+inline void bitunpack_block(std::span<const uint32_t> words, unsigned bits,
+                            std::span<uint32_t> values)
+{
+    if (values.size() != bitpack_block_size || bits > 32 || words.size() != bits * AVX_SIZE)
+        throw std::invalid_argument("bitunpack_block: need 256 values, bits <= 32, 8 bits words");
+    detail::bitunpack_words(words.data(), bits, values.data());
+}
+
+// an int32 column compressed block by block: each block of bitpack_block_size values keeps a
+// reference value and packs its residuals at the narrowest width that holds them all. The last
+// block is padded by repeating the final value. Decoding writes every block straight into the
+// caller's int32 or float array; blocks are independent, so both directions split across
+// threads.
+class packed_column
+{
+  public:
+    packed_column() = default;
+
+    explicit packed_column(std::span<const int32_t> values,
+                           bitpack_encoding encoding = bitpack_encoding::frame_of_reference,
+                           size_t threads = 1)
+        : size_(values.size()), encoding_(encoding)
+    {
+        SIMDLIB_PERF_SCOPE("packed_column_encode", values.size_bytes());
+        const size_t count = blocks();
+        references_.resize(count);
+        offsets_.resize(count + 1);
+        std::vector<uint8_t> widths(count);
+        aligned_vector<uint32_t> residuals(count * bitpack_block_size);
+        const size_t chunks = chunk_count(threads, count, detail::bitpack_min_chunk);
+        parallel_for(count, chunks,
+                     [&](size_t begin, size_t end, size_t)
+                     {
+                         for (size_t b = begin; b < end; ++b)
+                             widths[b] = residualize(values, b, residuals.data() +
+                                                                    b * bitpack_block_size);
+                     });
+        for (size_t b = 0; b < count; ++b)
+            offsets_[b + 1] = offsets_[b] + widths[b] * AVX_SIZE;
+        words_.resize(offsets_[count]);
+        parallel_for(count, chunks,
+                     [&](size_t begin, size_t end, size_t)
+                     {
+                         for (size_t b = begin; b < end; ++b)
+                             detail::bitpack_words(residuals.data() + b * bitpack_block_size,
+                                                   widths[b], words_.data() + offsets_[b]);
+                     });
+    }
+
+    [[nodiscard]] size_t size() const
+    {
+        return size_;
+    }
+
+    [[nodiscard]] bitpack_encoding encoding() const
+    {
+        return encoding_;
+    }
+
+    [[nodiscard]] size_t blocks() const
+    {
+        return (size_ + bitpack_block_size - 1) / bitpack_block_size;
+    }
+
+    // bits per residual in one block
+    [[nodiscard]] unsigned block_bits(size_t block) const
+    {
+        return static_cast<unsigned>((offsets_.at(block + 1) - offsets_[block]) / AVX_SIZE);
+    }
+
+    // packed words plus one reference per block
+    [[nodiscard]] size_t packed_bytes() const
+    {
+        return words_.size() * sizeof(uint32_t) + references_.size() * sizeof(int32_t);
+    }
+
+    void decode(std::span<int32_t> out, size_t threads = 1) const
+    {
+        decode_all(out, threads, "packed_column_decode");
+    }
+
+    // values converted to float as they are written
+    void decode(std::span<float> out, size_t threads = 1) const
+    {
+        decode_all(out, threads, "packed_column_decode_float");
+    }
+
+    // the values of one block, bitpack_block_size of them except in a short last block
+    void decode_block(size_t block, std::span<int32_t> out) const
+    {
+        check_block(block, out.size());
+        decode_block_to(block, out.data());
+    }
+
+    void decode_block(size_t block, std::span<float> out) const
+    {
+        check_block(block, out.size());
+        decode_block_to(block, out.data());
+    }
+
+  private:
+    // residuals of block b into out and their width; the block is padded to full length first
+    // so every kernel sees 256 values
+    unsigned residualize(std::span<const int32_t> values, size_t b, uint32_t *out)
+    {
+        std::array<int32_t, bitpack_block_size> block;
+        const size_t first = b * bitpack_block_size;
+        const size_t n = std::min(bitpack_block_size, size_ - first);
+        std::copy(values.begin() + static_cast<std::ptrdiff_t>(first),
+                  values.begin() + static_cast<std::ptrdiff_t>(first + n), block.begin());
+        std::fill(block.begin() + static_cast<std::ptrdiff_t>(n), block.end(), block[n - 1]);
+
+        const auto first_row = block.begin() + static_cast<std::ptrdiff_t>(AVX_SIZE);
+        const int32_t reference = encoding_ == bitpack_encoding::delta
+                                      ? *std::min_element(block.begin(), first_row)
+                                      : *std::min_element(block.begin(), block.end());
+        references_[b] = reference;
+        // residuals wrap modulo 2^32, which the decoder's additions undo
+        uint32_t used = 0;
+        for (size_t i = 0; i < bitpack_block_size; ++i)
+        {
+            const int32_t base =
+                encoding_ == bitpack_encoding::delta && i >= AVX_SIZE ? block[i - AVX_SIZE]
+                                                                       : reference;
+            out[i] = static_cast<uint32_t>(block[i]) - static_cast<uint32_t>(base);
+            used |= out[i];
+        }
+        return static_cast<unsigned>(std::bit_width(used));
+    }
+
+    void check_block(size_t block, size_t out) const
+    {
+        if (block >= blocks())
+            throw std::invalid_argument("packed_column: block index out of range");
+        if (out != std::min(bitpack_block_size, size_ - block * bitpack_block_size))
+            throw std::invalid_argument("packed_column: output size does not match the block");
+    }
+
+    template <typename T>
+    void decode_all(std::span<T> out, size_t threads, const char *kernel) const
+    {
+        if (out.size() != size_)
+            throw std::invalid_argument("packed_column: output size does not match the column");
+        SIMDLIB_PERF_SCOPE(kernel, packed_bytes() + out.size_bytes());
+        const size_t count = blocks();
+        parallel_for(count, chunk_count(threads, count, detail::bitpack_min_chunk),
+                     [&](size_t begin, size_t end, size_t)
+                     {
+                         for (size_t b = begin; b < end; ++b)
+                             decode_block_to(b, out.data() + b * bitpack_block_size);
+                     });
+    }
+
+    template <typename T> void decode_block_to(size_t b, T *out) const
+    {
+        const size_t n = std::min(bitpack_block_size, size_ - b * bitpack_block_size);
+        if (n == bitpack_block_size)
+        {
+            decode_full_block(b, out);
+            return;
+        }
+        alignas(AVX_ALIGNMENT) std::array<T, bitpack_block_size> tail;
+        decode_full_block(b, tail.data());
+        std::copy(tail.begin(), tail.begin() + static_cast<std::ptrdiff_t>(n), out);
+    }
+
+    template <typename T> void decode_full_block(size_t b, T *out) const
+    {
+        const uint32_t *in = words_.data() + offsets_[b];
+        const unsigned bits = block_bits(b);
+#ifdef __AVX2__
+        const __m256i reference = _mm256_set1_epi32(references_[b]);
+        detail::with_bit_width(
+            bits,
+            [&](auto width)
+            {
+                constexpr unsigned Bits = decltype(width)::value;
+                if (encoding_ == bitpack_encoding::frame_of_reference)
+                {
+                    detail::bitunpack_vectors<Bits>(
+                        in, [out, reference](size_t r, __m256i v)
+                        { detail::store_row(out + r * AVX_SIZE, _mm256_add_epi32(v, reference)); });
+                }
+                else
+                {
+                    // each row adds onto the one above it, lane by lane
+                    detail::bitunpack_vectors<Bits>(
+                        in,
+                        [out, running = reference](size_t r, __m256i v) mutable
+                        {
+                            running = _mm256_add_epi32(running, v);
+                            detail::store_row(out + r * AVX_SIZE, running);
+                        });
+                }
+            });
+#else
+        const auto reference = static_cast<uint32_t>(references_[b]);
+        std::array<uint32_t, bitpack_block_size> values;
+        for (size_t i = 0; i < bitpack_block_size; ++i)
+        {
+            const uint32_t base = encoding_ == bitpack_encoding::delta && i >= AVX_SIZE
+                                      ? values[i - AVX_SIZE]
+                                      : reference;
+            values[i] = base + detail::bitunpack_value(in, bits, i);
+            out[i] = static_cast<T>(static_cast<int32_t>(values[i]));
+        }
+#endif
+    }
+
+    aligned_vector<uint32_t> words_;
+    // first word of every block, and one past the last
+    std::vector<size_t> offsets_{0};
+    std::vector<int32_t> references_;
+    size_t size_ = 0;
+    bitpack_encoding encoding_ = bitpack_encoding::frame_of_reference;
+};
+
+} // namespace simdlib
@@ -0,0 +1,397 @@
+#pragma once
+
+#include "simd_parallel.hpp"
+#include "simd_perf.hpp"
+#include "simd_traits.hpp"
+#include <immintrin.h>
+#include <algorithm>
+#include <bit>
+#include <cstdint>
+#include <limits>
+#include <numeric>
+#include <span>
+#include <stdexcept>
+#include <vector>
+
+namespace simdlib
+{
+
+// bitmaps are spans of 64-bit words, bit i of the map is bit i % 64 of word i / 64
+
+namespace detail
+{
+
+// words a worker thread must have before a bitmap kernel is split
+constexpr size_t bitmap_min_chunk = size_t{1} << 16;
+
+constexpr size_t bitmap_vector_words = 4;
+
+#ifdef __AVX2__
+// per-byte popcount through a nibble lookup table, summed into the four 64-bit lanes
+inline __m256i popcount_epi64(__m256i v)
+{
+    const __m256i lookup = _mm256_setr_epi8(0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4, 0, 1,
+                                            1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4);
+    const __m256i low_nibbles = _mm256_set1_epi8(0x0f);
+    const __m256i lo = _mm256_and_si256(v, low_nibbles);
+    const __m256i hi = _mm256_and_si256(_mm256_srli_epi16(v, 4), low_nibbles);
+    const __m256i bytes =
+        _mm256_add_epi8(_mm256_shuffle_epi8(lookup, lo), _mm256_shuffle_epi8(lookup, hi));
+    return _mm256_sad_epu8(bytes, _mm256_setzero_si256());
+}
+
+// carry-save adder: high receives the carries and low the sum bits of a + b + c
+inline void carry_save(__m256i &high, __m256i &low, __m256i a, __m256i b, __m256i c)
+{
+    const __m256i u = _mm256_xor_si256(a, b);
+    high = _mm256_or_si256(_mm256_and_si256(a, b), _mm256_and_si256(u, c));
+    low = _mm256_xor_si256(u, c);
+}
+
+// Harley-Seal population count of the vectors next(0) .. next(count - 1): sixteen vectors at a
+// time go through a tree of carry-save adders, so only one vector in sixteen needs the lookup
+// popcount
+template <typename Next> inline uint64_t harley_seal(size_t count, Next next)
+{
+    __m256i total = _mm256_setzero_si256();
+    __m256i ones = _mm256_setzero_si256();
+    __m256i twos = _mm256_setzero_si256();
+    __m256i fours = _mm256_setzero_si256();
+    __m256i eights = _mm256_setzero_si256();
+    __m256i sixteens;
+    __m256i twos_a;
+    __m256i twos_b;
+    __m256i fours_a;
+    __m256i fours_b;
+    __m256i eights_a;
+    __m256i eights_b;
+    size_t i = 0;
+    for (; i + 16 <= count; i += 16)
+    {
+        carry_save(twos_a, ones, ones, next(i), next(i + 1));
+        carry_save(twos_b, ones, ones, next(i + 2), next(i + 3));
+        carry_save(fours_a, twos, twos, twos_a, twos_b);
+        carry_save(twos_a, ones, ones, next(i + 4), next(i + 5));
+        carry_save(twos_b, ones, ones, next(i + 6), next(i + 7));
+        carry_save(fours_b, twos, twos, twos_a, twos_b);
+        carry_save(eights_a, fours, fours, fours_a, fours_b);
+        carry_save(twos_a, ones, ones, next(i + 8), next(i + 9));
+        carry_save(twos_b, ones, ones, next(i + 10), next(i + 11));
+        carry_save(fours_a, twos, twos, twos_a, twos_b);
+        carry_save(twos_a, ones, ones, next(i + 12), next(i + 13));
+        carry_save(twos_b, ones, ones, next(i + 14), next(i + 15));
+        carry_save(fours_b, twos, twos, twos_a, twos_b);
+        carry_save(eights_b, fours, fours, fours_a, fours_b);
+        carry_save(sixteens, eights, eights, eights_a, eights_b);
+        total = _mm256_add_epi64(total, popcount_epi64(sixteens));
+    }
+    total = _mm256_slli_epi64(total, 4);
+    total = _mm256_add_epi64(total, _mm256_slli_epi64(popcount_epi64(eights), 3));
+    total = _mm256_add_epi64(total, _mm256_slli_epi64(popcount_epi64(fours), 2));
+    total = _mm256_add_epi64(total, _mm256_slli_epi64(popcount_epi64(twos), 1));
+    total = _mm256_add_epi64(total, popcount_epi64(ones));
+    for (; i < count; ++i)
+        total = _mm256_add_epi64(total, popcount_epi64(next(i)));
+
+    alignas(AVX_ALIGNMENT) uint64_t lanes[4];
+    _mm256_store_si256(reinterpret_cast<__m256i *>(lanes), total);
+    return lanes[0] + lanes[1] + lanes[2] + lanes[3];
+}
+#endif
+
+inline void check_bitmaps(size_t a, size_t b, const char *what)
+{
+    if (a != b)
+        throw std::invalid_argument(what);
+}
+
+// out[i] = op(a[i], b[i]) over the words [begin, end), returning the set bits of the result;
+// Op provides the word operation and, under AVX2, the vector one. Without an output the
+// result is only counted.
+template <typename Op>
+inline uint64_t bitmap_combine_range(const uint64_t *a, const uint64_t *b, uint64_t *out,
+                                     size_t begin, size_t end, Op op)
+{
+    uint64_t count = 0;
+    size_t w = begin;
+    const auto scalar = [&](size_t last)
+    {
+        for (; w < last; ++w)
+        {
+            const uint64_t r = op(a[w], b[w]);
+            if (out != nullptr)
+                out[w] = r;
+            count += static_cast<uint64_t>(std::popcount(r));
+        }
+    };
+#ifdef __AVX2__
+    // a few scalar words first so the stores (or the loads of a when only counting) are
+    // aligned; a 32-byte access split across cache lines costs more than the popcount
+    const auto *anchor = out != nullptr ? static_cast<const void *>(out) : a;
+    const size_t misaligned = reinterpret_cast<uintptr_t>(anchor) / sizeof(uint64_t) + begin;
+    scalar(std::min(end, begin + (bitmap_vector_words - misaligned % bitmap_vector_words) %
+                                     bitmap_vector_words));
+    begin = w;
+    const size_t vectors = (end - begin) / bitmap_vector_words;
+    const auto load = [](const uint64_t *p)
+    { return _mm256_loadu_si256(reinterpret_cast<const __m256i *>(p)); };
+    if (out != nullptr)
+        count += harley_seal(vectors,
+                             [&](size_t v)
+                             {
+                                 const size_t at = begin + v * bitmap_vector_words;
+                                 const __m256i r = op(load(a + at), load(b + at));
+                                 _mm256_store_si256(reinterpret_cast<__m256i *>(out + at), r);
+                                 return r;
+                             });
+    else
+        count += harley_seal(vectors,
+                             [&](size_t v)
+                             {
+                                 const size_t at = begin + v * bitmap_vector_words;
+                                 return op(load(a + at), load(b + at));
+                             });
+    w += vectors * bitmap_vector_words;
+#endif
+    scalar(end);
+    return count;
+}
+
+// splits the words across threads and sums the per-thread counts
+template <typename Op>
+inline uint64_t bitmap_combine(std::span<const uint64_t> a, std::span<const uint64_t> b,
+                               uint64_t *out, size_t threads, Op op)
+{
+    const size_t words = a.size();
+    const size_t chunks = chunk_count(threads, words, bitmap_min_chunk);
+    std::vector<uint64_t> counts(chunks);
+    parallel_for(words, chunks,
+                 [&](size_t begin, size_t end, size_t chunk)
+                 {
+                     counts[chunk] =
+                         bitmap_combine_range(a.data(), b.data(), out, begin, end, op);
+                 });
+    return std::accumulate(counts.begin(), counts.end(), uint64_t{0});
+}
+
+// the first operand alone, so a plain popcount runs through the same kernel with b = a and
+// the second load folded away
+struct bitmap_first_op
+{
+    uint64_t operator()(uint64_t a, uint64_t) const
+    {
+        return a;
+    }
+#ifdef __AVX2__
+    __m256i operator()(__m256i a, __m256i) const
+    {
+        return a;
+    }
+#endif
+};
+
+struct bitmap_and_op
+{
+    uint64_t operator()(uint64_t a, uint64_t b) const
+    {
+        return a & b;
+    }
+#ifdef __AVX2__
+    __m256i operator()(__m256i a, __m256i b) const
+    {
+        return _mm256_and_si256(a, b);
+    }
+#endif
+};
+
+struct bitmap_or_op
+{
+    uint64_t operator()(uint64_t a, uint64_t b) const
+    {
+        return a | b;
+    }
+#ifdef __AVX2__
+    __m256i operator()(__m256i a, __m256i b) const
+    {
+        return _mm256_or_si256(a, b);
+    }
+#endif
+};
+
+struct bitmap_xor_op
+{
+    uint64_t operator()(uint64_t a, uint64_t b) const
+    {
+        return a ^ b;
+    }
+#ifdef __AVX2__
+    __m256i operator()(__m256i a, __m256i b) const
+    {
+        return _mm256_xor_si256(a, b);
+    }
+#endif
+};
+
+struct bitmap_andnot_op
+{
+    uint64_t operator()(uint64_t a, uint64_t b) const
+    {
+        return a & ~b;
+    }
+#ifdef __AVX2__
+    __m256i operator()(__m256i a, __m256i b) const
+    {
+        return _mm256_andnot_si256(b, a);
+    }
+#endif
+};
+
+template <typename Op>
+inline uint64_t bitmap_apply(std::span<const uint64_t> a, std::span<const uint64_t> b,
+                             std::span<uint64_t> out, size_t threads, Op op, const char *kernel)
+{
+    check_bitmaps(a.size(), b.size(), "bitmap: inputs differ in size");
+    check_bitmaps(a.size(), out.size(), "bitmap: output size differs");
+    SIMDLIB_PERF_SCOPE(kernel, a.size_bytes() + b.size_bytes() + out.size_bytes());
+    return bitmap_combine(a, b, out.data(), threads, op);
+}
+
+template <typename Op>
+inline uint64_t bitmap_count(std::span<const uint64_t> a, std::span<const uint64_t> b,
+                             size_t threads, Op op, const char *kernel)
+{
+    check_bitmaps(a.size(), b.size(), "bitmap: inputs differ in size");
+    SIMDLIB_PERF_SCOPE(kernel, a.size_bytes() + b.size_bytes());
+    return bitmap_combine(a, b, nullptr, threads, op);
+}
+
+} // namespace detail
+
+// number of set bits
+inline uint64_t bitmap_popcount(std::span<const uint64_t> words, size_t threads = 1)
+{
+    SIMDLIB_PERF_SCOPE("bitmap_popcount", words.size_bytes());
+    return detail::bitmap_combine(words, words, nullptr, threads, detail::bitmap_first_op{});
+}
+
+// out = a & b, a | b, a ^ b or a & ~b word by word, returning the number of set bits in out;
+// out may alias a or b
+inline uint64_t bitmap_and(std::span<const uint64_t> a, std::span<const uint64_t> b,
+                           std::span<uint64_t> out, size_t threads = 1)
+{
+    return detail::bitmap_apply(a, b, out, threads, detail::bitmap_and_op{}, "bitmap_and");
+}
+
+inline uint64_t bitmap_or(std::span<const uint64_t> a, std::span<const uint64_t> b,
+                          std::span<uint64_t> out, size_t threads = 1)
+{
+    return detail::bitmap_apply(a, b, out, threads, detail::bitmap_or_op{}, "bitmap_or");
+}
+
+inline uint64_t bitmap_xor(std::span<const uint64_t> a, std::span<const uint64_t> b,
+                           std::span<uint64_t> out, size_t threads = 1)
+{
+    return detail::bitmap_apply(a, b, out, threads, detail::bitmap_xor_op{}, "bitmap_xor");
+}
+
+inline uint64_t bitmap_andnot(std::span<const uint64_t> a, std::span<const uint64_t> b,
+                              std::span<uint64_t> out, size_t threads = 1)
+{
+    return detail::bitmap_apply(a, b, out, threads, detail::bitmap_andnot_op{}, "bitmap_andnot");
+}
+
+// set bits of a & b, a | b, a ^ b or a & ~b without writing the result
+inline uint64_t bitmap_and_count(std::span<const uint64_t> a, std::span<const uint64_t> b,
+                                 size_t threads = 1)
+{
+    return detail::bitmap_count(a, b, threads, detail::bitmap_and_op{}, "bitmap_and_count");
+}
+
+inline uint64_t bitmap_or_count(std::span<const uint64_t> a, std::span<const uint64_t> b,
+                                size_t threads = 1)
+{
+    return detail::bitmap_count(a, b, threads, detail::bitmap_or_op{}, "bitmap_or_count");
+}
+
+inline uint64_t bitmap_xor_count(std::span<const uint64_t> a, std::span<const uint64_t> b,
+                                 size_t threads = 1)
+{
+    return detail::bitmap_count(a, b, threads, detail::bitmap_xor_op{}, "bitmap_xor_count");
+}
+
+inline uint64_t bitmap_andnot_count(std::span<const uint64_t> a, std::span<const uint64_t> b,
+                                    size_t threads = 1)
+{
+    return detail::bitmap_count(a, b, threads, detail::bitmap_andnot_op{}, "bitmap_andnot_count");
+}
+
+// calls f(index) for every set bit in ascending order; zero words are skipped four at a time
+template <typename F> inline void for_each_set_bit(std::span<const uint64_t> words, F &&f)
+{
+    size_t w = 0;
+#ifdef __AVX2__
+    for (; w + detail::bitmap_vector_words <= words.size(); w += detail::bitmap_vector_words)
+    {
+        const __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(words.data() + w));
+        if (_mm256_testz_si256(v, v))
+            continue;
+        for (size_t k = w; k < w + detail::bitmap_vector_words; ++k)
+        {
+            for (uint64_t bits = words[k]; bits != 0; bits &= bits - 1)
+                f(k * 64 + static_cast<size_t>(std::countr_zero(bits)));
+        }
+    }
+#endif
+    for (; w < words.size(); ++w)
+    {
+        for (uint64_t bits = words[w]; bits != 0; bits &= bits - 1)
+            f(w * 64 + static_cast<size_t>(std::countr_zero(bits)));
+    }
+}
+
+// writes the positions of the set bits to out in ascending order and returns how many there
+// are; out must have room for all of them (bitmap_popcount)
+inline size_t set_bit_positions(std::span<const uint64_t> words, std::span<uint32_t> out)
+{
+    if (words.size() > (size_t{std::numeric_limits<uint32_t>::max()} + 1) / 64)
+        throw std::invalid_argument("set_bit_positions: bitmap too large for 32-bit positions");
+    SIMDLIB_PERF_SCOPE("set_bit_positions", words.size_bytes());
+    size_t n = 0;
+    uint32_t *dst = out.data();
+    for (size_t w = 0; w < words.size(); ++w)
+    {
+        uint64_t bits = words[w];
+        if (bits == 0)
+            continue;
+        const auto count = static_cast<size_t>(std::popcount(bits));
+        if (out.size() - n < count)
+            throw std::invalid_argument("set_bit_positions: output too small");
+        const auto base = static_cast<uint32_t>(w * 64);
+        // four positions per round without data-dependent branches, the extra writes land in
+        // slots the next word or round overwrites
+        size_t written = 0;
+        if (out.size() - n >= count + 3)
+        {
+            for (; written < count; written += 4)
+            {
+                dst[n + written] = base + static_cast<uint32_t>(std::countr_zero(bits));
+                bits &= bits - 1;
+                dst[n + written + 1] = base + static_cast<uint32_t>(std::countr_zero(bits));
+                bits &= bits - 1;
+                dst[n + written + 2] = base + static_cast<uint32_t>(std::countr_zero(bits));
+                bits &= bits - 1;
+                dst[n + written + 3] = base + static_cast<uint32_t>(std::countr_zero(bits));
+                bits &= bits - 1;
+            }
+        }
+        else
+        {
+            for (; bits != 0; bits &= bits - 1)
+                dst[n + written++] = base + static_cast<uint32_t>(std::countr_zero(bits));
+        }
+        n += count;
+    }
+    return n;
+}
+
+} // namespace simdlib
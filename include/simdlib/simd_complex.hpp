@@ -0,0 +1,662 @@
+#pragma once
+
+#include "simd_perf.hpp"
+#include "simd_vector.hpp"
+#include <algorithm>
+#include <array>
+#include <complex>
+#include <span>
+#include <stdexcept>
+
+namespace simdlib
+{
+
+// N interleaved floats (re, im, re, im, ...) holding N / 2 complex values
+template <typename T, size_t N> struct simd_complex;
+
+// SSE (2 complex values)
+template <> struct simd_complex<float, SSE_SIZE>
+{
+    static constexpr size_t size = SSE_SIZE / 2;
+
+    __m128 data; // re0 im0 re1 im1
+
+    simd_complex() : data(_mm_setzero_ps()) {}
+    explicit simd_complex(__m128 vec) : data(vec) {}
+    explicit simd_complex(std::complex<float> value)
+        : data(_mm_setr_ps(value.real(), value.imag(), value.real(), value.imag()))
+    {
+    }
+
+    static simd_complex load(const std::complex<float> *src)
+    {
+        return simd_complex(_mm_loadu_ps(reinterpret_cast<const float *>(src)));
+    }
+
+    // one value in slot 0, zero in slot 1
+    static simd_complex load1(const std::complex<float> *src)
+    {
+        return simd_complex(_mm_castpd_ps(_mm_load_sd(reinterpret_cast<const double *>(src))));
+    }
+
+    void store(std::complex<float> *dst) const
+    {
+        _mm_storeu_ps(reinterpret_cast<float *>(dst), data);
+    }
+
+    void store1(std::complex<float> *dst) const
+    {
+        _mm_store_sd(reinterpret_cast<double *>(dst), _mm_castps_pd(data));
+    }
+
+    std::complex<float> operator[](size_t i) const
+    {
+        alignas(SSE_ALIGNMENT) std::array<float, SSE_SIZE> elements{};
+        _mm_store_ps(elements.data(), data);
+        return {elements.at(2 * i), elements.at(2 * i + 1)};
+    }
+
+    simd_complex &operator+=(const simd_complex &other)
+    {
+        data = _mm_add_ps(data, other.data);
+        return *this;
+    }
+
+    simd_complex operator+(const simd_complex &other) const
+    {
+        return simd_complex(_mm_add_ps(data, other.data));
+    }
+
+    simd_complex &operator-=(const simd_complex &other)
+    {
+        data = _mm_sub_ps(data, other.data);
+        return *this;
+    }
+
+    simd_complex operator-(const simd_complex &other) const
+    {
+        return simd_complex(_mm_sub_ps(data, other.data));
+    }
+
+    // (a + bi)(c + di): the real parts of other broadcast (moveldup) times *this, plus or
+    // minus the imaginary parts (movehdup) times *this with re and im swapped (addsub)
+    simd_complex operator*(const simd_complex &other) const
+    {
+        const __m128 re = _mm_moveldup_ps(other.data);
+        const __m128 im = _mm_movehdup_ps(other.data);
+        const __m128 cross = _mm_mul_ps(_mm_shuffle_ps(data, data, 0xB1), im);
+#ifdef __FMA__
+        return simd_complex(_mm_fmaddsub_ps(data, re, cross));
+#else
+        return simd_complex(_mm_addsub_ps(_mm_mul_ps(data, re), cross));
+#endif
+    }
+
+    simd_complex &operator*=(const simd_complex &other)
+    {
+        return *this = *this * other;
+    }
+
+    // *this * other + acc with the accumulate folded into the real-part multiply
+    [[nodiscard]] simd_complex fmadd(const simd_complex &other, const simd_complex &acc) const
+    {
+        const __m128 cross =
+            _mm_mul_ps(_mm_shuffle_ps(data, data, 0xB1), _mm_movehdup_ps(other.data));
+#ifdef __FMA__
+        const __m128 real = _mm_fmadd_ps(data, _mm_moveldup_ps(other.data), acc.data);
+#else
+        const __m128 real =
+            _mm_add_ps(_mm_mul_ps(data, _mm_moveldup_ps(other.data)), acc.data);
+#endif
+        return simd_complex(_mm_addsub_ps(real, cross));
+    }
+
+    // scale by a real factor
+    simd_complex operator*(float scale) const
+    {
+        return simd_complex(_mm_mul_ps(data, _mm_set1_ps(scale)));
+    }
+
+    [[nodiscard]] simd_complex conj() const
+    {
+        return simd_complex(_mm_xor_ps(data, _mm_setr_ps(0.0f, -0.0f, 0.0f, -0.0f)));
+    }
+
+    // |z|^2 of each value, in both its re and im slot
+    [[nodiscard]] simd_vector<float, SSE_SIZE> norm() const
+    {
+        const __m128 sq = _mm_mul_ps(data, data);
+        return simd_vector<float, SSE_SIZE>(_mm_add_ps(sq, _mm_shuffle_ps(sq, sq, 0xB1)));
+    }
+
+    // |z| of each value, in both its re and im slot
+    [[nodiscard]] simd_vector<float, SSE_SIZE> abs() const
+    {
+        return simd_vector<float, SSE_SIZE>(_mm_sqrt_ps(norm().data));
+    }
+
+    [[nodiscard]] std::complex<float> horizontal_sum() const
+    {
+        const __m128 sums = _mm_add_ps(data, _mm_movehl_ps(data, data));
+        return {_mm_cvtss_f32(sums), _mm_cvtss_f32(_mm_movehdup_ps(sums))};
+    }
+};
+
+// AVX (4 complex values)
+template <> struct simd_complex<float, AVX_SIZE>
+{
+    static constexpr size_t size = AVX_SIZE / 2;
+
+    __m256 data; // re0 im0 re1 im1 re2 im2 re3 im3
+
+    simd_complex() : data(_mm256_setzero_ps()) {}
+    explicit simd_complex(__m256 vec) : data(vec) {}
+    explicit simd_complex(std::complex<float> value)
+        : data(_mm256_setr_ps(value.real(), value.imag(), value.real(), value.imag(),
+                              value.real(), value.imag(), value.real(), value.imag()))
+    {
+    }
+
+    static simd_complex load(const std::complex<float> *src)
+    {
+        return simd_complex(_mm256_loadu_ps(reinterpret_cast<const float *>(src)));
+    }
+
+    void store(std::complex<float> *dst) const
+    {
+        _mm256_storeu_ps(reinterpret_cast<float *>(dst), data);
+    }
+
+    std::complex<float> operator[](size_t i) const
+    {
+        alignas(AVX_ALIGNMENT) std::array<float, AVX_SIZE> elements{};
+        _mm256_store_ps(elements.data(), data);
+        return {elements.at(2 * i), elements.at(2 * i + 1)};
+    }
+
+    simd_complex &operator+=(const simd_complex &other)
+    {
+        data = _mm256_add_ps(data, other.data);
+        return *this;
+    }
+
+    simd_complex operator+(const simd_complex &other) const
+    {
+        return simd_complex(_mm256_add_ps(data, other.data));
+    }
+
+    simd_complex &operator-=(const simd_complex &other)
+    {
+        data = _mm256_sub_ps(data, other.data);
+        return *this;
+    }
+
+    simd_complex operator-(const simd_complex &other) const
+    {
+        return simd_complex(_mm256_sub_ps(data, other.data));
+    }
+
+    // same scheme as the SSE multiply, moveldup/movehdup/addsub work within each 128-bit half
+    simd_complex operator*(const simd_complex &other) const
+    {
+        const __m256 re = _mm256_moveldup_ps(other.data);
+        const __m256 im = _mm256_movehdup_ps(other.data);
+        const __m256 cross = _mm256_mul_ps(_mm256_permute_ps(data, 0xB1), im);
+#ifdef __FMA__
+        return simd_complex(_mm256_fmaddsub_ps(data, re, cross));
+#else
+        return simd_complex(_mm256_addsub_ps(_mm256_mul_ps(data, re), cross));
+#endif
+    }
+
+    simd_complex &operator*=(const simd_complex &other)
+    {
+        return *this = *this * other;
+    }
+
+    // *this * other + acc with the accumulate folded into the real-part multiply
+    [[nodiscard]] simd_complex fmadd(const simd_complex &other, const simd_complex &acc) const
+    {
+        const __m256 cross =
+            _mm256_mul_ps(_mm256_permute_ps(data, 0xB1), _mm256_movehdup_ps(other.data));
+#ifdef __FMA__
+        const __m256 real = _mm256_fmadd_ps(data, _mm256_moveldup_ps(other.data), acc.data);
+#else
+        const __m256 real =
+            _mm256_add_ps(_mm256_mul_ps(data, _mm256_moveldup_ps(other.data)), acc.data);
+#endif
+        return simd_complex(_mm256_addsub_ps(real, cross));
+    }
+
+    // scale by a real factor
+    simd_complex operator*(float scale) const
+    {
+        return simd_complex(_mm256_mul_ps(data, _mm256_set1_ps(scale)));
+    }
+
+    [[nodiscard]] simd_complex conj() const
+    {
+        return simd_complex(_mm256_xor_ps(
+            data, _mm256_setr_ps(0.0f, -0.0f, 0.0f, -0.0f, 0.0f, -0.0f, 0.0f, -0.0f)));
+    }
+
+    // |z|^2 of each value, in both its re and im slot
+    [[nodiscard]] simd_vector<float, AVX_SIZE> norm() const
+    {
+        const __m256 sq = _mm256_mul_ps(data, data);
+        return simd_vector<float, AVX_SIZE>(_mm256_add_ps(sq, _mm256_permute_ps(sq, 0xB1)));
+    }
+
+    // |z| of each value, in both its re and im slot
+    [[nodiscard]] simd_vector<float, AVX_SIZE> abs() const
+    {
+        return simd_vector<float, AVX_SIZE>(_mm256_sqrt_ps(norm().data));
+    }
+
+    [[nodiscard]] std::complex<float> horizontal_sum() const
+    {
+        return simd_complex<float, SSE_SIZE>(
+                   _mm_add_ps(_mm256_castps256_ps128(data), _mm256_extractf128_ps(data, 1)))
+            .horizontal_sum();
+    }
+
+    // the four |z|^2 packed into one SSE vector
+    [[nodiscard]] __m128 packed_norm() const
+    {
+        const __m256 sq = _mm256_mul_ps(data, data);
+        return _mm_hadd_ps(_mm256_castps256_ps128(sq), _mm256_extractf128_ps(sq, 1));
+    }
+};
+
+// split complex arrays, real and imaginary parts in separate spans of equal length
+struct split_complex_view
+{
+    std::span<const float> re;
+    std::span<const float> im;
+};
+
+struct split_complex_span
+{
+    std::span<float> re;
+    std::span<float> im;
+};
+
+namespace detail
+{
+
+inline size_t split_size(split_complex_view z)
+{
+    if (z.re.size() != z.im.size())
+        throw std::invalid_argument("split complex: re and im differ in size");
+    return z.re.size();
+}
+
+inline size_t split_size(split_complex_span z)
+{
+    return split_size(split_complex_view{z.re, z.im});
+}
+
+inline void check_complex_sizes(size_t a, size_t b, const char *what)
+{
+    if (a != b)
+        throw std::invalid_argument(what);
+}
+
+// at most two interleaved values in an SSE vector, zero in the unused slot
+inline simd_complex<float, SSE_SIZE> load_complex_tail(const std::complex<float> *p, size_t n)
+{
+    if (n == 2)
+        return simd_complex<float, SSE_SIZE>::load(p);
+    return simd_complex<float, SSE_SIZE>::load1(p);
+}
+
+inline void store_complex_tail(const simd_complex<float, SSE_SIZE> &z, std::complex<float> *p,
+                               size_t n)
+{
+    if (n == 2)
+        z.store(p);
+    else
+        z.store1(p);
+}
+
+// runs body(offset, count, load, store) over interleaved values four at a time, the last one to
+// three through SSE vectors so every value sees the same arithmetic
+template <typename Body> inline void for_each_complex(size_t n, Body body)
+{
+    const auto full_load = [](const std::complex<float> *p, size_t)
+    { return simd_complex<float, AVX_SIZE>::load(p); };
+    const auto full_store = [](const simd_complex<float, AVX_SIZE> &z, std::complex<float> *p,
+                               size_t) { z.store(p); };
+    constexpr size_t step = simd_complex<float, AVX_SIZE>::size;
+    size_t i = 0;
+    for (; i + step <= n; i += step)
+        body(i, step, full_load, full_store);
+    for (; i < n; i += simd_complex<float, SSE_SIZE>::size)
+        body(i, std::min(n - i, simd_complex<float, SSE_SIZE>::size), load_complex_tail,
+             store_complex_tail);
+}
+
+// the n < 8 floats at p copied into a zero-padded vector
+inline simd_vector<float, AVX_SIZE> load_partial(const float *p, size_t n)
+{
+    alignas(AVX_ALIGNMENT) std::array<float, AVX_SIZE> buf{};
+    std::copy(p, p + n, buf.begin());
+    return simd_vector<float, AVX_SIZE>(_mm256_load_ps(buf.data()));
+}
+
+inline void store_partial(const simd_vector<float, AVX_SIZE> &v, float *p, size_t n)
+{
+    alignas(AVX_ALIGNMENT) std::array<float, AVX_SIZE> buf{};
+    _mm256_store_ps(buf.data(), v.data);
+    std::copy(buf.begin(), buf.begin() + static_cast<std::ptrdiff_t>(n), p);
+}
+
+// runs body(offset, count, load, store) over split arrays eight values at a time, the last
+// group through zero-padded copies
+template <typename Body> inline void for_each_split(size_t n, Body body)
+{
+    const auto full_load = [](const float *p, size_t)
+    { return simd_vector<float, AVX_SIZE>(_mm256_loadu_ps(p)); };
+    const auto full_store = [](const simd_vector<float, AVX_SIZE> &v, float *p, size_t)
+    { _mm256_storeu_ps(p, v.data); };
+    size_t i = 0;
+    for (; i + AVX_SIZE <= n; i += AVX_SIZE)
+        body(i, AVX_SIZE, full_load, full_store);
+    if (i < n)
+        body(i, n - i, load_partial, store_partial);
+}
+
+} // namespace detail
+
+// interleaved kernels over std::complex<float> arrays
+
+// out = a * b element-wise; out may alias a or b
+inline void complex_multiply(std::span<const std::complex<float>> a,
+                             std::span<const std::complex<float>> b,
+                             std::span<std::complex<float>> out)
+{
+    detail::check_complex_sizes(a.size(), b.size(), "complex_multiply: inputs differ in size");
+    detail::check_complex_sizes(a.size(), out.size(), "complex_multiply: output size differs");
+    SIMDLIB_PERF_SCOPE("complex_multiply", a.size_bytes() + b.size_bytes() + out.size_bytes());
+    detail::for_each_complex(a.size(),
+                             [&](size_t i, size_t count, auto load, auto store)
+                             { store(load(&a[i], count) * load(&b[i], count), &out[i], count); });
+}
+
+// acc += a * b element-wise, the multiply-accumulate at the heart of filters and correlators
+inline void complex_multiply_accumulate(std::span<const std::complex<float>> a,
+                                        std::span<const std::complex<float>> b,
+                                        std::span<std::complex<float>> acc)
+{
+    detail::check_complex_sizes(a.size(), b.size(),
+                                "complex_multiply_accumulate: inputs differ in size");
+    detail::check_complex_sizes(a.size(), acc.size(),
+                                "complex_multiply_accumulate: accumulator size differs");
+    SIMDLIB_PERF_SCOPE("complex_multiply_accumulate",
+                       a.size_bytes() + b.size_bytes() + 2 * acc.size_bytes());
+    detail::for_each_complex(a.size(),
+                             [&](size_t i, size_t count, auto load, auto store)
+                             {
+                                 const auto x = load(&a[i], count);
+                                 const auto y = load(&b[i], count);
+                                 store(x.fmadd(y, load(&acc[i], count)), &acc[i], count);
+                             });
+}
+
+namespace detail
+{
+
+template <bool ConjugateA>
+inline std::complex<float> complex_dot(std::span<const std::complex<float>> a,
+                                       std::span<const std::complex<float>> b)
+{
+    check_complex_sizes(a.size(), b.size(), "complex_dot: inputs differ in size");
+    SIMDLIB_PERF_SCOPE("complex_dot", a.size_bytes() + b.size_bytes());
+    // conj(x) y + acc or x y + acc
+    const auto term = [](auto x, auto y, auto acc)
+    {
+        if constexpr (ConjugateA)
+            return x.conj().fmadd(y, acc);
+        else
+            return x.fmadd(y, acc);
+    };
+    // two accumulators hide the multiply-add latency
+    simd_complex<float, AVX_SIZE> acc0;
+    simd_complex<float, AVX_SIZE> acc1;
+    constexpr size_t step = simd_complex<float, AVX_SIZE>::size;
+    size_t i = 0;
+    for (; i + 2 * step <= a.size(); i += 2 * step)
+    {
+        acc0 = term(simd_complex<float, AVX_SIZE>::load(&a[i]),
+                    simd_complex<float, AVX_SIZE>::load(&b[i]), acc0);
+        acc1 = term(simd_complex<float, AVX_SIZE>::load(&a[i + step]),
+                    simd_complex<float, AVX_SIZE>::load(&b[i + step]), acc1);
+    }
+    simd_complex<float, SSE_SIZE> tail;
+    for (; i < a.size(); i += simd_complex<float, SSE_SIZE>::size)
+    {
+        const size_t count = std::min(a.size() - i, simd_complex<float, SSE_SIZE>::size);
+        tail = term(load_complex_tail(&a[i], count), load_complex_tail(&b[i], count), tail);
+    }
+    return (acc0 + acc1).horizontal_sum() + tail.horizontal_sum();
+}
+
+} // namespace detail
+
+// sum of a[i] * b[i]
+inline std::complex<float> complex_dot(std::span<const std::complex<float>> a,
+                                       std::span<const std::complex<float>> b)
+{
+    return detail::complex_dot<false>(a, b);
+}
+
+// sum of conj(a[i]) * b[i], the inner product of complex vectors
+inline std::complex<float> complex_dot_conj(std::span<const std::complex<float>> a,
+                                            std::span<const std::complex<float>> b)
+{
+    return detail::complex_dot<true>(a, b);
+}
+
+// out = conj(z); out may alias z
+inline void complex_conj(std::span<const std::complex<float>> z,
+                         std::span<std::complex<float>> out)
+{
+    detail::check_complex_sizes(z.size(), out.size(), "complex_conj: buffers differ in size");
+    SIMDLIB_PERF_SCOPE("complex_conj", z.size_bytes() + out.size_bytes());
+    detail::for_each_complex(z.size(),
+                             [&](size_t i, size_t count, auto load, auto store)
+                             { store(load(&z[i], count).conj(), &out[i], count); });
+}
+
+// out = |z|
+inline void complex_abs(std::span<const std::complex<float>> z, std::span<float> out)
+{
+    detail::check_complex_sizes(z.size(), out.size(), "complex_abs: buffers differ in size");
+    SIMDLIB_PERF_SCOPE("complex_abs", z.size_bytes() + out.size_bytes());
+    size_t i = 0;
+    for (; i + 4 <= z.size(); i += 4)
+        _mm_storeu_ps(out.data() + i,
+                      _mm_sqrt_ps(simd_complex<float, AVX_SIZE>::load(&z[i]).packed_norm()));
+    for (; i < z.size(); ++i)
+    {
+        const simd_vector<float, SSE_SIZE> r =
+            simd_complex<float, SSE_SIZE>::load1(&z[i]).abs();
+        out[i] = r[0];
+    }
+}
+
+// split-layout kernels, eight values per vector with no shuffles at all
+
+inline void complex_multiply(split_complex_view a, split_complex_view b, split_complex_span out)
+{
+    const size_t n = detail::split_size(a);
+    detail::check_complex_sizes(n, detail::split_size(b),
+                                "complex_multiply: inputs differ in size");
+    detail::check_complex_sizes(n, detail::split_size(out),
+                                "complex_multiply: output size differs");
+    SIMDLIB_PERF_SCOPE("complex_multiply_split", 6 * n * sizeof(float));
+    detail::for_each_split(n,
+                           [&](size_t i, size_t count, auto load, auto store)
+                           {
+                               const auto ar = load(a.re.data() + i, count);
+                               const auto ai = load(a.im.data() + i, count);
+                               const auto br = load(b.re.data() + i, count);
+                               const auto bi = load(b.im.data() + i, count);
+                               store(ar.fmadd(br, simd_vector<float, AVX_SIZE>() - ai * bi),
+                                     out.re.data() + i, count);
+                               store(ar.fmadd(bi, ai * br), out.im.data() + i, count);
+                           });
+}
+
+inline void complex_multiply_accumulate(split_complex_view a, split_complex_view b,
+                                        split_complex_span acc)
+{
+    const size_t n = detail::split_size(a);
+    detail::check_complex_sizes(n, detail::split_size(b),
+                                "complex_multiply_accumulate: inputs differ in size");
+    detail::check_complex_sizes(n, detail::split_size(acc),
+                                "complex_multiply_accumulate: accumulator size differs");
+    SIMDLIB_PERF_SCOPE("complex_multiply_accumulate_split", 8 * n * sizeof(float));
+    detail::for_each_split(n,
+                           [&](size_t i, size_t count, auto load, auto store)
+                           {
+                               const auto ar = load(a.re.data() + i, count);
+                               const auto ai = load(a.im.data() + i, count);
+                               const auto br = load(b.re.data() + i, count);
+                               const auto bi = load(b.im.data() + i, count);
+                               const auto cr = load(acc.re.data() + i, count);
+                               const auto ci = load(acc.im.data() + i, count);
+                               store(ar.fmadd(br, cr - ai * bi), acc.re.data() + i, count);
+                               store(ar.fmadd(bi, ai.fmadd(br, ci)), acc.im.data() + i, count);
+                           });
+}
+
+namespace detail
+{
+
+template <bool ConjugateA>
+inline std::complex<float> complex_dot(split_complex_view a, split_complex_view b)
+{
+    const size_t n = split_size(a);
+    check_complex_sizes(n, split_size(b), "complex_dot: inputs differ in size");
+    SIMDLIB_PERF_SCOPE("complex_dot_split", 4 * n * sizeof(float));
+    // real part sum(ar br -+ ai bi), imaginary part sum(ar bi +- ai br)
+    simd_vector<float, AVX_SIZE> rr;
+    simd_vector<float, AVX_SIZE> ii;
+    simd_vector<float, AVX_SIZE> ri;
+    simd_vector<float, AVX_SIZE> ir;
+    for_each_split(n,
+                   [&](size_t i, size_t count, auto load, auto)
+                   {
+                       const auto ar = load(a.re.data() + i, count);
+                       const auto ai = load(a.im.data() + i, count);
+                       const auto br = load(b.re.data() + i, count);
+                       const auto bi = load(b.im.data() + i, count);
+                       rr = ar.fmadd(br, rr);
+                       ii = ai.fmadd(bi, ii);
+                       ri = ar.fmadd(bi, ri);
+                       ir = ai.fmadd(br, ir);
+                   });
+    if constexpr (ConjugateA)
+        return {(rr + ii).horizontal_sum(), (ri - ir).horizontal_sum()};
+    else
+        return {(rr - ii).horizontal_sum(), (ri + ir).horizontal_sum()};
+}
+
+} // namespace detail
+
+inline std::complex<float> complex_dot(split_complex_view a, split_complex_view b)
+{
+    return detail::complex_dot<false>(a, b);
+}
+
+inline std::complex<float> complex_dot_conj(split_complex_view a, split_complex_view b)
+{
+    return detail::complex_dot<true>(a, b);
+}
+
+inline void complex_abs(split_complex_view z, std::span<float> out)
+{
+    const size_t n = detail::split_size(z);
+    detail::check_complex_sizes(n, out.size(), "complex_abs: buffers differ in size");
+    SIMDLIB_PERF_SCOPE("complex_abs_split", 3 * n * sizeof(float));
+    detail::for_each_split(n,
+                           [&](size_t i, size_t count, auto load, auto store)
+                           {
+                               const auto re = load(z.re.data() + i, count);
+                               const auto im = load(z.im.data() + i, count);
+                               store(simd_vector<float, AVX_SIZE>(
+                                         _mm256_sqrt_ps(re.fmadd(re, im * im).data)),
+                                     out.data() + i, count);
+                           });
+}
+
+// layout conversions
+
+namespace detail
+{
+
+// src holds n (re, im) pairs
+inline void deinterleave_floats(const float *src, float *re, float *im, size_t n)
+{
+    size_t i = 0;
+    for (; i + AVX_SIZE <= n; i += AVX_SIZE)
+    {
+        // shuffle_ps works per 128-bit half, so the halves are swapped first and the
+        // 64-bit pairs put back in order afterwards
+        const __m256 lo = _mm256_loadu_ps(src + 2 * i);
+        const __m256 hi = _mm256_loadu_ps(src + 2 * i + AVX_SIZE);
+        const __m256 a = _mm256_permute2f128_ps(lo, hi, 0x20);
+        const __m256 b = _mm256_permute2f128_ps(lo, hi, 0x31);
+        _mm256_storeu_ps(re + i, _mm256_shuffle_ps(a, b, _MM_SHUFFLE(2, 0, 2, 0)));
+        _mm256_storeu_ps(im + i, _mm256_shuffle_ps(a, b, _MM_SHUFFLE(3, 1, 3, 1)));
+    }
+    for (; i < n; ++i)
+    {
+        re[i] = src[2 * i];
+        im[i] = src[2 * i + 1];
+    }
+}
+
+// dst receives n (re, im) pairs, each multiplied by scale
+inline void interleave_floats(const float *re, const float *im, float *dst, size_t n,
+                              float scale = 1.0f)
+{
+    const __m256 factor = _mm256_set1_ps(scale);
+    size_t i = 0;
+    for (; i + AVX_SIZE <= n; i += AVX_SIZE)
+    {
+        const __m256 r = _mm256_mul_ps(_mm256_loadu_ps(re + i), factor);
+        const __m256 m = _mm256_mul_ps(_mm256_loadu_ps(im + i), factor);
+        const __m256 a = _mm256_unpacklo_ps(r, m); // values 0 1 | 4 5
+        const __m256 b = _mm256_unpackhi_ps(r, m); // values 2 3 | 6 7
+        _mm256_storeu_ps(dst + 2 * i, _mm256_permute2f128_ps(a, b, 0x20));
+        _mm256_storeu_ps(dst + 2 * i + AVX_SIZE, _mm256_permute2f128_ps(a, b, 0x31));
+    }
+    for (; i < n; ++i)
+    {
+        dst[2 * i] = re[i] * scale;
+        dst[2 * i + 1] = im[i] * scale;
+    }
+}
+
+} // namespace detail
+
+inline void deinterleave(std::span<const std::complex<float>> z, split_complex_span out)
+{
+    const size_t n = detail::split_size(out);
+    detail::check_complex_sizes(z.size(), n, "deinterleave: buffers differ in size");
+    SIMDLIB_PERF_SCOPE("deinterleave", 2 * z.size_bytes());
+    detail::deinterleave_floats(reinterpret_cast<const float *>(z.data()), out.re.data(),
+                                out.im.data(), n);
+}
+
+inline void interleave(split_complex_view z, std::span<std::complex<float>> out)
+{
+    const size_t n = detail::split_size(z);
+    detail::check_complex_sizes(n, out.size(), "interleave: buffers differ in size");
+    SIMDLIB_PERF_SCOPE("interleave", 2 * out.size_bytes());
+    detail::interleave_floats(z.re.data(), z.im.data(), reinterpret_cast<float *>(out.data()), n);
+}
+
+} // namespace simdlib
@@ -0,0 +1,268 @@
+#pragma once
+
+#include "simd_perf.hpp"
+#include "simd_vector.hpp"
+#include <algorithm>
+#include <array>
+#include <span>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+namespace simdlib
+{
+
+namespace detail
+{
+
+// tap counts up to this get a kernel with every tap broadcast held in a register
+constexpr size_t max_fixed_taps = 16;
+
+// output vectors computed per iteration, independent accumulators to cover FMA latency
+constexpr size_t conv_blocks = 4;
+
+// the 8 floats starting Shift lanes into the 16-float window lo:hi, built in registers
+template <size_t Shift>
+inline simd_vector<float, AVX_SIZE> window(const simd_vector<float, AVX_SIZE> &lo,
+                                           const simd_vector<float, AVX_SIZE> &hi)
+{
+    static_assert(Shift < AVX_SIZE, "shift must stay inside one register");
+    if constexpr (Shift == 0)
+    {
+        return lo;
+    }
+    else
+    {
+        // middle register straddles the two inputs: lo[4..8) : hi[0..4)
+        const __m256 mid = _mm256_permute2f128_ps(lo.data, hi.data, 0x21);
+        if constexpr (Shift == 4)
+        {
+            return simd_vector<float, AVX_SIZE>(mid);
+        }
+        else
+        {
+#ifdef __AVX2__
+            const __m256i lo_i = _mm256_castps_si256(lo.data);
+            const __m256i mid_i = _mm256_castps_si256(mid);
+            const __m256i hi_i = _mm256_castps_si256(hi.data);
+            if constexpr (Shift < 4)
+                return simd_vector<float, AVX_SIZE>(
+                    _mm256_castsi256_ps(_mm256_alignr_epi8(mid_i, lo_i, 4 * Shift)));
+            else
+                return simd_vector<float, AVX_SIZE>(
+                    _mm256_castsi256_ps(_mm256_alignr_epi8(hi_i, mid_i, 4 * (Shift - 4))));
+#else
+            // same shift as two 128-bit alignr over the low and high halves
+            constexpr int bytes = 4 * (Shift % 4);
+            const __m256 first = Shift < 4 ? lo.data : mid;
+            const __m256 second = Shift < 4 ? mid : hi.data;
+            const __m128i a0 = _mm_castps_si128(_mm256_castps256_ps128(first));
+            const __m128i a1 = _mm_castps_si128(_mm256_extractf128_ps(first, 1));
+            const __m128i b0 = _mm_castps_si128(_mm256_castps256_ps128(second));
+            const __m128i b1 = _mm_castps_si128(_mm256_extractf128_ps(second, 1));
+            return simd_vector<float, AVX_SIZE>(
+                _mm256_setr_m128(_mm_castsi128_ps(_mm_alignr_epi8(b0, a0, bytes)),
+                                 _mm_castsi128_ps(_mm_alignr_epi8(b1, a1, bytes))));
+#endif
+        }
+    }
+}
+
+// adds tap * x[i + 8 * j + Tap] to every accumulator j, reusing the loaded windows
+template <size_t Tap, size_t Regs>
+inline void accumulate_tap(const std::array<simd_vector<float, AVX_SIZE>, Regs> &win,
+                           const simd_vector<float, AVX_SIZE> &tap,
+                           std::array<simd_vector<float, AVX_SIZE>, conv_blocks> &acc)
+{
+    constexpr size_t reg = Tap / AVX_SIZE;
+    for (size_t j = 0; j < conv_blocks; ++j)
+        acc[j] = window<Tap % AVX_SIZE>(win[j + reg], win[j + reg + 1]).fmadd(tap, acc[j]);
+}
+
+inline float correlate_at(const float *x, const float *rtaps, size_t taps)
+{
+    float sum = 0.0f;
+    for (size_t k = 0; k < taps; ++k)
+        sum += rtaps[k] * x[k];
+    return sum;
+}
+
+// out[i] = sum_k rtaps[k] * x[i + k] for a compile-time tap count
+template <size_t K>
+inline void correlate_fixed(const float *x, size_t n_out, const float *rtaps, float *out)
+{
+    static_assert(K > 0 && K <= max_fixed_taps, "unsupported fixed tap count");
+    constexpr size_t regs = conv_blocks + (K + AVX_SIZE - 1) / AVX_SIZE;
+    std::array<simd_vector<float, AVX_SIZE>, K> taps;
+    for (size_t k = 0; k < K; ++k)
+        taps[k] = simd_vector<float, AVX_SIZE>(rtaps[k]);
+
+    const size_t n_in = n_out + K - 1;
+    size_t i = 0;
+    for (; i + regs * AVX_SIZE <= n_in; i += conv_blocks * AVX_SIZE)
+    {
+        std::array<simd_vector<float, AVX_SIZE>, regs> win;
+        for (size_t r = 0; r < regs; ++r)
+            win[r] = simd_vector<float, AVX_SIZE>(_mm256_loadu_ps(x + i + r * AVX_SIZE));
+        std::array<simd_vector<float, AVX_SIZE>, conv_blocks> acc{};
+        [&]<size_t... k>(std::index_sequence<k...>)
+        { (accumulate_tap<k>(win, taps[k], acc), ...); }(std::make_index_sequence<K>{});
+        for (size_t j = 0; j < conv_blocks; ++j)
+            _mm256_storeu_ps(out + i + j * AVX_SIZE, acc[j].data);
+    }
+    for (; i < n_out; ++i)
+        out[i] = correlate_at(x + i, rtaps, K);
+}
+
+// out[i] = sum_k rtaps[k] * x[i + k] for any tap count, taps streamed in blocks of eight
+inline void correlate_generic(const float *x, size_t n_out, const float *rtaps, size_t taps,
+                              float *out)
+{
+    constexpr size_t regs = conv_blocks + 1;
+    const size_t padded = (taps + AVX_SIZE - 1) / AVX_SIZE * AVX_SIZE;
+    const size_t n_in = n_out + taps - 1;
+    size_t i = 0;
+    for (; i + padded + conv_blocks * AVX_SIZE <= n_in; i += conv_blocks * AVX_SIZE)
+    {
+        std::array<simd_vector<float, AVX_SIZE>, conv_blocks> acc{};
+        for (size_t kb = 0; kb < padded; kb += AVX_SIZE)
+        {
+            std::array<simd_vector<float, AVX_SIZE>, regs> win;
+            for (size_t r = 0; r < regs; ++r)
+                win[r] = simd_vector<float, AVX_SIZE>(_mm256_loadu_ps(x + i + kb + r * AVX_SIZE));
+            [&]<size_t... k>(std::index_sequence<k...>)
+            {
+                // the last block may be partial; skipping keeps 0 * inf out of the sums
+                ((kb + k < taps
+                      ? accumulate_tap<k>(win, simd_vector<float, AVX_SIZE>(rtaps[kb + k]), acc)
+                      : void()),
+                 ...);
+            }(std::make_index_sequence<AVX_SIZE>{});
+        }
+        for (size_t j = 0; j < conv_blocks; ++j)
+            _mm256_storeu_ps(out + i + j * AVX_SIZE, acc[j].data);
+    }
+    for (; i < n_out; ++i)
+        out[i] = correlate_at(x + i, rtaps, taps);
+}
+
+template <size_t K = 1>
+inline void correlate(const float *x, size_t n_out, const float *rtaps, size_t taps, float *out)
+{
+    if (taps == K)
+        correlate_fixed<K>(x, n_out, rtaps, out);
+    else if constexpr (K < max_fixed_taps)
+        correlate<K + 1>(x, n_out, rtaps, taps, out);
+    else
+        correlate_generic(x, n_out, rtaps, taps, out);
+}
+
+inline size_t valid_outputs(size_t signal, size_t taps)
+{
+    if (taps == 0)
+        throw std::invalid_argument("convolve1d: no taps");
+    return signal >= taps ? signal - taps + 1 : 0;
+}
+
+} // namespace detail
+
+// valid-mode convolution: out[i] = sum_k taps[k] * signal[i + taps.size() - 1 - k],
+// out must hold signal.size() - taps.size() + 1 values (or none if the signal is shorter)
+inline void convolve1d(std::span<const float> signal, std::span<const float> taps,
+                       std::span<float> out)
+{
+    const size_t n_out = detail::valid_outputs(signal.size(), taps.size());
+    if (out.size() != n_out)
+        throw std::invalid_argument("convolve1d: output size must be signal - taps + 1");
+    SIMDLIB_PERF_SCOPE("convolve1d", signal.size_bytes() + out.size_bytes());
+    if (n_out == 0)
+        return;
+
+    std::vector<float> rtaps(taps.rbegin(), taps.rend());
+    detail::correlate(signal.data(), n_out, rtaps.data(), rtaps.size(), out.data());
+}
+
+// valid-mode convolution with the tap count fixed at compile time
+template <size_t K>
+void convolve1d(std::span<const float> signal, const std::array<float, K> &taps,
+                std::span<float> out)
+{
+    const size_t n_out = detail::valid_outputs(signal.size(), K);
+    if (out.size() != n_out)
+        throw std::invalid_argument("convolve1d: output size must be signal - taps + 1");
+    SIMDLIB_PERF_SCOPE("convolve1d", signal.size_bytes() + out.size_bytes());
+    if (n_out == 0)
+        return;
+
+    std::array<float, K> rtaps;
+    std::reverse_copy(taps.begin(), taps.end(), rtaps.begin());
+    if constexpr (K <= detail::max_fixed_taps)
+        detail::correlate_fixed<K>(signal.data(), n_out, rtaps.data(), out.data());
+    else
+        detail::correlate_generic(signal.data(), n_out, rtaps.data(), K, out.data());
+}
+
+// streaming FIR filter: y[n] = sum_k taps[k] * x[n - k] over a signal fed in chunks,
+// starting from rest (zero history)
+class fir_filter
+{
+  public:
+    explicit fir_filter(std::span<const float> taps)
+        : rtaps_(taps.rbegin(), taps.rend()), history_(taps.empty() ? 0 : taps.size() - 1)
+    {
+        if (taps.empty())
+            throw std::invalid_argument("fir_filter: no taps");
+    }
+
+    // filter one chunk, out receives one sample per input sample
+    void process(std::span<const float> in, std::span<float> out)
+    {
+        if (out.size() != in.size())
+            throw std::invalid_argument("fir_filter: output size differs from input size");
+        SIMDLIB_PERF_SCOPE("fir_filter", in.size_bytes() + out.size_bytes());
+        const size_t taps = rtaps_.size();
+        const size_t h = history_.size();
+
+        // outputs whose window reaches back into earlier chunks read a stitched buffer
+        const size_t head = std::min(in.size(), h);
+        if (head > 0)
+        {
+            stitch_.assign(history_.begin(), history_.end());
+            stitch_.insert(stitch_.end(), in.begin(),
+                           in.begin() + static_cast<std::ptrdiff_t>(head));
+            detail::correlate(stitch_.data(), head, rtaps_.data(), taps, out.data());
+        }
+        if (in.size() > h)
+            detail::correlate(in.data(), in.size() - h, rtaps_.data(), taps, out.data() + h);
+
+        if (in.size() >= h)
+        {
+            std::copy(in.end() - static_cast<std::ptrdiff_t>(h), in.end(), history_.begin());
+        }
+        else
+        {
+            std::copy(history_.begin() + static_cast<std::ptrdiff_t>(in.size()), history_.end(),
+                      history_.begin());
+            std::copy(in.begin(), in.end(),
+                      history_.end() - static_cast<std::ptrdiff_t>(in.size()));
+        }
+    }
+
+    // forget the signal seen so far
+    void reset()
+    {
+        std::fill(history_.begin(), history_.end(), 0.0f);
+    }
+
+    [[nodiscard]] size_t taps() const
+    {
+        return rtaps_.size();
+    }
+
+  private:
+    std::vector<float> rtaps_;   // taps reversed so filtering is a forward correlation
+    std::vector<float> history_; // last taps - 1 input samples, oldest first
+    std::vector<float> stitch_;  // history followed by the head of the current chunk
+};
+
+} // namespace simdlib
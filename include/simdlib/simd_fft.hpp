@@ -0,0 +1,654 @@
+#pragma once
+
+#include "simd_allocator.hpp"
+#include "simd_complex.hpp"
+#include "simd_parallel.hpp"
+#include "simd_perf.hpp"
+#include "simd_vector.hpp"
+#include <array>
+#include <bit>
+#include <cmath>
+#include <complex>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <numbers>
+#include <span>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+namespace simdlib
+{
+
+namespace detail
+{
+
+using fft_vector = simd_vector<float, AVX_SIZE>;
+
+// shorter transforms run the scalar radix-2 stages, the vector stages need a quarter of the
+// transform to fill at least one vector
+constexpr size_t fft_min_vector_size = 4 * AVX_SIZE;
+
+// complex values a batch thread must have before a batched transform is split
+constexpr size_t fft_min_chunk = size_t{1} << 15;
+
+// one radix-4 Stockham pass (length 2 is the closing radix-2 pass): the data is read as
+// length-point sub-transforms interleaved with the given stride. The twiddles w^p, w^2p and
+// w^3p are stored as six blocks (re, im per power) of count values, indexed by the element
+// offset inside a quarter for strides below a vector and by p otherwise.
+struct fft_stage
+{
+    size_t length = 0;
+    size_t stride = 0;
+    size_t count = 0;
+    aligned_vector<float> twiddles;
+};
+
+struct fft_tables
+{
+    size_t size = 0;
+    std::vector<fft_stage> stages;
+    // w^j for j < size / 2, used by the scalar stages
+    std::vector<std::complex<float>> roots;
+};
+
+inline fft_tables make_fft_tables(size_t n)
+{
+    if (n == 0 || !std::has_single_bit(n))
+        throw std::invalid_argument("fft_plan: size must be a power of two");
+    fft_tables t;
+    t.size = n;
+    const double turn = -2.0 * std::numbers::pi / static_cast<double>(n);
+    t.roots.resize(n / 2);
+    for (size_t j = 0; j < n / 2; ++j)
+        t.roots[j] = std::polar(1.0f, static_cast<float>(turn * static_cast<double>(j)));
+    if (n < fft_min_vector_size)
+        return t;
+
+    size_t length = n;
+    size_t stride = 1;
+    for (; length >= 4; length /= 4, stride *= 4)
+    {
+        fft_stage stage;
+        stage.length = length;
+        stage.stride = stride;
+        const size_t m = length / 4;
+        stage.count = stride < AVX_SIZE ? m * stride : m;
+        stage.twiddles.resize(6 * stage.count);
+        for (size_t idx = 0; idx < stage.count; ++idx)
+        {
+            const size_t p = stride < AVX_SIZE ? idx / stride : idx;
+            for (size_t j = 1; j <= 3; ++j)
+            {
+                const double angle = -2.0 * std::numbers::pi * static_cast<double>(j * p) /
+                                     static_cast<double>(length);
+                float *tw = stage.twiddles.data() + idx;
+                tw[(2 * j - 2) * stage.count] = static_cast<float>(std::cos(angle));
+                tw[(2 * j - 1) * stage.count] = static_cast<float>(std::sin(angle));
+            }
+        }
+        t.stages.push_back(std::move(stage));
+    }
+    if (length == 2)
+        t.stages.push_back(fft_stage{2, stride, 0, {}});
+    return t;
+}
+
+inline fft_vector load_fft(const float *p)
+{
+    return fft_vector(_mm256_load_ps(p));
+}
+
+inline void store_fft(float *p, const fft_vector &v)
+{
+    _mm256_store_ps(p, v.data);
+}
+
+// (xr + i xi)(wr + i wi) on split vectors, written back into x
+inline void fft_twiddle(fft_vector &xr, fft_vector &xi, const fft_vector &wr, const fft_vector &wi)
+{
+#ifdef __FMA__
+    const fft_vector re(_mm256_fmsub_ps(xr.data, wr.data, (xi * wi).data));
+#else
+    const fft_vector re = xr * wr - xi * wi;
+#endif
+    xi = xr.fmadd(wi, xi * wr);
+    xr = re;
+}
+
+struct fft_quad
+{
+    std::array<fft_vector, 4> re;
+    std::array<fft_vector, 4> im;
+};
+
+// radix-4 decimation-in-frequency butterfly on a_k = x[i + k quarter]:
+// y0 = b0 + b2, y1 = b1 - i d, y2 = b0 - b2, y3 = b1 + i d with b0 = a0 + a2, b1 = a0 - a2,
+// b2 = a1 + a3 and d = a1 - a3
+inline fft_quad fft_butterfly(const float *xr, const float *xi, size_t i, size_t quarter)
+{
+    const fft_vector a0r = load_fft(xr + i);
+    const fft_vector a0i = load_fft(xi + i);
+    const fft_vector a1r = load_fft(xr + i + quarter);
+    const fft_vector a1i = load_fft(xi + i + quarter);
+    const fft_vector a2r = load_fft(xr + i + 2 * quarter);
+    const fft_vector a2i = load_fft(xi + i + 2 * quarter);
+    const fft_vector a3r = load_fft(xr + i + 3 * quarter);
+    const fft_vector a3i = load_fft(xi + i + 3 * quarter);
+    const fft_vector b0r = a0r + a2r;
+    const fft_vector b0i = a0i + a2i;
+    const fft_vector b1r = a0r - a2r;
+    const fft_vector b1i = a0i - a2i;
+    const fft_vector b2r = a1r + a3r;
+    const fft_vector b2i = a1i + a3i;
+    const fft_vector dr = a1r - a3r;
+    const fft_vector di = a1i - a3i;
+    return {{b0r + b2r, b1r + di, b0r - b2r, b1r - di}, {b0i + b2i, b1i - dr, b0i - b2i, b1i + dr}};
+}
+
+// y1..y3 times w^p, w^2p and w^3p read from tw at offset idx
+inline void fft_apply_twiddles(fft_quad &y, const float *tw, size_t count, size_t idx)
+{
+    for (size_t j = 1; j <= 3; ++j)
+        fft_twiddle(y.re[j], y.im[j], load_fft(tw + (2 * j - 2) * count + idx),
+                    load_fft(tw + (2 * j - 1) * count + idx));
+}
+
+// four vectors of four-value groups [v0 | v1 | v2 | v3] laid out as v0.lo v1.lo v2.lo v3.lo
+// v0.hi v1.hi v2.hi v3.hi
+inline void store_fft_groups(float *dst, const std::array<fft_vector, 4> &v)
+{
+    store_fft(dst, fft_vector(_mm256_permute2f128_ps(v[0].data, v[1].data, 0x20)));
+    store_fft(dst + AVX_SIZE, fft_vector(_mm256_permute2f128_ps(v[2].data, v[3].data, 0x20)));
+    store_fft(dst + 2 * AVX_SIZE, fft_vector(_mm256_permute2f128_ps(v[0].data, v[1].data, 0x31)));
+    store_fft(dst + 3 * AVX_SIZE, fft_vector(_mm256_permute2f128_ps(v[2].data, v[3].data, 0x31)));
+}
+
+// y[q + s (4p + k)] = (butterfly output k of x[q + s p + k quarter]) w^kp
+inline void fft_radix4(const fft_stage &stage, size_t n, const float *xr, const float *xi,
+                       float *yr, float *yi)
+{
+    const size_t quarter = n / 4;
+    const size_t s = stage.stride;
+    const float *tw = stage.twiddles.data();
+    if (s >= AVX_SIZE)
+    {
+        for (size_t p = 0; p < stage.length / 4; ++p)
+        {
+            std::array<fft_vector, 6> w;
+            for (size_t j = 0; j < w.size(); ++j)
+                w[j] = fft_vector(tw[j * stage.count + p]);
+            for (size_t q = 0; q < s; q += AVX_SIZE)
+            {
+                fft_quad y = fft_butterfly(xr, xi, s * p + q, quarter);
+                for (size_t j = 1; j <= 3; ++j)
+                    fft_twiddle(y.re[j], y.im[j], w[2 * j - 2], w[2 * j - 1]);
+                const size_t out = 4 * s * p + q;
+                for (size_t k = 0; k < 4; ++k)
+                {
+                    store_fft(yr + out + k * s, y.re[k]);
+                    store_fft(yi + out + k * s, y.im[k]);
+                }
+            }
+        }
+        return;
+    }
+    // strides 1 and 4: a vector spans several p, so the four outputs of each p are scattered
+    // into one 32-value run with the in-lane 4x4 transpose (stride 1) and 128-bit permutes
+    for (size_t i = 0; i < quarter; i += AVX_SIZE)
+    {
+        fft_quad y = fft_butterfly(xr, xi, i, quarter);
+        fft_apply_twiddles(y, tw, stage.count, i);
+        if (s == 1)
+            fft_vector::transpose(y.re[0], y.re[1], y.re[2], y.re[3], y.im[0], y.im[1], y.im[2],
+                                  y.im[3]);
+        store_fft_groups(yr + 4 * i, y.re);
+        store_fft_groups(yi + 4 * i, y.im);
+    }
+}
+
+// closing length-2 pass, stride n / 2 and no twiddles
+inline void fft_radix2(size_t n, const float *xr, const float *xi, float *yr, float *yi)
+{
+    const size_t half = n / 2;
+    for (size_t q = 0; q < half; q += AVX_SIZE)
+    {
+        const fft_vector ar = load_fft(xr + q);
+        const fft_vector ai = load_fft(xi + q);
+        const fft_vector br = load_fft(xr + q + half);
+        const fft_vector bi = load_fft(xi + q + half);
+        store_fft(yr + q, ar + br);
+        store_fft(yi + q, ai + bi);
+        store_fft(yr + q + half, ar - br);
+        store_fft(yi + q + half, ai - bi);
+    }
+}
+
+// forward transform of the split values in scratch[0, 2n) (re then im); scratch holds 4n
+// floats and the result is left in the half returned, 0 for scratch[0, 2n) and 1 for the rest
+inline size_t fft_execute(const fft_tables &t, float *scratch)
+{
+    const size_t n = t.size;
+    float *x = scratch;
+    float *y = scratch + 2 * n;
+    size_t which = 0;
+    if (t.stages.empty())
+    {
+        for (size_t length = n, s = 1; length >= 2; length /= 2, s *= 2)
+        {
+            const size_t m = length / 2;
+            for (size_t p = 0; p < m; ++p)
+            {
+                const std::complex<float> w = t.roots[p * s];
+                for (size_t q = 0; q < s; ++q)
+                {
+                    const std::complex<float> a(x[q + s * p], x[n + q + s * p]);
+                    const std::complex<float> b(x[q + s * (p + m)], x[n + q + s * (p + m)]);
+                    const std::complex<float> sum = a + b;
+                    const std::complex<float> diff = (a - b) * w;
+                    y[q + 2 * s * p] = sum.real();
+                    y[n + q + 2 * s * p] = sum.imag();
+                    y[q + s * (2 * p + 1)] = diff.real();
+                    y[n + q + s * (2 * p + 1)] = diff.imag();
+                }
+            }
+            std::swap(x, y);
+            which ^= 1;
+        }
+        return which;
+    }
+    for (const fft_stage &stage : t.stages)
+    {
+        if (stage.length == 2)
+            fft_radix2(n, x, x + n, y, y + n);
+        else
+            fft_radix4(stage, n, x, x + n, y, y + n);
+        std::swap(x, y);
+        which ^= 1;
+    }
+    return which;
+}
+
+inline aligned_vector<float> fft_scratch(size_t n)
+{
+    return aligned_vector<float>(4 * n);
+}
+
+// runs body(transform index, scratch) over count transforms split across threads
+template <typename Body>
+inline void fft_for_each(size_t count, size_t n, size_t scratch_floats, size_t threads, Body body)
+{
+    const size_t min_transforms = std::max<size_t>(1, fft_min_chunk / n);
+    parallel_for(count, chunk_count(threads, count, min_transforms),
+                 [&](size_t begin, size_t end, size_t)
+                 {
+                     aligned_vector<float> scratch(scratch_floats);
+                     for (size_t b = begin; b < end; ++b)
+                         body(b, scratch.data());
+                 });
+}
+
+inline size_t batch_count(size_t in, size_t out, size_t in_size, size_t out_size, const char *what)
+{
+    if (in % in_size != 0 || out != in / in_size * out_size)
+        throw std::invalid_argument(what);
+    return in / in_size;
+}
+
+} // namespace detail
+
+// complex single-precision FFT of a fixed power-of-two size. The plan holds the twiddle
+// factors of every pass; transforms run radix-4 Stockham passes (plus one radix-2 pass for odd
+// powers) on split re/im buffers, so no bit reversal is needed. Plans are immutable and can be
+// shared between threads. forward computes X[k] = sum x[j] e^(-2 pi i jk / n), inverse the
+// conjugate transform scaled by 1 / n so that inverse(forward(x)) == x.
+class fft_plan
+{
+  public:
+    explicit fft_plan(size_t size) : tables_(detail::make_fft_tables(size)) {}
+
+    // plan of the given size built on first use and kept for the life of the process
+    static const fft_plan &cached(size_t size)
+    {
+        static std::mutex mutex;
+        static std::map<size_t, std::unique_ptr<fft_plan>> plans;
+        const std::lock_guard lock(mutex);
+        std::unique_ptr<fft_plan> &plan = plans[size];
+        if (!plan)
+            plan = std::make_unique<fft_plan>(size);
+        return *plan;
+    }
+
+    [[nodiscard]] size_t size() const
+    {
+        return tables_.size;
+    }
+
+    void forward(std::span<const std::complex<float>> in, std::span<std::complex<float>> out) const
+    {
+        check(in.size(), out.size());
+        SIMDLIB_PERF_SCOPE("fft_forward", in.size_bytes() + out.size_bytes());
+        aligned_vector<float> scratch = detail::fft_scratch(size());
+        transform(in.data(), out.data(), scratch.data(), false);
+    }
+
+    void inverse(std::span<const std::complex<float>> in, std::span<std::complex<float>> out) const
+    {
+        check(in.size(), out.size());
+        SIMDLIB_PERF_SCOPE("fft_inverse", in.size_bytes() + out.size_bytes());
+        aligned_vector<float> scratch = detail::fft_scratch(size());
+        transform(in.data(), out.data(), scratch.data(), true);
+    }
+
+    void forward(split_complex_view in, split_complex_span out) const
+    {
+        check(detail::split_size(in), detail::split_size(out));
+        SIMDLIB_PERF_SCOPE("fft_forward_split", 4 * size() * sizeof(float));
+        aligned_vector<float> scratch = detail::fft_scratch(size());
+        transform_split(in.re.data(), in.im.data(), out.re.data(), out.im.data(), scratch.data(),
+                        1.0f);
+    }
+
+    // the inverse is the forward transform with re and im swapped on the way in and out
+    void inverse(split_complex_view in, split_complex_span out) const
+    {
+        check(detail::split_size(in), detail::split_size(out));
+        SIMDLIB_PERF_SCOPE("fft_inverse_split", 4 * size() * sizeof(float));
+        aligned_vector<float> scratch = detail::fft_scratch(size());
+        transform_split(in.im.data(), in.re.data(), out.im.data(), out.re.data(), scratch.data(),
+                        1.0f / static_cast<float>(size()));
+    }
+
+    // in and out hold back-to-back transforms of size() values
+    void forward_batch(std::span<const std::complex<float>> in, std::span<std::complex<float>> out,
+                       size_t threads = 1) const
+    {
+        batch(in, out, threads, false);
+    }
+
+    void inverse_batch(std::span<const std::complex<float>> in, std::span<std::complex<float>> out,
+                       size_t threads = 1) const
+    {
+        batch(in, out, threads, true);
+    }
+
+    // low-level entry for other transforms: runs the forward transform on the split values
+    // in scratch[0, 2 size) of a 4 size scratch buffer, see detail::fft_execute
+    size_t execute(float *scratch) const
+    {
+        return detail::fft_execute(tables_, scratch);
+    }
+
+  private:
+    void check(size_t in, size_t out) const
+    {
+        if (in != size() || out != size())
+            throw std::invalid_argument("fft_plan: buffers must hold size() values");
+    }
+
+    void transform(const std::complex<float> *in, std::complex<float> *out, float *scratch,
+                   bool inverse) const
+    {
+        const size_t n = size();
+        float *re = scratch + (inverse ? n : 0);
+        float *im = scratch + (inverse ? 0 : n);
+        detail::deinterleave_floats(reinterpret_cast<const float *>(in), re, im, n);
+        const size_t offset = 2 * n * execute(scratch);
+        detail::interleave_floats(re + offset, im + offset, reinterpret_cast<float *>(out), n,
+                                  inverse ? 1.0f / static_cast<float>(n) : 1.0f);
+    }
+
+    void transform_split(const float *in_re, const float *in_im, float *out_re, float *out_im,
+                         float *scratch, float scale) const
+    {
+        const size_t n = size();
+        std::copy(in_re, in_re + n, scratch);
+        std::copy(in_im, in_im + n, scratch + n);
+        const float *result = scratch + 2 * n * execute(scratch);
+        for (size_t i = 0; i < n; ++i)
+        {
+            out_re[i] = result[i] * scale;
+            out_im[i] = result[n + i] * scale;
+        }
+    }
+
+    void batch(std::span<const std::complex<float>> in, std::span<std::complex<float>> out,
+               size_t threads, bool inverse) const
+    {
+        const size_t n = size();
+        const size_t count = detail::batch_count(in.size(), out.size(), n, n,
+                                                 "fft_plan: batch buffers must hold whole "
+                                                 "transforms of equal count");
+        SIMDLIB_PERF_SCOPE(inverse ? "fft_inverse_batch" : "fft_forward_batch",
+                           in.size_bytes() + out.size_bytes());
+        detail::fft_for_each(count, n, 4 * n, threads,
+                             [&](size_t b, float *scratch)
+                             { transform(&in[b * n], &out[b * n], scratch, inverse); });
+    }
+
+    detail::fft_tables tables_;
+};
+
+namespace detail
+{
+
+// out[k] = p[k] a[k] + conj(p[h - k]) b[k] for k < h, p[h] given as last; the two halves of a
+// real transform packed as one complex transform of h values are split or merged with this
+inline void fft_real_combine(const float *pr, const float *pi, std::complex<float> last,
+                             const float *ar, const float *ai, const float *br, const float *bi,
+                             float *outr, float *outi, size_t h)
+{
+    const auto term = [&](size_t k, std::complex<float> p, std::complex<float> q)
+    {
+        const std::complex<float> r = p * std::complex<float>(ar[k], ai[k]) +
+                                      std::conj(q) * std::complex<float>(br[k], bi[k]);
+        outr[k] = r.real();
+        outi[k] = r.imag();
+    };
+    term(0, {pr[0], pi[0]}, last);
+    const auto reverse = [](const fft_vector &v)
+    { return fft_vector(_mm256_permute_ps(_mm256_permute2f128_ps(v.data, v.data, 1), 0x1B)); };
+    size_t k = 1;
+    for (; k + AVX_SIZE <= h; k += AVX_SIZE)
+    {
+        const fft_vector xr(_mm256_loadu_ps(pr + k));
+        const fft_vector xi(_mm256_loadu_ps(pi + k));
+        // q = conj(p[h - k]), lanes reversed so lane j holds k + j
+        const fft_vector qr = reverse(fft_vector(_mm256_loadu_ps(pr + h - k - (AVX_SIZE - 1))));
+        const fft_vector qi =
+            fft_vector() - reverse(fft_vector(_mm256_loadu_ps(pi + h - k - (AVX_SIZE - 1))));
+        fft_vector rr = xr;
+        fft_vector ri = xi;
+        fft_twiddle(rr, ri, fft_vector(_mm256_loadu_ps(ar + k)),
+                    fft_vector(_mm256_loadu_ps(ai + k)));
+        fft_vector sr = qr;
+        fft_vector si = qi;
+        fft_twiddle(sr, si, fft_vector(_mm256_loadu_ps(br + k)),
+                    fft_vector(_mm256_loadu_ps(bi + k)));
+        _mm256_storeu_ps(outr + k, (rr + sr).data);
+        _mm256_storeu_ps(outi + k, (ri + si).data);
+    }
+    for (; k < h; ++k)
+        term(k, {pr[k], pi[k]}, {pr[h - k], pi[h - k]});
+}
+
+} // namespace detail
+
+// real single-precision FFT of a power-of-two size n >= 2: n real values to the n / 2 + 1
+// non-negative frequencies and back. Runs as one complex transform of n / 2 values, the even
+// samples as real and the odd ones as imaginary parts, followed or preceded by one combine pass.
+class real_fft_plan
+{
+  public:
+    explicit real_fft_plan(size_t size) : complex_(check_size(size) / 2)
+    {
+        const size_t h = size / 2;
+        for (auto *table : {&a_re_, &a_im_, &b_re_, &b_im_})
+            table->resize(h);
+        // a_k = (1 - i w^k) / 2, b_k = (1 + i w^k) / 2 with w = e^(-2 pi i / n)
+        for (size_t k = 0; k < h; ++k)
+        {
+            const double angle = -2.0 * std::numbers::pi * static_cast<double>(k) /
+                                 static_cast<double>(size);
+            const double c = std::cos(angle);
+            const double s = std::sin(angle);
+            a_re_[k] = static_cast<float>(0.5 * (1.0 + s));
+            a_im_[k] = static_cast<float>(-0.5 * c);
+            b_re_[k] = static_cast<float>(0.5 * (1.0 - s));
+            b_im_[k] = static_cast<float>(0.5 * c);
+        }
+        a_conj_im_.resize(h);
+        b_conj_im_.resize(h);
+        for (size_t k = 0; k < h; ++k)
+        {
+            a_conj_im_[k] = -a_im_[k];
+            b_conj_im_[k] = -b_im_[k];
+        }
+    }
+
+    static const real_fft_plan &cached(size_t size)
+    {
+        static std::mutex mutex;
+        static std::map<size_t, std::unique_ptr<real_fft_plan>> plans;
+        const std::lock_guard lock(mutex);
+        std::unique_ptr<real_fft_plan> &plan = plans[size];
+        if (!plan)
+            plan = std::make_unique<real_fft_plan>(size);
+        return *plan;
+    }
+
+    [[nodiscard]] size_t size() const
+    {
+        return 2 * complex_.size();
+    }
+
+    // out receives size() / 2 + 1 values
+    void forward(std::span<const float> in, std::span<std::complex<float>> out) const
+    {
+        check(in.size(), out.size());
+        SIMDLIB_PERF_SCOPE("rfft_forward", in.size_bytes() + out.size_bytes());
+        aligned_vector<float> scratch = detail::fft_scratch(complex_.size());
+        transform_forward(in.data(), out.data(), scratch.data());
+    }
+
+    // in holds size() / 2 + 1 values; the imaginary parts of the first and last are ignored
+    void inverse(std::span<const std::complex<float>> in, std::span<float> out) const
+    {
+        check(out.size(), in.size());
+        SIMDLIB_PERF_SCOPE("rfft_inverse", in.size_bytes() + out.size_bytes());
+        aligned_vector<float> scratch = detail::fft_scratch(complex_.size());
+        transform_inverse(in.data(), out.data(), scratch.data());
+    }
+
+    // back-to-back transforms, size() reals to size() / 2 + 1 complex values each
+    void forward_batch(std::span<const float> in, std::span<std::complex<float>> out,
+                       size_t threads = 1) const
+    {
+        const size_t h = complex_.size();
+        const size_t count = detail::batch_count(in.size(), out.size(), size(), h + 1,
+                                                 "real_fft_plan: batch buffers must hold whole "
+                                                 "transforms of equal count");
+        SIMDLIB_PERF_SCOPE("rfft_forward_batch", in.size_bytes() + out.size_bytes());
+        detail::fft_for_each(count, h, 4 * h, threads,
+                             [&](size_t b, float *scratch)
+                             {
+                                 transform_forward(&in[b * size()], &out[b * (h + 1)], scratch);
+                             });
+    }
+
+    void inverse_batch(std::span<const std::complex<float>> in, std::span<float> out,
+                       size_t threads = 1) const
+    {
+        const size_t h = complex_.size();
+        const size_t count = detail::batch_count(out.size(), in.size(), size(), h + 1,
+                                                 "real_fft_plan: batch buffers must hold whole "
+                                                 "transforms of equal count");
+        SIMDLIB_PERF_SCOPE("rfft_inverse_batch", in.size_bytes() + out.size_bytes());
+        detail::fft_for_each(count, h, 4 * h, threads,
+                             [&](size_t b, float *scratch)
+                             {
+                                 transform_inverse(&in[b * (h + 1)], &out[b * size()], scratch);
+                             });
+    }
+
+  private:
+    static size_t check_size(size_t size)
+    {
+        if (size < 2 || !std::has_single_bit(size))
+            throw std::invalid_argument("real_fft_plan: size must be a power of two of at least 2");
+        return size;
+    }
+
+    void check(size_t reals, size_t complexes) const
+    {
+        if (reals != size() || complexes != complex_.size() + 1)
+            throw std::invalid_argument("real_fft_plan: buffers must hold size() reals and "
+                                        "size() / 2 + 1 complex values");
+    }
+
+    void transform_forward(const float *in, std::complex<float> *out, float *scratch) const
+    {
+        const size_t h = complex_.size();
+        detail::deinterleave_floats(in, scratch, scratch + h, h);
+        const size_t which = complex_.execute(scratch);
+        const float *zr = scratch + 2 * h * which;
+        const float *zi = zr + h;
+        float *xr = scratch + 2 * h * (which ^ 1);
+        float *xi = xr + h;
+        detail::fft_real_combine(zr, zi, {zr[0], zi[0]}, a_re_.data(), a_im_.data(),
+                                 b_re_.data(), b_im_.data(), xr, xi, h);
+        detail::interleave_floats(xr, xi, reinterpret_cast<float *>(out), h);
+        out[h] = {zr[0] - zi[0], 0.0f};
+    }
+
+    // z[k] = x[k] conj(a_k) + conj(x[h - k]) conj(b_k) recovers the packed transform, which is
+    // inverted as forward(swap(z)) swapped
+    void transform_inverse(const std::complex<float> *in, float *out, float *scratch) const
+    {
+        const size_t h = complex_.size();
+        float *xr = scratch + 2 * h;
+        float *xi = xr + h;
+        detail::deinterleave_floats(reinterpret_cast<const float *>(in), xr, xi, h);
+        // the DC and Nyquist bins of a real signal are real; drop any imaginary part a
+        // complex filter left there, since the combine would mix it into every output
+        xi[0] = 0.0f;
+        detail::fft_real_combine(xr, xi, {in[h].real(), 0.0f}, a_re_.data(), a_conj_im_.data(), b_re_.data(),
+                                 b_conj_im_.data(), scratch + h, scratch, h);
+        const size_t offset = 2 * h * complex_.execute(scratch);
+        detail::interleave_floats(scratch + offset + h, scratch + offset, out, h,
+                                  1.0f / static_cast<float>(h));
+    }
+
+    fft_plan complex_;
+    aligned_vector<float> a_re_;
+    aligned_vector<float> a_im_;
+    aligned_vector<float> b_re_;
+    aligned_vector<float> b_im_;
+    aligned_vector<float> a_conj_im_;
+    aligned_vector<float> b_conj_im_;
+};
+
+// one-shot transforms through the cached plans
+
+inline void fft(std::span<const std::complex<float>> in, std::span<std::complex<float>> out)
+{
+    fft_plan::cached(in.size()).forward(in, out);
+}
+
+inline void ifft(std::span<const std::complex<float>> in, std::span<std::complex<float>> out)
+{
+    fft_plan::cached(in.size()).inverse(in, out);
+}
+
+inline void rfft(std::span<const float> in, std::span<std::complex<float>> out)
+{
+    real_fft_plan::cached(in.size()).forward(in, out);
+}
+
+inline void irfft(std::span<const std::complex<float>> in, std::span<float> out)
+{
+    real_fft_plan::cached(out.size()).inverse(in, out);
+}
+
+} // namespace simdlib
@@ -0,0 +1,326 @@
+#pragma once
+
+#include "simd_perf.hpp"
+#include "simd_vector.hpp"
+#include <array>
+#include <bit>
+#include <cmath>
+#include <cstdint>
+#include <span>
+#include <stdexcept>
+
+namespace simdlib
+{
+
+// IEEE binary16 <-> float, round to nearest even; used for tails and when F16C is unavailable
+inline float f16_to_float(uint16_t h)
+{
+    const uint32_t sign = static_cast<uint32_t>(h & 0x8000U) << 16;
+    const uint32_t exponent = (h >> 10) & 0x1FU;
+    const uint32_t mantissa = h & 0x3FFU;
+    if (exponent == 0x1F)
+        return std::bit_cast<float>(sign | 0x7F800000U | (mantissa << 13));
+    if (exponent == 0)
+        return std::copysign(static_cast<float>(mantissa) * 0x1p-24f, sign ? -1.0f : 1.0f);
+    return std::bit_cast<float>(sign | ((exponent + 112) << 23) | (mantissa << 13));
+}
+
+inline uint16_t float_to_f16(float value)
+{
+    const uint32_t x = std::bit_cast<uint32_t>(value);
+    const auto sign = static_cast<uint16_t>((x >> 16) & 0x8000U);
+    uint32_t abs = x & 0x7FFFFFFFU;
+    if (abs >= 0x7F800000U) // inf or NaN, NaNs stay quiet NaNs
+        return static_cast<uint16_t>(
+            sign | 0x7C00U | (abs > 0x7F800000U ? 0x0200U | ((abs >> 13) & 0x3FFU) : 0U));
+    if (abs >= 0x477FF000U) // rounds past the largest finite half
+        return static_cast<uint16_t>(sign | 0x7C00U);
+    if (abs < 0x38800000U) // half subnormal or zero, scaled so one ulp is 1.0
+        return static_cast<uint16_t>(
+            sign | static_cast<uint16_t>(std::nearbyint(std::bit_cast<float>(abs) * 0x1p24f)));
+    abs += 0xC8000FFFU + ((abs >> 13) & 1U); // rebias exponent, round mantissa to nearest even
+    return static_cast<uint16_t>(sign | (abs >> 13));
+}
+
+// bfloat16 is the top half of a float
+inline float bf16_to_float(uint16_t h)
+{
+    return std::bit_cast<float>(static_cast<uint32_t>(h) << 16);
+}
+
+inline uint16_t float_to_bf16(float value)
+{
+    const uint32_t x = std::bit_cast<uint32_t>(value);
+    if ((x & 0x7FFFFFFFU) > 0x7F800000U)
+        return static_cast<uint16_t>((x >> 16) | 0x0040U); // keep NaN a quiet NaN
+    return static_cast<uint16_t>((x + 0x7FFFU + ((x >> 16) & 1U)) >> 16);
+}
+
+// load N half-precision values into a float vector
+template <size_t N> simd_vector<float, N> load_half(const uint16_t *src);
+
+// SSE
+template <> inline simd_vector<float, SSE_SIZE> load_half<SSE_SIZE>(const uint16_t *src)
+{
+#ifdef __F16C__
+    return simd_vector<float, SSE_SIZE>(
+        _mm_cvtph_ps(_mm_loadl_epi64(reinterpret_cast<const __m128i *>(src))));
+#else
+    return simd_vector<float, SSE_SIZE>(f16_to_float(src[0]), f16_to_float(src[1]),
+                                        f16_to_float(src[2]), f16_to_float(src[3]));
+#endif
+}
+
+// AVX
+template <> inline simd_vector<float, AVX_SIZE> load_half<AVX_SIZE>(const uint16_t *src)
+{
+#ifdef __F16C__
+    return simd_vector<float, AVX_SIZE>(
+        _mm256_cvtph_ps(_mm_loadu_si128(reinterpret_cast<const __m128i *>(src))));
+#else
+    return simd_vector<float, AVX_SIZE>(f16_to_float(src[0]), f16_to_float(src[1]),
+                                        f16_to_float(src[2]), f16_to_float(src[3]),
+                                        f16_to_float(src[4]), f16_to_float(src[5]),
+                                        f16_to_float(src[6]), f16_to_float(src[7]));
+#endif
+}
+
+// store a float vector as half precision, rounding to nearest even
+inline void store_half(uint16_t *dst, const simd_vector<float, SSE_SIZE> &vec)
+{
+#ifdef __F16C__
+    _mm_storel_epi64(reinterpret_cast<__m128i *>(dst),
+                     _mm_cvtps_ph(vec.data, _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC));
+#else
+    for (size_t i = 0; i < SSE_SIZE; ++i)
+        dst[i] = float_to_f16(vec[i]);
+#endif
+}
+
+inline void store_half(uint16_t *dst, const simd_vector<float, AVX_SIZE> &vec)
+{
+#ifdef __F16C__
+    _mm_storeu_si128(reinterpret_cast<__m128i *>(dst),
+                     _mm256_cvtps_ph(vec.data, _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC));
+#else
+    for (size_t i = 0; i < AVX_SIZE; ++i)
+        dst[i] = float_to_f16(vec[i]);
+#endif
+}
+
+namespace detail
+{
+
+// widen 4 bf16 values to float by shifting them into the top of each 32-bit lane
+inline __m128 bf16_widen(__m128i packed)
+{
+    return _mm_castsi128_ps(_mm_slli_epi32(_mm_cvtepu16_epi32(packed), 16));
+}
+
+// round 4 floats to bf16 (nearest even), results in the low 16 bits of each 32-bit lane
+inline __m128i bf16_narrow(__m128 vec)
+{
+    const __m128i bits = _mm_castps_si128(vec);
+    const __m128i odd = _mm_and_si128(_mm_srli_epi32(bits, 16), _mm_set1_epi32(1));
+    const __m128i rounded = _mm_srli_epi32(
+        _mm_add_epi32(_mm_add_epi32(bits, _mm_set1_epi32(0x7FFF)), odd), 16);
+    const __m128i quiet_nan = _mm_or_si128(_mm_srli_epi32(bits, 16), _mm_set1_epi32(0x0040));
+    const __m128i is_nan = _mm_castps_si128(_mm_cmpunord_ps(vec, vec));
+    return _mm_blendv_epi8(rounded, quiet_nan, is_nan);
+}
+
+} // namespace detail
+
+// load N bfloat16 values into a float vector
+template <size_t N> simd_vector<float, N> load_bf16(const uint16_t *src);
+
+// SSE
+template <> inline simd_vector<float, SSE_SIZE> load_bf16<SSE_SIZE>(const uint16_t *src)
+{
+    return simd_vector<float, SSE_SIZE>(
+        detail::bf16_widen(_mm_loadl_epi64(reinterpret_cast<const __m128i *>(src))));
+}
+
+// AVX
+template <> inline simd_vector<float, AVX_SIZE> load_bf16<AVX_SIZE>(const uint16_t *src)
+{
+    const __m128i packed = _mm_loadu_si128(reinterpret_cast<const __m128i *>(src));
+#ifdef __AVX2__
+    return simd_vector<float, AVX_SIZE>(
+        _mm256_castsi256_ps(_mm256_slli_epi32(_mm256_cvtepu16_epi32(packed), 16)));
+#else
+    return simd_vector<float, AVX_SIZE>(_mm256_setr_m128(
+        detail::bf16_widen(packed), detail::bf16_widen(_mm_unpackhi_epi64(packed, packed))));
+#endif
+}
+
+// store a float vector as bfloat16, rounding to nearest even
+inline void store_bf16(uint16_t *dst, const simd_vector<float, SSE_SIZE> &vec)
+{
+    const __m128i narrow = detail::bf16_narrow(vec.data);
+    _mm_storel_epi64(reinterpret_cast<__m128i *>(dst), _mm_packus_epi32(narrow, narrow));
+}
+
+inline void store_bf16(uint16_t *dst, const simd_vector<float, AVX_SIZE> &vec)
+{
+    const __m128i lo = detail::bf16_narrow(_mm256_castps256_ps128(vec.data));
+    const __m128i hi = detail::bf16_narrow(_mm256_extractf128_ps(vec.data, 1));
+    _mm_storeu_si128(reinterpret_cast<__m128i *>(dst), _mm_packus_epi32(lo, hi));
+}
+
+namespace detail
+{
+
+inline void check_sizes(size_t src, size_t dst, const char *what)
+{
+    if (src != dst)
+        throw std::invalid_argument(what);
+}
+
+// dot product with one operand stored as 16-bit floats, four accumulators for latency hiding
+template <typename Load, typename Widen>
+inline float dot_mixed(std::span<const uint16_t> a, std::span<const float> b, Load load,
+                       Widen widen)
+{
+    check_sizes(a.size(), b.size(), "dot: operands differ in size");
+    std::array<simd_vector<float, AVX_SIZE>, 4> acc{};
+    const size_t n = a.size();
+    size_t i = 0;
+    for (; i + 4 * AVX_SIZE <= n; i += 4 * AVX_SIZE)
+    {
+        for (size_t k = 0; k < 4; ++k)
+        {
+            const simd_vector<float, AVX_SIZE> vb(_mm256_loadu_ps(b.data() + i + k * AVX_SIZE));
+            acc[k] = load(a.data() + i + k * AVX_SIZE).fmadd(vb, acc[k]);
+        }
+    }
+    for (; i + AVX_SIZE <= n; i += AVX_SIZE)
+    {
+        const simd_vector<float, AVX_SIZE> vb(_mm256_loadu_ps(b.data() + i));
+        acc[0] = load(a.data() + i).fmadd(vb, acc[0]);
+    }
+    float sum = ((acc[0] + acc[1]) + (acc[2] + acc[3])).horizontal_sum();
+    for (; i < n; ++i)
+        sum += widen(a[i]) * b[i];
+    return sum;
+}
+
+template <typename Load, typename Widen>
+inline float l2_squared_mixed(std::span<const uint16_t> a, std::span<const float> b, Load load,
+                              Widen widen)
+{
+    check_sizes(a.size(), b.size(), "l2_squared: operands differ in size");
+    std::array<simd_vector<float, AVX_SIZE>, 4> acc{};
+    const size_t n = a.size();
+    size_t i = 0;
+    for (; i + 4 * AVX_SIZE <= n; i += 4 * AVX_SIZE)
+    {
+        for (size_t k = 0; k < 4; ++k)
+        {
+            const simd_vector<float, AVX_SIZE> vb(_mm256_loadu_ps(b.data() + i + k * AVX_SIZE));
+            const simd_vector<float, AVX_SIZE> diff = load(a.data() + i + k * AVX_SIZE) - vb;
+            acc[k] = diff.fmadd(diff, acc[k]);
+        }
+    }
+    for (; i + AVX_SIZE <= n; i += AVX_SIZE)
+    {
+        const simd_vector<float, AVX_SIZE> diff =
+            load(a.data() + i) - simd_vector<float, AVX_SIZE>(_mm256_loadu_ps(b.data() + i));
+        acc[0] = diff.fmadd(diff, acc[0]);
+    }
+    float sum = ((acc[0] + acc[1]) + (acc[2] + acc[3])).horizontal_sum();
+    for (; i < n; ++i)
+    {
+        const float diff = widen(a[i]) - b[i];
+        sum += diff * diff;
+    }
+    return sum;
+}
+
+} // namespace detail
+
+// bulk half -> float conversion
+inline void f16_to_float(std::span<const uint16_t> src, std::span<float> dst)
+{
+    detail::check_sizes(src.size(), dst.size(), "f16_to_float: buffers differ in size");
+    SIMDLIB_PERF_SCOPE("f16_to_float", src.size_bytes() + dst.size_bytes());
+    size_t i = 0;
+    for (; i + AVX_SIZE <= src.size(); i += AVX_SIZE)
+        _mm256_storeu_ps(dst.data() + i, load_half<AVX_SIZE>(src.data() + i).data);
+    for (; i < src.size(); ++i)
+        dst[i] = f16_to_float(src[i]);
+}
+
+// bulk float -> half conversion
+inline void float_to_f16(std::span<const float> src, std::span<uint16_t> dst)
+{
+    detail::check_sizes(src.size(), dst.size(), "float_to_f16: buffers differ in size");
+    SIMDLIB_PERF_SCOPE("float_to_f16", src.size_bytes() + dst.size_bytes());
+    size_t i = 0;
+    for (; i + AVX_SIZE <= src.size(); i += AVX_SIZE)
+        store_half(dst.data() + i, simd_vector<float, AVX_SIZE>(_mm256_loadu_ps(src.data() + i)));
+    for (; i < src.size(); ++i)
+        dst[i] = float_to_f16(src[i]);
+}
+
+// bulk bfloat16 -> float conversion
+inline void bf16_to_float(std::span<const uint16_t> src, std::span<float> dst)
+{
+    detail::check_sizes(src.size(), dst.size(), "bf16_to_float: buffers differ in size");
+    SIMDLIB_PERF_SCOPE("bf16_to_float", src.size_bytes() + dst.size_bytes());
+    size_t i = 0;
+    for (; i + AVX_SIZE <= src.size(); i += AVX_SIZE)
+        _mm256_storeu_ps(dst.data() + i, load_bf16<AVX_SIZE>(src.data() + i).data);
+    for (; i < src.size(); ++i)
+        dst[i] = bf16_to_float(src[i]);
+}
+
+// bulk float -> bfloat16 conversion
+inline void float_to_bf16(std::span<const float> src, std::span<uint16_t> dst)
+{
+    detail::check_sizes(src.size(), dst.size(), "float_to_bf16: buffers differ in size");
+    SIMDLIB_PERF_SCOPE("float_to_bf16", src.size_bytes() + dst.size_bytes());
+    size_t i = 0;
+    for (; i + AVX_SIZE <= src.size(); i += AVX_SIZE)
+        store_bf16(dst.data() + i, simd_vector<float, AVX_SIZE>(_mm256_loadu_ps(src.data() + i)));
+    for (; i < src.size(); ++i)
+        dst[i] = float_to_bf16(src[i]);
+}
+
+// dot product of half-precision a with float b, accumulated in float
+inline float dot_f16(std::span<const uint16_t> a, std::span<const float> b)
+{
+    SIMDLIB_PERF_SCOPE("dot_f16", a.size_bytes() + b.size_bytes());
+    return detail::dot_mixed(
+        a, b, [](const uint16_t *src) { return load_half<AVX_SIZE>(src); },
+        [](uint16_t h) { return f16_to_float(h); });
+}
+
+// dot product of bfloat16 a with float b, accumulated in float
+inline float dot_bf16(std::span<const uint16_t> a, std::span<const float> b)
+{
+    SIMDLIB_PERF_SCOPE("dot_bf16", a.size_bytes() + b.size_bytes());
+    return detail::dot_mixed(
+        a, b, [](const uint16_t *src) { return load_bf16<AVX_SIZE>(src); },
+        [](uint16_t h) { return bf16_to_float(h); });
+}
+
+// squared euclidean distance between half-precision a and float b
+inline float l2_squared_f16(std::span<const uint16_t> a, std::span<const float> b)
+{
+    SIMDLIB_PERF_SCOPE("l2_squared_f16", a.size_bytes() + b.size_bytes());
+    return detail::l2_squared_mixed(
+        a, b, [](const uint16_t *src) { return load_half<AVX_SIZE>(src); },
+        [](uint16_t h) { return f16_to_float(h); });
+}
+
+// squared euclidean distance between bfloat16 a and float b
+inline float l2_squared_bf16(std::span<const uint16_t> a, std::span<const float> b)
+{
+    SIMDLIB_PERF_SCOPE("l2_squared_bf16", a.size_bytes() + b.size_bytes());
+    return detail::l2_squared_mixed(
+        a, b, [](const uint16_t *src) { return load_bf16<AVX_SIZE>(src); },
+        [](uint16_t h) { return bf16_to_float(h); });
+}
+
+} // namespace simdlib
@@ -0,0 +1,419 @@
+#pragma once
+
+#include "simd_math.hpp"
+#include "simd_parallel.hpp"
+#include "simd_perf.hpp"
+#include "simd_random.hpp"
+#include <immintrin.h>
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <span>
+#include <stdexcept>
+#include <vector>
+
+namespace simdlib
+{
+
+namespace detail
+{
+
+// keys per chunk handed to a worker thread
+constexpr size_t hash_min_chunk = size_t{1} << 16;
+
+// bytes per chunk of blocks handed to a worker thread
+constexpr size_t crc32c_min_chunk = size_t{1} << 20;
+
+inline uint32_t fmix32(uint32_t h)
+{
+    h ^= h >> 16;
+    h *= 0x85EBCA6Bu;
+    h ^= h >> 13;
+    h *= 0xC2B2AE35u;
+    return h ^ (h >> 16);
+}
+
+inline uint64_t fmix64(uint64_t h)
+{
+    h ^= h >> 33;
+    h *= 0xFF51AFD7ED558CCDull;
+    h ^= h >> 33;
+    h *= 0xC4CEB9FE1A85EC53ull;
+    return h ^ (h >> 33);
+}
+
+inline __m256i mullo_epi32(__m256i a, __m256i b)
+{
+#ifdef __AVX2__
+    return _mm256_mullo_epi32(a, b);
+#else
+    return per_half(a, b, [](__m128i x, __m128i y) { return _mm_mullo_epi32(x, y); });
+#endif
+}
+
+template <int Shift> inline __m256i srli_epi64(__m256i a)
+{
+#ifdef __AVX2__
+    return _mm256_srli_epi64(a, Shift);
+#else
+    return per_half(a, a, [](__m128i x, __m128i) { return _mm_srli_epi64(x, Shift); });
+#endif
+}
+
+// low 64 bits of every lane times m, from three 32 x 32 -> 64 bit products
+inline __m256i mullo_epi64(__m256i a, uint64_t m)
+{
+#ifdef __AVX2__
+    const __m256i m_lo = _mm256_set1_epi64x(static_cast<int64_t>(m & 0xFFFFFFFFu));
+    const __m256i m_hi = _mm256_set1_epi64x(static_cast<int64_t>(m >> 32));
+    const __m256i cross = _mm256_add_epi64(_mm256_mul_epu32(_mm256_srli_epi64(a, 32), m_lo),
+                                           _mm256_mul_epu32(a, m_hi));
+    return _mm256_add_epi64(_mm256_mul_epu32(a, m_lo), _mm256_slli_epi64(cross, 32));
+#else
+    const __m128i m_lo = _mm_set1_epi64x(static_cast<int64_t>(m & 0xFFFFFFFFu));
+    const __m128i m_hi = _mm_set1_epi64x(static_cast<int64_t>(m >> 32));
+    return per_half(a, a,
+                    [&](__m128i x, __m128i)
+                    {
+                        const __m128i cross = _mm_add_epi64(
+                            _mm_mul_epu32(_mm_srli_epi64(x, 32), m_lo), _mm_mul_epu32(x, m_hi));
+                        return _mm_add_epi64(_mm_mul_epu32(x, m_lo), _mm_slli_epi64(cross, 32));
+                    });
+#endif
+}
+
+inline __m256i fmix64_x4(__m256i h)
+{
+    h = xor_si256(h, srli_epi64<33>(h));
+    h = mullo_epi64(h, 0xFF51AFD7ED558CCDull);
+    h = xor_si256(h, srli_epi64<33>(h));
+    h = mullo_epi64(h, 0xC4CEB9FE1A85EC53ull);
+    return xor_si256(h, srli_epi64<33>(h));
+}
+
+// low words of keys 0-3 and 4-7 packed in key order
+inline __m256i pack_low_words(__m256i lo, __m256i hi)
+{
+#ifdef __AVX2__
+    const __m256 packed = _mm256_shuffle_ps(_mm256_castsi256_ps(lo), _mm256_castsi256_ps(hi),
+                                            _MM_SHUFFLE(2, 0, 2, 0));
+    return _mm256_permute4x64_epi64(_mm256_castps_si256(packed), _MM_SHUFFLE(3, 1, 2, 0));
+#else
+    const auto pack = [](__m256i v)
+    {
+        return _mm_castps_si128(_mm_shuffle_ps(_mm256_castps256_ps128(_mm256_castsi256_ps(v)),
+                                               _mm256_extractf128_ps(_mm256_castsi256_ps(v), 1),
+                                               _MM_SHUFFLE(2, 0, 2, 0)));
+    };
+    return _mm256_setr_m128i(pack(lo), pack(hi));
+#endif
+}
+
+inline void check_hash_sizes(size_t keys, size_t out)
+{
+    if (keys != out)
+        throw std::invalid_argument("hash: output size does not match the number of keys");
+}
+
+// hashes keys[begin, end) with hash8 on whole vectors and hash1 on the tail
+template <typename Key, typename Hash8, typename Hash1>
+inline void hash_range(const Key *keys, uint32_t *out, size_t begin, size_t end, Hash8 &&hash8,
+                       Hash1 &&hash1)
+{
+    size_t i = begin;
+    for (; i + 2 * AVX_SIZE <= end; i += 2 * AVX_SIZE)
+    {
+        const __m256i h0 = hash8(keys + i);
+        const __m256i h1 = hash8(keys + i + AVX_SIZE);
+        _mm256_storeu_si256(reinterpret_cast<__m256i *>(out + i), h0);
+        _mm256_storeu_si256(reinterpret_cast<__m256i *>(out + i + AVX_SIZE), h1);
+    }
+    for (; i + AVX_SIZE <= end; i += AVX_SIZE)
+        _mm256_storeu_si256(reinterpret_cast<__m256i *>(out + i), hash8(keys + i));
+    for (; i < end; ++i)
+        out[i] = hash1(keys[i]);
+}
+
+template <typename Key, typename Hash8, typename Hash1>
+inline void hash_all(std::span<const Key> keys, std::span<uint32_t> out, size_t threads,
+                     Hash8 &&hash8, Hash1 &&hash1)
+{
+    check_hash_sizes(keys.size(), out.size());
+    parallel_for(keys.size(), chunk_count(threads, keys.size(), hash_min_chunk),
+                 [&](size_t begin, size_t end, size_t)
+                 { hash_range(keys.data(), out.data(), begin, end, hash8, hash1); });
+}
+
+inline __m256i load_keys(const uint32_t *keys)
+{
+    return _mm256_loadu_si256(reinterpret_cast<const __m256i *>(keys));
+}
+
+} // namespace detail
+
+// murmur3's 32-bit finalizer applied to key ^ seed; the scalar twin of hash32_x8
+inline uint32_t hash32(uint32_t key, uint32_t seed = 0)
+{
+    return detail::fmix32(key ^ seed);
+}
+
+// murmur3's 64-bit finalizer applied to key ^ seed, keeping the low 32 bits
+inline uint32_t hash64(uint64_t key, uint64_t seed = 0)
+{
+    return static_cast<uint32_t>(detail::fmix64(key ^ seed));
+}
+
+// bucket in [0, partitions) taken from the high word of hash * partitions; as uniform as
+// hash % partitions but a multiply instead of a division
+inline uint32_t partition_of(uint32_t hash, uint32_t partitions)
+{
+    return static_cast<uint32_t>((uint64_t{hash} * partitions) >> 32);
+}
+
+// eight keys at once, lane k equal to hash32(key k, seed)
+inline __m256i hash32_x8(__m256i keys, uint32_t seed = 0)
+{
+    using namespace detail;
+    __m256i h = xor_si256(keys, _mm256_set1_epi32(static_cast<int>(seed)));
+    h = xor_si256(h, srli_epi32<16>(h));
+    h = mullo_epi32(h, _mm256_set1_epi32(static_cast<int>(0x85EBCA6Bu)));
+    h = xor_si256(h, srli_epi32<13>(h));
+    h = mullo_epi32(h, _mm256_set1_epi32(static_cast<int>(0xC2B2AE35u)));
+    return xor_si256(h, srli_epi32<16>(h));
+}
+
+// eight 64-bit keys, keys 0-3 in lo and 4-7 in hi; lane k equal to hash64(key k, seed)
+inline __m256i hash64_x8(__m256i lo, __m256i hi, uint64_t seed = 0)
+{
+    using namespace detail;
+    const __m256i s = _mm256_set1_epi64x(static_cast<int64_t>(seed));
+    return pack_low_words(fmix64_x4(xor_si256(lo, s)), fmix64_x4(xor_si256(hi, s)));
+}
+
+// partition_of on every lane
+inline __m256i partition_x8(__m256i hashes, uint32_t partitions)
+{
+    __m256i hi, lo;
+    detail::mulhilo_epu32(hashes, partitions, hi, lo);
+    return hi;
+}
+
+// out[i] = hash32(keys[i], seed)
+inline void hash_keys(std::span<const uint32_t> keys, std::span<uint32_t> out, uint32_t seed = 0,
+                      size_t threads = 1)
+{
+    SIMDLIB_PERF_SCOPE("hash_keys", keys.size_bytes() + out.size_bytes());
+    detail::hash_all(
+        keys, out, threads,
+        [seed](const uint32_t *k) { return hash32_x8(detail::load_keys(k), seed); },
+        [seed](uint32_t k) { return hash32(k, seed); });
+}
+
+// out[i] = hash64(keys[i], seed)
+inline void hash_keys(std::span<const uint64_t> keys, std::span<uint32_t> out, uint64_t seed = 0,
+                      size_t threads = 1)
+{
+    SIMDLIB_PERF_SCOPE("hash_keys", keys.size_bytes() + out.size_bytes());
+    detail::hash_all(
+        keys, out, threads,
+        [seed](const uint64_t *k)
+        {
+            const auto *v = reinterpret_cast<const __m256i *>(k);
+            return hash64_x8(_mm256_loadu_si256(v), _mm256_loadu_si256(v + 1), seed);
+        },
+        [seed](uint64_t k) { return hash64(k, seed); });
+}
+
+// out[i] = partition_of(hash32(keys[i], seed), partitions), the partition each key goes to
+inline void partition_keys(std::span<const uint32_t> keys, uint32_t partitions,
+                           std::span<uint32_t> out, uint32_t seed = 0, size_t threads = 1)
+{
+    if (partitions == 0)
+        throw std::invalid_argument("partition_keys: partitions must be positive");
+    SIMDLIB_PERF_SCOPE("partition_keys", keys.size_bytes() + out.size_bytes());
+    detail::hash_all(
+        keys, out, threads,
+        [=](const uint32_t *k)
+        { return partition_x8(hash32_x8(detail::load_keys(k), seed), partitions); },
+        [=](uint32_t k) { return partition_of(hash32(k, seed), partitions); });
+}
+
+// the same for 64-bit keys
+inline void partition_keys(std::span<const uint64_t> keys, uint32_t partitions,
+                           std::span<uint32_t> out, uint64_t seed = 0, size_t threads = 1)
+{
+    if (partitions == 0)
+        throw std::invalid_argument("partition_keys: partitions must be positive");
+    SIMDLIB_PERF_SCOPE("partition_keys", keys.size_bytes() + out.size_bytes());
+    detail::hash_all(
+        keys, out, threads,
+        [=](const uint64_t *k)
+        {
+            const auto *v = reinterpret_cast<const __m256i *>(k);
+            return partition_x8(hash64_x8(_mm256_loadu_si256(v), _mm256_loadu_si256(v + 1), seed),
+                                partitions);
+        },
+        [=](uint64_t k) { return partition_of(hash64(k, seed), partitions); });
+}
+
+namespace detail
+{
+
+// reflected Castagnoli polynomial
+constexpr uint32_t crc32c_polynomial = 0x82F63B78u;
+
+// streams of this many bytes are checksummed side by side, then the shorter ones for what is left
+constexpr size_t crc32c_long_block = 8192;
+constexpr size_t crc32c_short_block = 256;
+
+inline const std::array<uint32_t, 256> &crc32c_table()
+{
+    static const std::array<uint32_t, 256> table = []
+    {
+        std::array<uint32_t, 256> t{};
+        for (uint32_t v = 0; v < 256; ++v)
+        {
+            uint32_t c = v;
+            for (int b = 0; b < 8; ++b)
+                c = (c >> 1) ^ ((c & 1) ? crc32c_polynomial : 0);
+            t[v] = c;
+        }
+        return t;
+    }();
+    return table;
+}
+
+inline uint64_t load_u64(const unsigned char *p)
+{
+    uint64_t v;
+    std::memcpy(&v, p, sizeof(v));
+    return v;
+}
+
+// one stream on the raw register, no pre or post inversion
+inline uint32_t crc32c_serial(uint32_t crc, const unsigned char *p, size_t n)
+{
+#ifdef __SSE4_2__
+    uint64_t c = crc;
+    for (; n >= 8; n -= 8, p += 8)
+        c = _mm_crc32_u64(c, load_u64(p));
+    crc = static_cast<uint32_t>(c);
+    for (; n > 0; --n, ++p)
+        crc = _mm_crc32_u8(crc, *p);
+#else
+    const auto &table = crc32c_table();
+    for (; n > 0; --n, ++p)
+        crc = (crc >> 8) ^ table[(crc ^ *p) & 0xFF];
+#endif
+    return crc;
+}
+
+// advances a register over a fixed run of zero bytes; the step is linear over GF(2), so it is
+// tabulated once per input byte from the images of the 32 single-bit registers
+class crc32c_shift
+{
+  public:
+    explicit crc32c_shift(size_t bytes)
+    {
+        const std::vector<unsigned char> zeros(bytes);
+        std::array<uint32_t, 32> basis{};
+        for (size_t b = 0; b < 32; ++b)
+            basis[b] = crc32c_serial(uint32_t{1} << b, zeros.data(), bytes);
+        for (size_t k = 0; k < 4; ++k)
+        {
+            for (size_t v = 0; v < 256; ++v)
+            {
+                uint32_t image = 0;
+                for (size_t bit = 0; bit < 8; ++bit)
+                {
+                    if ((v >> bit) & 1)
+                        image ^= basis[8 * k + bit];
+                }
+                table_[k][v] = image;
+            }
+        }
+    }
+
+    uint32_t operator()(uint32_t crc) const
+    {
+        return table_[0][crc & 0xFF] ^ table_[1][(crc >> 8) & 0xFF] ^
+               table_[2][(crc >> 16) & 0xFF] ^ table_[3][crc >> 24];
+    }
+
+  private:
+    std::array<std::array<uint32_t, 256>, 4> table_{};
+};
+
+#ifdef __SSE4_2__
+// crc32 has a three-cycle latency but issues every cycle, so three independent streams over
+// consecutive blocks keep it busy; the second and third start from zero and are stitched on by
+// shifting the running register over the block that follows it
+inline uint32_t crc32c_streams(uint32_t crc, const unsigned char *&p, size_t &n, size_t block,
+                               const crc32c_shift &shift)
+{
+    for (; n >= 3 * block; n -= 3 * block, p += 3 * block)
+    {
+        uint64_t c0 = crc, c1 = 0, c2 = 0;
+        for (size_t i = 0; i < block; i += 8)
+        {
+            c0 = _mm_crc32_u64(c0, load_u64(p + i));
+            c1 = _mm_crc32_u64(c1, load_u64(p + block + i));
+            c2 = _mm_crc32_u64(c2, load_u64(p + 2 * block + i));
+        }
+        crc = shift(static_cast<uint32_t>(c0)) ^ static_cast<uint32_t>(c1);
+        crc = shift(crc) ^ static_cast<uint32_t>(c2);
+    }
+    return crc;
+}
+#endif
+
+inline uint32_t crc32c_update(uint32_t crc, const unsigned char *p, size_t n)
+{
+#ifdef __SSE4_2__
+    static const crc32c_shift long_shift(crc32c_long_block);
+    static const crc32c_shift short_shift(crc32c_short_block);
+    crc = crc32c_streams(crc, p, n, crc32c_long_block, long_shift);
+    crc = crc32c_streams(crc, p, n, crc32c_short_block, short_shift);
+#endif
+    return crc32c_serial(crc, p, n);
+}
+
+} // namespace detail
+
+// CRC-32C (Castagnoli) of data; passing an earlier result as crc continues that checksum, so
+// crc32c(b, crc32c(a)) is the checksum of a followed by b
+inline uint32_t crc32c(std::span<const std::byte> data, uint32_t crc = 0)
+{
+    SIMDLIB_PERF_SCOPE("crc32c", data.size_bytes());
+    return ~detail::crc32c_update(~crc, reinterpret_cast<const unsigned char *>(data.data()),
+                                  data.size());
+}
+
+// out[b] = crc32c of bytes [b * block_size, (b + 1) * block_size), the last block possibly
+// short; blocks are spread over threads
+inline void crc32c_blocks(std::span<const std::byte> data, size_t block_size,
+                          std::span<uint32_t> out, size_t threads = 1)
+{
+    if (block_size == 0)
+        throw std::invalid_argument("crc32c_blocks: block size must be positive");
+    const size_t blocks = (data.size() + block_size - 1) / block_size;
+    if (out.size() != blocks)
+        throw std::invalid_argument("crc32c_blocks: output size does not match the block count");
+    SIMDLIB_PERF_SCOPE("crc32c_blocks", data.size_bytes());
+    const auto *base = reinterpret_cast<const unsigned char *>(data.data());
+    const size_t min_blocks = std::max<size_t>(1, detail::crc32c_min_chunk / block_size);
+    parallel_for(blocks, chunk_count(threads, blocks, min_blocks),
+                 [&](size_t begin, size_t end, size_t)
+                 {
+                     for (size_t b = begin; b < end; ++b)
+                     {
+                         const size_t offset = b * block_size;
+                         const size_t n = std::min(block_size, data.size() - offset);
+                         out[b] = ~detail::crc32c_update(~uint32_t{0}, base + offset, n);
+                     }
+                 });
+}
+
+} // namespace simdlib
@@ -0,0 +1,191 @@
+#pragma once
+
+#include "simd_parallel.hpp"
+#include "simd_perf.hpp"
+#include "simd_vector.hpp"
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <limits>
+#include <span>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+namespace simdlib
+{
+
+namespace detail
+{
+
+// up to this many edges a broadcast-and-count scan beats a gathered binary search
+constexpr size_t linear_bucketize_edges = 32;
+
+// values per chunk handed to a worker thread
+constexpr size_t parallel_min_chunk = size_t{1} << 16;
+
+inline uint32_t bucket_of(std::span<const float> edges, float value)
+{
+    return static_cast<uint32_t>(
+        std::partition_point(edges.begin(), edges.end(), [value](float e) { return e <= value; }) -
+        edges.begin());
+}
+
+inline void bucketize_block(const float *values, size_t n, std::span<const float> edges,
+                            uint32_t *out)
+{
+    size_t i = 0;
+    if (edges.size() <= linear_bucketize_edges)
+    {
+        // count the edges each lane has passed, masks turned into 1.0f increments
+        const simd_vector<float, AVX_SIZE> one(1.0f);
+        for (; i + AVX_SIZE <= n; i += AVX_SIZE)
+        {
+            const simd_vector<float, AVX_SIZE> vec(_mm256_loadu_ps(values + i));
+            simd_vector<float, AVX_SIZE> count;
+            for (const float edge : edges)
+            {
+                const simd_vector<float, AVX_SIZE> edge_vec(edge);
+                const simd_vector<float, AVX_SIZE> passed = edge_vec <= vec;
+                count += simd_vector<float, AVX_SIZE>(_mm256_and_ps(passed.data, one.data));
+            }
+            _mm256_storeu_si256(reinterpret_cast<__m256i *>(out + i),
+                                _mm256_cvttps_epi32(count.data));
+        }
+    }
+#ifdef __AVX2__
+    else
+    {
+        // branchless upper bound, every lane takes the same number of halving steps
+        for (; i + AVX_SIZE <= n; i += AVX_SIZE)
+        {
+            const simd_vector<float, AVX_SIZE> vec(_mm256_loadu_ps(values + i));
+            __m256i base = _mm256_setzero_si256();
+            for (size_t len = edges.size(); len > 1;)
+            {
+                const size_t half = len / 2;
+                const __m256i probe_idx =
+                    _mm256_add_epi32(base, _mm256_set1_epi32(static_cast<int>(half)));
+                const simd_vector<float, AVX_SIZE> probe(
+                    _mm256_i32gather_ps(edges.data(), probe_idx, sizeof(float)));
+                const simd_vector<float, AVX_SIZE> passed = probe <= vec;
+                base = _mm256_blendv_epi8(base, probe_idx, _mm256_castps_si256(passed.data));
+                len -= half;
+            }
+            const simd_vector<float, AVX_SIZE> last(
+                _mm256_i32gather_ps(edges.data(), base, sizeof(float)));
+            const simd_vector<float, AVX_SIZE> passed = last <= vec;
+            base = _mm256_sub_epi32(base, _mm256_castps_si256(passed.data)); // mask is -1
+            _mm256_storeu_si256(reinterpret_cast<__m256i *>(out + i), base);
+        }
+    }
+#endif
+    for (; i < n; ++i)
+        out[i] = bucket_of(edges, values[i]);
+}
+
+// adds the counts of one range into hist; bins past the last are the reject bin
+inline void histogram_block(const float *values, size_t n, size_t bins, float lo, float hi,
+                            std::span<uint64_t> hist)
+{
+    const size_t stride = bins + 1;
+    const float scale = static_cast<float>(bins) / (hi - lo);
+    const auto last_bin = static_cast<float>(bins - 1);
+
+    // one sub-histogram per lane so repeated bins never chain stores through the same counter
+    std::vector<uint32_t> lanes(AVX_SIZE * stride);
+    const simd_vector<float, AVX_SIZE> lo_vec(lo);
+    const simd_vector<float, AVX_SIZE> hi_vec(hi);
+    const simd_vector<float, AVX_SIZE> scale_vec(scale);
+    const simd_vector<float, AVX_SIZE> last_vec(last_bin);
+    const simd_vector<float, AVX_SIZE> reject_vec(static_cast<float>(bins));
+    alignas(AVX_ALIGNMENT) std::array<int32_t, AVX_SIZE> idx{};
+
+    // per-lane uint32 counters are flushed before they could wrap
+    constexpr size_t flush_interval = size_t{1} << 32;
+    for (size_t block = 0; block < n; block += flush_interval)
+    {
+        const size_t block_end = std::min(n, block + flush_interval);
+        size_t i = block;
+        for (; i + AVX_SIZE <= block_end; i += AVX_SIZE)
+        {
+            const simd_vector<float, AVX_SIZE> vec(_mm256_loadu_ps(values + i));
+            const simd_vector<float, AVX_SIZE> in_range(
+                _mm256_and_ps((vec >= lo_vec).data, (vec <= hi_vec).data));
+            const simd_vector<float, AVX_SIZE> pos((vec - lo_vec) * scale_vec);
+            const __m256 bin = _mm256_blendv_ps(
+                reject_vec.data, _mm256_min_ps(pos.data, last_vec.data), in_range.data);
+            _mm256_store_si256(reinterpret_cast<__m256i *>(idx.data()), _mm256_cvttps_epi32(bin));
+            for (size_t lane = 0; lane < AVX_SIZE; ++lane)
+                ++lanes[lane * stride + static_cast<size_t>(idx[lane])];
+        }
+        for (; i < block_end; ++i)
+        {
+            const float v = values[i];
+            if (v >= lo && v <= hi)
+            {
+                // last_bin first so a NaN position, 0 * inf when scale overflows, gives the
+                // last bin as _mm256_min_ps does above rather than an undefined conversion
+                ++lanes[static_cast<size_t>(std::min(last_bin, (v - lo) * scale))];
+            }
+        }
+
+        for (size_t lane = 0; lane < AVX_SIZE; ++lane)
+        {
+            for (size_t b = 0; b < bins; ++b)
+                hist[b] += lanes[lane * stride + b];
+        }
+        std::fill(lanes.begin(), lanes.end(), 0);
+    }
+}
+
+} // namespace detail
+
+// bucket index of each value: the number of edges <= value (edges sorted ascending, NaN -> 0)
+inline void bucketize(std::span<const float> values, std::span<const float> edges,
+                      std::span<uint32_t> out, size_t threads = 1)
+{
+    if (out.size() != values.size())
+        throw std::invalid_argument("bucketize: output size differs from input size");
+    if (edges.size() > static_cast<size_t>(std::numeric_limits<int32_t>::max()))
+        throw std::invalid_argument("bucketize: too many edges");
+    SIMDLIB_PERF_SCOPE("bucketize", values.size_bytes() + out.size_bytes());
+
+    parallel_for(values.size(), chunk_count(threads, values.size(), detail::parallel_min_chunk),
+                 [&](size_t begin, size_t end, size_t)
+                 {
+                     detail::bucketize_block(values.data() + begin, end - begin, edges,
+                                             out.data() + begin);
+                 });
+}
+
+// counts of values in `bins` equal-width bins over [lo, hi], hi falls in the last bin;
+// out-of-range and NaN values are not counted
+inline std::vector<uint64_t> histogram(std::span<const float> values, size_t bins, float lo,
+                                       float hi, size_t threads = 1)
+{
+    if (bins == 0 || bins > (size_t{1} << 24))
+        throw std::invalid_argument("histogram: bin count must be in [1, 2^24]");
+    if (!(lo < hi))
+        throw std::invalid_argument("histogram: lo must be less than hi");
+    SIMDLIB_PERF_SCOPE("histogram", values.size_bytes());
+
+    const size_t chunks = chunk_count(threads, values.size(), detail::parallel_min_chunk);
+    std::vector<std::vector<uint64_t>> partial(chunks, std::vector<uint64_t>(bins));
+    parallel_for(values.size(), chunks,
+                 [&](size_t begin, size_t end, size_t chunk)
+                 {
+                     detail::histogram_block(values.data() + begin, end - begin, bins, lo, hi,
+                                             partial[chunk]);
+                 });
+
+    std::vector<uint64_t> hist = std::move(partial[0]);
+    for (size_t chunk = 1; chunk < chunks; ++chunk)
+    {
+        for (size_t b = 0; b < bins; ++b)
+            hist[b] += partial[chunk][b];
+    }
+    return hist;
+}
+
+} // namespace simdlib
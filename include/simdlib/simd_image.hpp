@@ -0,0 +1,253 @@
+#pragma once
+
+#include "simd_parallel.hpp"
+#include "simd_perf.hpp"
+#include "simd_vector.hpp"
+#include <immintrin.h>
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <span>
+#include <stdexcept>
+
+namespace simdlib
+{
+
+// planar = (byte * scale - mean) / stddev for each channel in R, G, B, A order; the defaults
+// map bytes onto [0, 1]
+struct pixel_normalization
+{
+    std::array<float, 4> mean{0.0f, 0.0f, 0.0f, 0.0f};
+    std::array<float, 4> stddev{1.0f, 1.0f, 1.0f, 1.0f};
+    float scale = 1.0f / 255.0f;
+};
+
+namespace detail
+{
+
+// pixels per chunk handed to a worker thread
+constexpr size_t pixel_min_chunk = size_t{1} << 14;
+
+using pixel_channels = std::array<simd_vector<float, AVX_SIZE>, 4>;
+
+// x * mul + add per channel, the normalization or its inverse folded into one FMA
+struct channel_affine
+{
+    pixel_channels mul;
+    pixel_channels add;
+
+    simd_vector<float, AVX_SIZE> operator()(size_t c, const simd_vector<float, AVX_SIZE> &x) const
+    {
+        return x.fmadd(mul[c], add[c]);
+    }
+};
+
+inline channel_affine forward_affine(const pixel_normalization &norm)
+{
+    channel_affine f;
+    for (size_t c = 0; c < 4; ++c)
+    {
+        if (norm.stddev[c] == 0.0f)
+            throw std::invalid_argument("pixel_normalization: stddev must be non-zero");
+        f.mul[c] = simd_vector<float, AVX_SIZE>(norm.scale / norm.stddev[c]);
+        f.add[c] = simd_vector<float, AVX_SIZE>(-norm.mean[c] / norm.stddev[c]);
+    }
+    return f;
+}
+
+inline channel_affine inverse_affine(const pixel_normalization &norm)
+{
+    if (norm.scale == 0.0f)
+        throw std::invalid_argument("pixel_normalization: scale must be non-zero");
+    channel_affine f;
+    for (size_t c = 0; c < 4; ++c)
+    {
+        f.mul[c] = simd_vector<float, AVX_SIZE>(norm.stddev[c] / norm.scale);
+        f.add[c] = simd_vector<float, AVX_SIZE>(norm.mean[c] / norm.scale);
+    }
+    return f;
+}
+
+// number of planes, 3 or 4, that planar holds for the pixels in rgba
+inline size_t pixel_planes(size_t rgba, size_t planar)
+{
+    if (rgba % 4 != 0)
+        throw std::invalid_argument("rgba8: size is not a whole number of pixels");
+    const size_t pixels = rgba / 4;
+    if (planar == 4 * pixels)
+        return 4;
+    if (planar == 3 * pixels)
+        return 3;
+    throw std::invalid_argument("rgba8: planar size must be 3 or 4 planes of the pixel count");
+}
+
+// transposes each group of four pixels' bytes into four bytes per channel, and back
+inline __m128i transpose_pixels(__m128i v)
+{
+    return _mm_shuffle_epi8(v,
+                            _mm_setr_epi8(0, 4, 8, 12, 1, 5, 9, 13, 2, 6, 10, 14, 3, 7, 11, 15));
+}
+
+#ifdef __AVX2__
+// the same shuffle on both 128-bit lanes
+inline __m256i transpose_pixels_mask()
+{
+    return _mm256_setr_epi8(0, 4, 8, 12, 1, 5, 9, 13, 2, 6, 10, 14, 3, 7, 11, 15, 0, 4, 8, 12, 1,
+                            5, 9, 13, 2, 6, 10, 14, 3, 7, 11, 15);
+}
+#endif
+
+// eight RGBA pixels widened to one float vector per channel
+inline pixel_channels unpack_rgba8(const uint8_t *src)
+{
+#ifdef __AVX2__
+    // channels grouped within each 128-bit lane, then the dwords across lanes, which leaves
+    // R, G, B and A as eight consecutive bytes each
+    const __m256i bytes = _mm256_permutevar8x32_epi32(
+        _mm256_shuffle_epi8(_mm256_loadu_si256(reinterpret_cast<const __m256i *>(src)),
+                            transpose_pixels_mask()),
+        _mm256_setr_epi32(0, 4, 1, 5, 2, 6, 3, 7));
+    const __m128i rg = _mm256_castsi256_si128(bytes);
+    const __m128i ba = _mm256_extracti128_si256(bytes, 1);
+    const auto widen = [](__m128i b)
+    { return simd_vector<float, AVX_SIZE>(_mm256_cvtepi32_ps(_mm256_cvtepu8_epi32(b))); };
+    return {widen(rg), widen(_mm_unpackhi_epi64(rg, rg)), widen(ba),
+            widen(_mm_unpackhi_epi64(ba, ba))};
+#else
+    const __m128i lo = transpose_pixels(_mm_loadu_si128(reinterpret_cast<const __m128i *>(src)));
+    const __m128i hi =
+        transpose_pixels(_mm_loadu_si128(reinterpret_cast<const __m128i *>(src + 16)));
+    const auto widen = [](__m128i l, __m128i h)
+    {
+        return simd_vector<float, AVX_SIZE>(_mm256_cvtepi32_ps(
+            _mm256_setr_m128i(_mm_cvtepu8_epi32(l), _mm_cvtepu8_epi32(h))));
+    };
+    return {widen(lo, hi), widen(_mm_srli_si128(lo, 4), _mm_srli_si128(hi, 4)),
+            widen(_mm_srli_si128(lo, 8), _mm_srli_si128(hi, 8)),
+            widen(_mm_srli_si128(lo, 12), _mm_srli_si128(hi, 12))};
+#endif
+}
+
+// eight pixels from channel vectors, rounded to nearest and saturated to [0, 255]
+inline void pack_rgba8(const pixel_channels &channels, uint8_t *dst)
+{
+    // max first so NaN lands on zero
+    const __m256 lo = _mm256_setzero_ps();
+    const __m256 hi = _mm256_set1_ps(255.0f);
+    __m256i ints[4];
+    for (size_t c = 0; c < 4; ++c)
+        ints[c] = _mm256_cvtps_epi32(_mm256_min_ps(_mm256_max_ps(channels[c].data, lo), hi));
+#ifdef __AVX2__
+    // each 128-bit lane then holds four pixels as R, G, B, A byte groups
+    const __m256i planes = _mm256_packus_epi16(_mm256_packs_epi32(ints[0], ints[1]),
+                                               _mm256_packs_epi32(ints[2], ints[3]));
+    _mm256_storeu_si256(reinterpret_cast<__m256i *>(dst),
+                        _mm256_shuffle_epi8(planes, transpose_pixels_mask()));
+#else
+    const auto half = [&ints](auto extract)
+    {
+        return transpose_pixels(
+            _mm_packus_epi16(_mm_packs_epi32(extract(ints[0]), extract(ints[1])),
+                             _mm_packs_epi32(extract(ints[2]), extract(ints[3]))));
+    };
+    _mm_storeu_si128(reinterpret_cast<__m128i *>(dst),
+                     half([](__m256i v) { return _mm256_castsi256_si128(v); }));
+    _mm_storeu_si128(reinterpret_cast<__m128i *>(dst + 16),
+                     half([](__m256i v) { return _mm256_extractf128_si256(v, 1); }));
+#endif
+}
+
+inline void rgba8_to_planar_range(const uint8_t *src, float *dst, size_t pixels, size_t planes,
+                                  const channel_affine &f, size_t begin, size_t end)
+{
+    size_t i = begin;
+    for (; i + AVX_SIZE <= end; i += AVX_SIZE)
+    {
+        const pixel_channels channels = unpack_rgba8(src + 4 * i);
+        for (size_t c = 0; c < planes; ++c)
+            _mm256_storeu_ps(dst + c * pixels + i, f(c, channels[c]).data);
+    }
+    if (i < end)
+    {
+        // the tail goes through the vector path so it rounds like the body
+        std::array<uint8_t, 4 * AVX_SIZE> tail{};
+        std::copy(src + 4 * i, src + 4 * end, tail.begin());
+        const pixel_channels channels = unpack_rgba8(tail.data());
+        for (size_t c = 0; c < planes; ++c)
+        {
+            alignas(AVX_ALIGNMENT) std::array<float, AVX_SIZE> values{};
+            _mm256_store_ps(values.data(), f(c, channels[c]).data);
+            std::copy(values.begin(), values.begin() + static_cast<std::ptrdiff_t>(end - i),
+                      dst + c * pixels + i);
+        }
+    }
+}
+
+inline void planar_to_rgba8_range(const float *src, uint8_t *dst, size_t pixels, size_t planes,
+                                  const channel_affine &f, size_t begin, size_t end)
+{
+    // without an alpha plane the pixels come out opaque
+    pixel_channels channels;
+    channels[3] = simd_vector<float, AVX_SIZE>(255.0f);
+    size_t i = begin;
+    for (; i + AVX_SIZE <= end; i += AVX_SIZE)
+    {
+        for (size_t c = 0; c < planes; ++c)
+        {
+            const simd_vector<float, AVX_SIZE> x(_mm256_loadu_ps(src + c * pixels + i));
+            channels[c] = f(c, x);
+        }
+        pack_rgba8(channels, dst + 4 * i);
+    }
+    if (i < end)
+    {
+        const auto n = static_cast<std::ptrdiff_t>(end - i);
+        for (size_t c = 0; c < planes; ++c)
+        {
+            alignas(AVX_ALIGNMENT) std::array<float, AVX_SIZE> values{};
+            std::copy(src + c * pixels + i, src + c * pixels + end, values.begin());
+            channels[c] = f(c, simd_vector<float, AVX_SIZE>(_mm256_load_ps(values.data())));
+        }
+        std::array<uint8_t, 4 * AVX_SIZE> tail{};
+        pack_rgba8(channels, tail.data());
+        std::copy(tail.begin(), tail.begin() + 4 * n, dst + 4 * i);
+    }
+}
+
+} // namespace detail
+
+// interleaved RGBA8 pixels to planar floats laid out [planes][pixels], normalized per channel in
+// the same pass; planar holds 4 planes, or 3 to drop alpha
+inline void rgba8_to_planar(std::span<const uint8_t> rgba, std::span<float> planar,
+                            const pixel_normalization &norm = {}, size_t threads = 1)
+{
+    const size_t planes = detail::pixel_planes(rgba.size(), planar.size());
+    const detail::channel_affine f = detail::forward_affine(norm);
+    SIMDLIB_PERF_SCOPE("rgba8_to_planar", rgba.size_bytes() + planar.size_bytes());
+    const size_t pixels = rgba.size() / 4;
+    parallel_for(pixels, chunk_count(threads, pixels, detail::pixel_min_chunk),
+                 [&](size_t begin, size_t end, size_t)
+                 {
+                     detail::rgba8_to_planar_range(rgba.data(), planar.data(), pixels, planes, f,
+                                                   begin, end);
+                 });
+}
+
+// the inverse: planar floats denormalized, rounded to nearest and saturated to RGBA8; with 3
+// planes alpha is set to 255
+inline void planar_to_rgba8(std::span<const float> planar, std::span<uint8_t> rgba,
+                            const pixel_normalization &norm = {}, size_t threads = 1)
+{
+    const size_t planes = detail::pixel_planes(rgba.size(), planar.size());
+    const detail::channel_affine f = detail::inverse_affine(norm);
+    SIMDLIB_PERF_SCOPE("planar_to_rgba8", rgba.size_bytes() + planar.size_bytes());
+    const size_t pixels = rgba.size() / 4;
+    parallel_for(pixels, chunk_count(threads, pixels, detail::pixel_min_chunk),
+                 [&](size_t begin, size_t end, size_t)
+                 {
+                     detail::planar_to_rgba8_range(planar.data(), rgba.data(), pixels, planes, f,
+                                                   begin, end);
+                 });
+}
+
+} // namespace simdlib
@@ -0,0 +1,380 @@
+#pragma once
+
+#include "simd_allocator.hpp"
+#include "simd_parallel.hpp"
+#include "simd_perf.hpp"
+#include "simd_vector.hpp"
+#include <immintrin.h>
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <span>
+#include <stdexcept>
+
+namespace simdlib
+{
+
+// a piecewise-linear function through (knot, value) pairs: knots strictly increasing, or evenly
+// spaced over [lo, hi]. Inputs outside the knots take the end values, NaN stays NaN.
+class interp_table
+{
+  public:
+    interp_table(std::span<const float> knots, std::span<const float> values)
+        : uniform_(false)
+    {
+        if (knots.size() != values.size())
+            throw std::invalid_argument("interp_table: knots and values differ in size");
+        check_values(values);
+        for (size_t k = 0; k < knots.size(); ++k)
+        {
+            if (!std::isfinite(knots[k]) || (k > 0 && !(knots[k - 1] < knots[k])))
+                throw std::invalid_argument("interp_table: knots must be finite and increasing");
+        }
+        knots_.assign(knots.begin(), knots.end());
+        values_.assign(values.begin(), values.end());
+        slopes_.resize(values.size());
+        for (size_t k = 0; k < segments(); ++k)
+            slopes_[k] = (values[k + 1] - values[k]) / (knots[k + 1] - knots[k]);
+    }
+
+    // values sampled at lo, lo + step, ..., hi
+    interp_table(float lo, float hi, std::span<const float> values) : uniform_(true)
+    {
+        if (!std::isfinite(lo) || !std::isfinite(hi) || !(lo < hi))
+            throw std::invalid_argument("interp_table: lo and hi must be finite with lo < hi");
+        check_values(values);
+        values_.assign(values.begin(), values.end());
+        const auto steps = static_cast<float>(values.size() - 1);
+        knots_.resize(values.size());
+        for (size_t k = 0; k < knots_.size(); ++k)
+            knots_[k] = lo + (hi - lo) * (static_cast<float>(k) / steps);
+        knots_.back() = hi;
+        // uniform slopes are per step, the segment offset is the fraction of a step
+        slopes_.resize(values.size());
+        for (size_t k = 0; k < segments(); ++k)
+            slopes_[k] = values[k + 1] - values[k];
+        inv_step_ = steps / (hi - lo);
+    }
+
+    [[nodiscard]] bool uniform() const
+    {
+        return uniform_;
+    }
+
+    [[nodiscard]] size_t segments() const
+    {
+        return values_.size() - 1;
+    }
+
+    [[nodiscard]] std::span<const float> knots() const
+    {
+        return knots_;
+    }
+
+    [[nodiscard]] std::span<const float> values() const
+    {
+        return values_;
+    }
+
+    // rise per unit x, or per step of a uniform table, from each knot to the next; the last knot
+    // gets a zero slope so inputs at or past it come out as exactly the last value
+    [[nodiscard]] std::span<const float> slopes() const
+    {
+        return slopes_;
+    }
+
+    // steps per unit x of a uniform table
+    [[nodiscard]] float inv_step() const
+    {
+        return inv_step_;
+    }
+
+    float operator()(float x) const
+    {
+        if (std::isnan(x))
+            return x;
+        if (uniform_)
+        {
+            const float t =
+                std::clamp((x - knots_.front()) * inv_step_, 0.0f, static_cast<float>(segments()));
+            const size_t k = std::min(static_cast<size_t>(t), segments());
+            return values_[k] + (t - static_cast<float>(k)) * slopes_[k];
+        }
+        x = std::clamp(x, knots_.front(), knots_.back());
+        const size_t k =
+            static_cast<size_t>(std::upper_bound(knots_.begin() + 1, knots_.end(), x) -
+                                knots_.begin()) - 1;
+        return values_[k] + (x - knots_[k]) * slopes_[k];
+    }
+
+  private:
+    static void check_values(std::span<const float> values)
+    {
+        if (values.size() < 2)
+            throw std::invalid_argument("interp_table: at least two values are needed");
+        if (values.size() > static_cast<size_t>(std::numeric_limits<int32_t>::max()))
+            throw std::invalid_argument("interp_table: too many values for 32-bit indices");
+    }
+
+    aligned_vector<float> knots_;
+    aligned_vector<float> values_;
+    aligned_vector<float> slopes_;
+    float inv_step_ = 0.0f;
+    bool uniform_;
+};
+
+namespace detail
+{
+
+// values per chunk handed to a worker thread
+constexpr size_t interp_min_chunk = size_t{1} << 14;
+
+// up to this many knots counting the passed knots beats a halving search
+constexpr size_t interp_count_knots = 64;
+
+#ifdef __AVX2__
+// table[idx] per lane for tables of up to eight entries held in one register
+struct permute_lookup
+{
+    __m256 table;
+
+    explicit permute_lookup(std::span<const float> t)
+    {
+        alignas(AVX_ALIGNMENT) std::array<float, AVX_SIZE> padded{};
+        std::copy(t.begin(), t.end(), padded.begin());
+        table = _mm256_load_ps(padded.data());
+    }
+
+    __m256 operator()(__m256i idx) const
+    {
+        return _mm256_permutevar8x32_ps(table, idx);
+    }
+};
+
+// up to sixteen entries in two registers, bit 3 of the index picks the register
+struct permute2_lookup
+{
+    __m256 lo;
+    __m256 hi;
+
+    explicit permute2_lookup(std::span<const float> t)
+    {
+        alignas(AVX_ALIGNMENT) std::array<float, 2 * AVX_SIZE> padded{};
+        std::copy(t.begin(), t.end(), padded.begin());
+        lo = _mm256_load_ps(padded.data());
+        hi = _mm256_load_ps(padded.data() + AVX_SIZE);
+    }
+
+    __m256 operator()(__m256i idx) const
+    {
+        return _mm256_blendv_ps(_mm256_permutevar8x32_ps(lo, idx),
+                                _mm256_permutevar8x32_ps(hi, idx),
+                                _mm256_castsi256_ps(_mm256_slli_epi32(idx, 28)));
+    }
+};
+
+struct gather_lookup
+{
+    const float *table;
+
+    explicit gather_lookup(std::span<const float> t) : table(t.data())
+    {
+    }
+
+    __m256 operator()(__m256i idx) const
+    {
+        return _mm256_i32gather_ps(table, idx, sizeof(float));
+    }
+};
+
+// the last knot at or below x in each lane, from base and len candidates left in every lane, by
+// a branchless halving search that takes the same steps in every lane
+template <typename Lookup>
+inline __m256i search_knots(const Lookup &knots, __m256 x, __m256i base, size_t len)
+{
+    while (len > 1)
+    {
+        const size_t half = len / 2;
+        const __m256i probe = _mm256_add_epi32(base, _mm256_set1_epi32(static_cast<int>(half)));
+        const __m256 passed = _mm256_cmp_ps(knots(probe), x, _CMP_LE_OQ);
+        base = _mm256_castps_si256(
+            _mm256_blendv_ps(_mm256_castsi256_ps(base), _mm256_castsi256_ps(probe), passed));
+        len -= half;
+    }
+    return base;
+}
+
+// x clamped to [lo, hi], constants first so NaN passes through
+inline simd_vector<float, AVX_SIZE> clamp_lanes(__m256 x, __m256 lo, __m256 hi)
+{
+    return simd_vector<float, AVX_SIZE>(_mm256_min_ps(hi, _mm256_max_ps(lo, x)));
+}
+
+// one FMA from knot k: value + (x - knot) * slope
+template <typename Lookup>
+inline __m256 lerp_from(const Lookup &knots, const Lookup &values, const Lookup &slopes,
+                        const simd_vector<float, AVX_SIZE> &x, __m256i k)
+{
+    const simd_vector<float, AVX_SIZE> offset = x - simd_vector<float, AVX_SIZE>(knots(k));
+    return offset
+        .fmadd(simd_vector<float, AVX_SIZE>(slopes(k)), simd_vector<float, AVX_SIZE>(values(k)))
+        .data;
+}
+
+// eight lanes of a uniform table: the position in steps gives the knot and the fraction. The
+// position is (x - lo) * inv_step as in operator(); folding lo into an fma offset would round
+// -lo * inv_step and cancel away the fraction when |lo| is large next to hi - lo
+template <typename Lookup>
+inline __m256 interp_uniform8(const Lookup &values, const Lookup &slopes, __m256 x,
+                              const simd_vector<float, AVX_SIZE> &inv_step,
+                              const simd_vector<float, AVX_SIZE> &lo, __m256 top, __m256i last)
+{
+    const simd_vector<float, AVX_SIZE> pos = (simd_vector<float, AVX_SIZE>(x) - lo) * inv_step;
+    const simd_vector<float, AVX_SIZE> t = clamp_lanes(pos.data, _mm256_setzero_ps(), top);
+    // NaN converts to 0x80000000, which the unsigned min sends to the last knot
+    const __m256i k = _mm256_min_epu32(_mm256_cvttps_epi32(t.data), last);
+    const simd_vector<float, AVX_SIZE> frac =
+        t - simd_vector<float, AVX_SIZE>(_mm256_cvtepi32_ps(k));
+    return frac
+        .fmadd(simd_vector<float, AVX_SIZE>(slopes(k)), simd_vector<float, AVX_SIZE>(values(k)))
+        .data;
+}
+
+// runs eval over [begin, end) eight lanes at a time, the tail padded through the same path
+template <typename Eval>
+inline void interp_lanes(const float *xs, float *out, size_t begin, size_t end, Eval eval)
+{
+    size_t i = begin;
+    for (; i + AVX_SIZE <= end; i += AVX_SIZE)
+        _mm256_storeu_ps(out + i, eval(_mm256_loadu_ps(xs + i)));
+    if (i < end)
+    {
+        alignas(AVX_ALIGNMENT) std::array<float, AVX_SIZE> lanes{};
+        std::copy(xs + i, xs + end, lanes.begin());
+        _mm256_store_ps(lanes.data(), eval(_mm256_load_ps(lanes.data())));
+        std::copy(lanes.begin(), lanes.begin() + static_cast<std::ptrdiff_t>(end - i), out + i);
+    }
+}
+
+template <typename Lookup>
+inline void interp_uniform_range(const interp_table &table, const float *xs, float *out,
+                                 size_t begin, size_t end)
+{
+    const Lookup values(table.values());
+    const Lookup slopes(table.slopes());
+    const simd_vector<float, AVX_SIZE> inv_step(table.inv_step());
+    const simd_vector<float, AVX_SIZE> lo(table.knots().front());
+    const __m256 top = _mm256_set1_ps(static_cast<float>(table.segments()));
+    const __m256i last = _mm256_set1_epi32(static_cast<int>(table.segments()));
+    interp_lanes(xs, out, begin, end,
+                 [&](__m256 x)
+                 { return interp_uniform8(values, slopes, x, inv_step, lo, top, last); });
+}
+
+// the knots each lane has passed counted with broadcast compares, which are independent of each
+// other where the halving steps form a chain. A non-zero Slots fixes the trip count so the loop
+// unrolls, the slots past the table holding +inf that no lane passes.
+template <typename Lookup, size_t Slots>
+inline void interp_count_range(const interp_table &table, const float *xs, float *out,
+                               size_t begin, size_t end)
+{
+    const auto knots = table.knots();
+    const Lookup knot_lookup(knots);
+    const Lookup values(table.values());
+    const Lookup slopes(table.slopes());
+    const __m256 lo = _mm256_set1_ps(knots.front());
+    const __m256 hi = _mm256_set1_ps(knots.back());
+    const size_t n = Slots != 0 ? Slots : knots.size();
+    __m256 passes[interp_count_knots];
+    for (size_t j = 1; j < n; ++j)
+        passes[j] = _mm256_set1_ps(j < knots.size() ? knots[j]
+                                                    : std::numeric_limits<float>::infinity());
+    interp_lanes(xs, out, begin, end,
+                 [&](__m256 x)
+                 {
+                     const simd_vector<float, AVX_SIZE> c = clamp_lanes(x, lo, hi);
+                     // the masks are -1 where passed
+                     __m256i k = _mm256_setzero_si256();
+                     for (size_t j = 1; j < n; ++j)
+                     {
+                         const __m256 passed = _mm256_cmp_ps(passes[j], c.data, _CMP_LE_OQ);
+                         k = _mm256_sub_epi32(k, _mm256_castps_si256(passed));
+                     }
+                     return lerp_from(knot_lookup, values, slopes, c, k);
+                 });
+}
+
+// larger tables: a halving search whose steps gather one knot per lane
+inline void interp_search_range(const interp_table &table, const float *xs, float *out,
+                                size_t begin, size_t end)
+{
+    const auto knots = table.knots();
+    const gather_lookup knot_lookup(knots);
+    const gather_lookup values(table.values());
+    const gather_lookup slopes(table.slopes());
+    const __m256 lo = _mm256_set1_ps(knots.front());
+    const __m256 hi = _mm256_set1_ps(knots.back());
+    // the first halving step probes the same knot in every lane, a broadcast compare
+    const size_t half = knots.size() / 2;
+    const __m256 split = _mm256_set1_ps(knots[half]);
+    const __m256i split_index = _mm256_set1_epi32(static_cast<int>(half));
+    const size_t len = knots.size() - half;
+    interp_lanes(xs, out, begin, end,
+                 [&](__m256 x)
+                 {
+                     const simd_vector<float, AVX_SIZE> c = clamp_lanes(x, lo, hi);
+                     const __m256 upper = _mm256_cmp_ps(split, c.data, _CMP_LE_OQ);
+                     const __m256i base =
+                         _mm256_and_si256(_mm256_castps_si256(upper), split_index);
+                     const __m256i k = search_knots(knot_lookup, c.data, base, len);
+                     return lerp_from(knot_lookup, values, slopes, c, k);
+                 });
+}
+#endif
+
+inline void interp_block(const interp_table &table, const float *xs, float *out, size_t begin,
+                         size_t end)
+{
+#ifdef __AVX2__
+    // small tables stay in registers and are read with lane permutes instead of gathers
+    const size_t n = table.values().size();
+    if (table.uniform())
+    {
+        if (n <= AVX_SIZE)
+            interp_uniform_range<permute_lookup>(table, xs, out, begin, end);
+        else if (n <= 2 * AVX_SIZE)
+            interp_uniform_range<permute2_lookup>(table, xs, out, begin, end);
+        else
+            interp_uniform_range<gather_lookup>(table, xs, out, begin, end);
+    }
+    else if (n <= AVX_SIZE)
+        interp_count_range<permute_lookup, AVX_SIZE>(table, xs, out, begin, end);
+    else if (n <= 2 * AVX_SIZE)
+        interp_count_range<permute2_lookup, 2 * AVX_SIZE>(table, xs, out, begin, end);
+    else if (n <= interp_count_knots)
+        interp_count_range<gather_lookup, 0>(table, xs, out, begin, end);
+    else
+        interp_search_range(table, xs, out, begin, end);
+#else
+    for (size_t i = begin; i < end; ++i)
+        out[i] = table(xs[i]);
+#endif
+}
+
+} // namespace detail
+
+// out[i] = table(xs[i]), the piecewise-linear interpolation of the table at each input
+inline void interp1d(std::span<const float> xs, const interp_table &table, std::span<float> out,
+                     size_t threads = 1)
+{
+    if (out.size() != xs.size())
+        throw std::invalid_argument("interp1d: output size differs from input size");
+    SIMDLIB_PERF_SCOPE("interp1d", xs.size_bytes() + out.size_bytes());
+    parallel_for(xs.size(), chunk_count(threads, xs.size(), detail::interp_min_chunk),
+                 [&](size_t begin, size_t end, size_t)
+                 { detail::interp_block(table, xs.data(), out.data(), begin, end); });
+}
+
+} // namespace simdlib
@@ -0,0 +1,194 @@
+#pragma once
+
+#include "simd_reduce.hpp"
+#include "simd_vector.hpp"
+#include <bit>
+#include <cerrno>
+#include <cstdint>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <system_error>
+#include <utility>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace simdlib
+{
+
+// read-only memory mapping of a raw little-endian float32 file; the mapping starts on a
+// page boundary, so vector(i) uses aligned loads
+class mapped_column
+{
+    static_assert(std::endian::native == std::endian::little,
+                  "mapped_column reads little-endian float32 files in place");
+
+  public:
+    // populate faults the whole file in up front (MAP_POPULATE); leave it off for files
+    // larger than memory and let the streaming reductions read ahead chunk by chunk
+    explicit mapped_column(const std::string &path, bool populate = true)
+    {
+        const int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+        if (fd < 0)
+            throw std::system_error(errno, std::generic_category(), "mapped_column: open " + path);
+
+        struct stat st
+        {
+        };
+        if (::fstat(fd, &st) != 0)
+        {
+            const int err = errno;
+            ::close(fd);
+            throw std::system_error(err, std::generic_category(), "mapped_column: stat " + path);
+        }
+        const auto bytes = static_cast<size_t>(st.st_size);
+        if (bytes % sizeof(float) != 0)
+        {
+            ::close(fd);
+            throw std::runtime_error("mapped_column: " + path + " is not a whole number of floats");
+        }
+
+        if (bytes > 0)
+        {
+            int flags = MAP_PRIVATE;
+#ifdef MAP_POPULATE
+            if (populate)
+                flags |= MAP_POPULATE;
+#endif
+            void *addr = ::mmap(nullptr, bytes, PROT_READ, flags, fd, 0);
+            if (addr == MAP_FAILED)
+            {
+                const int err = errno;
+                ::close(fd);
+                throw std::system_error(err, std::generic_category(),
+                                        "mapped_column: mmap " + path);
+            }
+            ::madvise(addr, bytes, MADV_SEQUENTIAL);
+            data_ = static_cast<const float *>(addr);
+            size_ = bytes / sizeof(float);
+        }
+        // the mapping keeps the file referenced
+        ::close(fd);
+    }
+
+    mapped_column(mapped_column &&other) noexcept
+        : data_(std::exchange(other.data_, nullptr)), size_(std::exchange(other.size_, 0))
+    {
+    }
+
+    mapped_column &operator=(mapped_column &&other) noexcept
+    {
+        if (this != &other)
+        {
+            unmap();
+            data_ = std::exchange(other.data_, nullptr);
+            size_ = std::exchange(other.size_, 0);
+        }
+        return *this;
+    }
+
+    mapped_column(const mapped_column &) = delete;
+    mapped_column &operator=(const mapped_column &) = delete;
+
+    ~mapped_column()
+    {
+        unmap();
+    }
+
+    [[nodiscard]] const float *data() const
+    {
+        return data_;
+    }
+
+    [[nodiscard]] size_t size() const
+    {
+        return size_;
+    }
+
+    [[nodiscard]] std::span<const float> values() const
+    {
+        return {data_, size_};
+    }
+
+    // number of whole simd_vector<float, 8> in the column
+    [[nodiscard]] size_t vector_count() const
+    {
+        return size_ / AVX_SIZE;
+    }
+
+    // the i-th group of eight floats, loaded aligned
+    [[nodiscard]] simd_vector<float, AVX_SIZE> vector(size_t i) const
+    {
+        return simd_vector<float, AVX_SIZE>(_mm256_load_ps(data_ + i * AVX_SIZE));
+    }
+
+    // the values after the last whole vector
+    [[nodiscard]] std::span<const float> tail() const
+    {
+        return values().subspan(vector_count() * AVX_SIZE);
+    }
+
+    // ask the kernel to start reading elements [begin, end) in the background
+    void prefetch(size_t begin, size_t end) const
+    {
+        if (begin >= end || end > size_)
+            return;
+        const auto page = static_cast<uintptr_t>(::sysconf(_SC_PAGESIZE));
+        const auto first = reinterpret_cast<uintptr_t>(data_ + begin) & ~(page - 1);
+        const auto last = reinterpret_cast<uintptr_t>(data_ + end);
+        // advisory only, a failure just means no readahead
+        ::madvise(reinterpret_cast<void *>(first), last - first, MADV_WILLNEED);
+    }
+
+  private:
+    void unmap()
+    {
+        if (data_ != nullptr)
+            ::munmap(const_cast<float *>(data_), size_ * sizeof(float));
+        data_ = nullptr;
+        size_ = 0;
+    }
+
+    const float *data_ = nullptr;
+    size_t size_ = 0;
+};
+
+namespace detail
+{
+
+inline auto column_readahead(const mapped_column &column)
+{
+    return [&column](size_t begin, size_t end) { column.prefetch(begin, end); };
+}
+
+} // namespace detail
+
+// streaming reductions over a mapped column, each thread reading ahead of its own range
+
+inline double reduce_sum(const mapped_column &column, size_t threads = 1)
+{
+    return detail::sum_streamed(column.values(), threads, detail::column_readahead(column));
+}
+
+inline float reduce_min(const mapped_column &column, size_t threads = 1)
+{
+    return detail::extreme_streamed<false>(column.values(), threads,
+                                           detail::column_readahead(column));
+}
+
+inline float reduce_max(const mapped_column &column, size_t threads = 1)
+{
+    return detail::extreme_streamed<true>(column.values(), threads,
+                                          detail::column_readahead(column));
+}
+
+template <typename Op>
+void transform_values(const mapped_column &column, std::span<float> dst, Op op, size_t threads = 1)
+{
+    detail::transform_streamed(column.values(), dst, op, threads, detail::column_readahead(column));
+}
+
+} // namespace simdlib
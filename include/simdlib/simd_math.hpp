@@ -0,0 +1,208 @@
+#pragma once
+
+#include "simd_vector.hpp"
+#include <cstdint>
+#include <limits>
+
+namespace simdlib
+{
+
+namespace detail
+{
+
+// applies a 128-bit integer op to both halves, for AVX targets without AVX2
+template <typename Op> inline __m256i per_half(__m256i a, __m256i b, Op op)
+{
+    return _mm256_setr_m128i(op(_mm256_castsi256_si128(a), _mm256_castsi256_si128(b)),
+                             op(_mm256_extractf128_si256(a, 1), _mm256_extractf128_si256(b, 1)));
+}
+
+inline __m256i add_epi32(__m256i a, __m256i b)
+{
+#ifdef __AVX2__
+    return _mm256_add_epi32(a, b);
+#else
+    return per_half(a, b, [](__m128i x, __m128i y) { return _mm_add_epi32(x, y); });
+#endif
+}
+
+inline __m256i sub_epi32(__m256i a, __m256i b)
+{
+#ifdef __AVX2__
+    return _mm256_sub_epi32(a, b);
+#else
+    return per_half(a, b, [](__m128i x, __m128i y) { return _mm_sub_epi32(x, y); });
+#endif
+}
+
+inline __m256i cmpeq_epi32(__m256i a, __m256i b)
+{
+#ifdef __AVX2__
+    return _mm256_cmpeq_epi32(a, b);
+#else
+    return per_half(a, b, [](__m128i x, __m128i y) { return _mm_cmpeq_epi32(x, y); });
+#endif
+}
+
+template <int Shift> inline __m256i slli_epi32(__m256i a)
+{
+#ifdef __AVX2__
+    return _mm256_slli_epi32(a, Shift);
+#else
+    return per_half(a, a, [](__m128i x, __m128i) { return _mm_slli_epi32(x, Shift); });
+#endif
+}
+
+template <int Shift> inline __m256i srli_epi32(__m256i a)
+{
+#ifdef __AVX2__
+    return _mm256_srli_epi32(a, Shift);
+#else
+    return per_half(a, a, [](__m128i x, __m128i) { return _mm_srli_epi32(x, Shift); });
+#endif
+}
+
+// bitwise ops go through the float domain, which plain AVX has
+inline __m256i and_si256(__m256i a, __m256i b)
+{
+    return _mm256_castps_si256(_mm256_and_ps(_mm256_castsi256_ps(a), _mm256_castsi256_ps(b)));
+}
+
+inline __m256i or_si256(__m256i a, __m256i b)
+{
+    return _mm256_castps_si256(_mm256_or_ps(_mm256_castsi256_ps(a), _mm256_castsi256_ps(b)));
+}
+
+inline __m256i xor_si256(__m256i a, __m256i b)
+{
+    return _mm256_castps_si256(_mm256_xor_ps(_mm256_castsi256_ps(a), _mm256_castsi256_ps(b)));
+}
+
+inline __m256i andnot_si256(__m256i a, __m256i b)
+{
+    return _mm256_castps_si256(_mm256_andnot_ps(_mm256_castsi256_ps(a), _mm256_castsi256_ps(b)));
+}
+
+// Horner evaluation, highest coefficient first
+template <typename... Coeffs> inline __m256 poly(__m256 x, float c0, Coeffs... rest)
+{
+    const simd_vector<float, AVX_SIZE> xv(x);
+    simd_vector<float, AVX_SIZE> acc(c0);
+    ((acc = acc.fmadd(xv, simd_vector<float, AVX_SIZE>(rest))), ...);
+    return acc.data;
+}
+
+} // namespace detail
+
+// e^x, within 2 ulp (Cephes expf); results below about 1e-38 flush to zero and inputs above
+// 88.37 saturate at e^88.37, so exp(-inf) is 0 and NaN stays NaN
+inline simd_vector<float, AVX_SIZE> exp(const simd_vector<float, AVX_SIZE> &vec)
+{
+    // x second so a NaN passes through the clamp
+    __m256 x = _mm256_min_ps(_mm256_set1_ps(88.3762626647949f),
+                             _mm256_max_ps(_mm256_set1_ps(-88.3762626647949f), vec.data));
+
+    // x = n * ln 2 + r with |r| <= ln 2 / 2, ln 2 split in two for the subtraction
+    const __m256 n = _mm256_round_ps(_mm256_mul_ps(x, _mm256_set1_ps(1.44269504088896341f)),
+                                     _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC);
+    x = _mm256_sub_ps(x, _mm256_mul_ps(n, _mm256_set1_ps(0.693359375f)));
+    x = _mm256_sub_ps(x, _mm256_mul_ps(n, _mm256_set1_ps(-2.12194440e-4f)));
+
+    const __m256 z = _mm256_mul_ps(x, x);
+    __m256 y = detail::poly(x, 1.9875691500e-4f, 1.3981999507e-3f, 8.3334519073e-3f,
+                            4.1665795894e-2f, 1.6666665459e-1f, 5.0000001201e-1f);
+    y = _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(y, z), x), _mm256_set1_ps(1.0f));
+
+    // 2^n built in the exponent field; n = -127 gives 0
+    const __m256i pow2 = detail::slli_epi32<23>(
+        detail::add_epi32(_mm256_cvtps_epi32(n), _mm256_set1_epi32(127)));
+    return simd_vector<float, AVX_SIZE>(_mm256_mul_ps(y, _mm256_castsi256_ps(pow2)));
+}
+
+// natural logarithm, within 2 ulp for normal inputs (Cephes logf); 0 gives -inf and negative
+// or NaN inputs give NaN
+inline simd_vector<float, AVX_SIZE> log(const simd_vector<float, AVX_SIZE> &vec)
+{
+    using detail::sub_epi32;
+    const __m256 x_in = vec.data;
+    // denormals are treated as the smallest normal
+    __m256 x = _mm256_max_ps(x_in, _mm256_set1_ps(std::numeric_limits<float>::min()));
+    const __m256i bits = _mm256_castps_si256(x);
+
+    // x = m * 2^e with m in [0.5, 1)
+    __m256 e =
+        _mm256_cvtepi32_ps(sub_epi32(detail::srli_epi32<23>(bits), _mm256_set1_epi32(126)));
+    x = _mm256_or_ps(_mm256_and_ps(x, _mm256_castsi256_ps(_mm256_set1_epi32(0x007FFFFF))),
+                     _mm256_set1_ps(0.5f));
+
+    // fold m into [sqrt(1/2), sqrt(2)) and take log(1 + x) around zero
+    const __m256 small = _mm256_cmp_ps(x, _mm256_set1_ps(0.707106781186547524f), _CMP_LT_OQ);
+    e = _mm256_sub_ps(e, _mm256_and_ps(small, _mm256_set1_ps(1.0f)));
+    x = _mm256_add_ps(_mm256_sub_ps(x, _mm256_set1_ps(1.0f)), _mm256_and_ps(small, x));
+
+    const __m256 z = _mm256_mul_ps(x, x);
+    __m256 y = detail::poly(x, 7.0376836292e-2f, -1.1514610310e-1f, 1.1676998740e-1f,
+                            -1.2420140846e-1f, 1.4249322787e-1f, -1.6668057665e-1f,
+                            2.0000714765e-1f, -2.4999993993e-1f, 3.3333331174e-1f);
+    y = _mm256_mul_ps(_mm256_mul_ps(y, x), z);
+    y = _mm256_add_ps(y, _mm256_mul_ps(e, _mm256_set1_ps(-2.12194440e-4f)));
+    y = _mm256_sub_ps(y, _mm256_mul_ps(z, _mm256_set1_ps(0.5f)));
+    x = _mm256_add_ps(_mm256_add_ps(x, y), _mm256_mul_ps(e, _mm256_set1_ps(0.693359375f)));
+
+    const __m256 zero = _mm256_setzero_ps();
+    const __m256 inf = _mm256_set1_ps(std::numeric_limits<float>::infinity());
+    x = _mm256_blendv_ps(x, _mm256_sub_ps(zero, inf), _mm256_cmp_ps(x_in, zero, _CMP_EQ_OQ));
+    x = _mm256_blendv_ps(x, inf, _mm256_cmp_ps(x_in, inf, _CMP_EQ_OQ));
+    // x < 0 or NaN
+    return simd_vector<float, AVX_SIZE>(_mm256_or_ps(x, _mm256_cmp_ps(x_in, zero, _CMP_NGE_UQ)));
+}
+
+// sine and cosine together, within 2 ulp for |x| up to a few thousand (Cephes sincosf)
+inline void sincos(const simd_vector<float, AVX_SIZE> &vec, simd_vector<float, AVX_SIZE> &sin_out,
+                   simd_vector<float, AVX_SIZE> &cos_out)
+{
+    using detail::and_si256;
+    const __m256 sign_mask = _mm256_set1_ps(-0.0f);
+    __m256 sin_sign = _mm256_and_ps(vec.data, sign_mask);
+    __m256 x = _mm256_andnot_ps(sign_mask, vec.data);
+
+    // octant j rounded up to even, so x - j * pi/4 lies in [-pi/4, pi/4]
+    __m256i j = _mm256_cvttps_epi32(_mm256_mul_ps(x, _mm256_set1_ps(1.27323954473516f)));
+    j = and_si256(detail::add_epi32(j, _mm256_set1_epi32(1)), _mm256_set1_epi32(~1));
+    const __m256 y = _mm256_cvtepi32_ps(j);
+
+    // swap the polynomials in octants 2 and 6, flip signs in the upper half turn
+    const __m256 use_sin_poly = _mm256_castsi256_ps(
+        detail::cmpeq_epi32(and_si256(j, _mm256_set1_epi32(2)), _mm256_setzero_si256()));
+    sin_sign = _mm256_xor_ps(
+        sin_sign, _mm256_castsi256_ps(detail::slli_epi32<29>(and_si256(j, _mm256_set1_epi32(4)))));
+    const __m256 cos_sign = _mm256_castsi256_ps(detail::slli_epi32<29>(
+        detail::andnot_si256(detail::sub_epi32(j, _mm256_set1_epi32(2)), _mm256_set1_epi32(4))));
+
+    // extended precision x - y * pi/4
+    x = simd_vector<float, AVX_SIZE>(y)
+            .fmadd(simd_vector<float, AVX_SIZE>(-0.78515625f), simd_vector<float, AVX_SIZE>(x))
+            .data;
+    x = simd_vector<float, AVX_SIZE>(y)
+            .fmadd(simd_vector<float, AVX_SIZE>(-2.4187564849853515625e-4f),
+                   simd_vector<float, AVX_SIZE>(x))
+            .data;
+    x = simd_vector<float, AVX_SIZE>(y)
+            .fmadd(simd_vector<float, AVX_SIZE>(-3.77489497744594108e-8f),
+                   simd_vector<float, AVX_SIZE>(x))
+            .data;
+
+    const __m256 z = _mm256_mul_ps(x, x);
+    __m256 cos_poly =
+        detail::poly(z, 2.443315711809948e-5f, -1.388731625493765e-3f, 4.166664568298827e-2f);
+    cos_poly = _mm256_mul_ps(_mm256_mul_ps(cos_poly, z), z);
+    cos_poly = _mm256_add_ps(_mm256_sub_ps(cos_poly, _mm256_mul_ps(z, _mm256_set1_ps(0.5f))),
+                             _mm256_set1_ps(1.0f));
+    __m256 sin_poly = detail::poly(z, -1.9515295891e-4f, 8.3321608736e-3f, -1.6666654611e-1f);
+    sin_poly = _mm256_add_ps(_mm256_mul_ps(_mm256_mul_ps(sin_poly, z), x), x);
+
+    sin_out.data = _mm256_xor_ps(_mm256_blendv_ps(cos_poly, sin_poly, use_sin_poly), sin_sign);
+    cos_out.data = _mm256_xor_ps(_mm256_blendv_ps(sin_poly, cos_poly, use_sin_poly), cos_sign);
+}
+
+} // namespace simdlib
@@ -0,0 +1,340 @@
+#pragma once
+
+#include "simd_math.hpp"
+#include "simd_parallel.hpp"
+#include "simd_perf.hpp"
+#include "simd_vector.hpp"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <span>
+#include <stdexcept>
+#include <string>
+
+namespace simdlib
+{
+
+namespace detail
+{
+
+// elements a worker thread must have before a batch of rows is split
+constexpr size_t normalize_min_chunk = size_t{1} << 16;
+
+// lanes [0, n) of a mask, n < 8
+inline __m256i tail_mask(size_t n)
+{
+    const __m256 lanes = _mm256_setr_ps(0.0f, 1.0f, 2.0f, 3.0f, 4.0f, 5.0f, 6.0f, 7.0f);
+    return _mm256_castps_si256(
+        _mm256_cmp_ps(lanes, _mm256_set1_ps(static_cast<float>(n)), _CMP_LT_OQ));
+}
+
+// the n < 8 floats at p, fill in the other lanes
+inline __m256 load_tail(const float *p, __m256i mask, float fill)
+{
+    return _mm256_blendv_ps(_mm256_set1_ps(fill), _mm256_maskload_ps(p, mask),
+                            _mm256_castsi256_ps(mask));
+}
+
+// running per-lane maximum m and sum of exp(x - m); the sum is rescaled once per four vectors,
+// so a row costs about 1.25 exponentials per vector in a single read
+struct online_exp_sum
+{
+    __m256 max = _mm256_set1_ps(std::numeric_limits<float>::lowest());
+    __m256 sum = _mm256_setzero_ps();
+
+    void add(const simd_vector<float, AVX_SIZE> *x, size_t count)
+    {
+        __m256 block_max = max;
+        for (size_t v = 0; v < count; ++v)
+            block_max = _mm256_max_ps(x[v].data, block_max);
+        const simd_vector<float, AVX_SIZE> new_max(block_max);
+        simd_vector<float, AVX_SIZE> acc =
+            simd_vector<float, AVX_SIZE>(sum) * exp(simd_vector<float, AVX_SIZE>(max) - new_max);
+        for (size_t v = 0; v < count; ++v)
+            acc += exp(x[v] - new_max);
+        max = block_max;
+        sum = acc.data;
+    }
+
+    // the row's maximum M and sum of exp(x - M)
+    void finish(float &row_max, float &row_sum) const
+    {
+        row_max = simd_vector<float, AVX_SIZE>(max).horizontal_max();
+        row_sum = (simd_vector<float, AVX_SIZE>(sum) *
+                   exp(simd_vector<float, AVX_SIZE>(max) - simd_vector<float, AVX_SIZE>(row_max)))
+                      .horizontal_sum();
+    }
+};
+
+inline void exp_sum(const float *x, size_t n, float &row_max, float &row_sum)
+{
+    online_exp_sum acc;
+    simd_vector<float, AVX_SIZE> block[4];
+    size_t i = 0;
+    for (; i + 4 * AVX_SIZE <= n; i += 4 * AVX_SIZE)
+    {
+        for (size_t v = 0; v < 4; ++v)
+            block[v].data = _mm256_loadu_ps(x + i + v * AVX_SIZE);
+        acc.add(block, 4);
+    }
+    size_t count = 0;
+    for (; i + AVX_SIZE <= n; i += AVX_SIZE)
+        block[count++].data = _mm256_loadu_ps(x + i);
+    if (i < n)
+    {
+        // exp(-inf - m) is 0, so the padding adds nothing
+        block[count++].data =
+            load_tail(x + i, tail_mask(n - i), -std::numeric_limits<float>::infinity());
+    }
+    if (count > 0)
+        acc.add(block, count);
+    acc.finish(row_max, row_sum);
+}
+
+inline float log_sum_exp_row(const float *x, size_t n)
+{
+    float row_max = 0.0f;
+    float row_sum = 0.0f;
+    exp_sum(x, n, row_max, row_sum);
+    return row_max + std::log(row_sum);
+}
+
+// dst = op(x) over a row, op maps one vector to one vector
+template <typename Op> inline void map_row(const float *x, float *dst, size_t n, Op op)
+{
+    size_t i = 0;
+    for (; i + AVX_SIZE <= n; i += AVX_SIZE)
+        _mm256_storeu_ps(dst + i, op(simd_vector<float, AVX_SIZE>(_mm256_loadu_ps(x + i))).data);
+    if (i < n)
+    {
+        const __m256i mask = tail_mask(n - i);
+        _mm256_maskstore_ps(dst + i, mask,
+                            op(simd_vector<float, AVX_SIZE>(load_tail(x + i, mask, 0.0f))).data);
+    }
+}
+
+inline void softmax_row(const float *x, float *dst, size_t n)
+{
+    float row_max = 0.0f;
+    float row_sum = 0.0f;
+    exp_sum(x, n, row_max, row_sum);
+    const simd_vector<float, AVX_SIZE> shift(row_max);
+    const simd_vector<float, AVX_SIZE> scale(1.0f / row_sum);
+    map_row(x, dst, n,
+            [&](const simd_vector<float, AVX_SIZE> &v) { return exp(v - shift) * scale; });
+}
+
+inline void log_softmax_row(const float *x, float *dst, size_t n)
+{
+    const simd_vector<float, AVX_SIZE> shift(log_sum_exp_row(x, n));
+    map_row(x, dst, n, [&](const simd_vector<float, AVX_SIZE> &v) { return v - shift; });
+}
+
+// mean and variance in one read: float lanes accumulate x - x[0], which keeps the squares
+// small for rows far from zero, and the lanes are combined in double
+inline void row_moments(const float *x, size_t n, double &mean, double &variance)
+{
+    const simd_vector<float, AVX_SIZE> shift(x[0]);
+    simd_vector<float, AVX_SIZE> sum0;
+    simd_vector<float, AVX_SIZE> sum1;
+    simd_vector<float, AVX_SIZE> sq0;
+    simd_vector<float, AVX_SIZE> sq1;
+    size_t i = 0;
+    for (; i + 2 * AVX_SIZE <= n; i += 2 * AVX_SIZE)
+    {
+        const simd_vector<float, AVX_SIZE> d0 =
+            simd_vector<float, AVX_SIZE>(_mm256_loadu_ps(x + i)) - shift;
+        const simd_vector<float, AVX_SIZE> d1 =
+            simd_vector<float, AVX_SIZE>(_mm256_loadu_ps(x + i + AVX_SIZE)) - shift;
+        sum0 += d0;
+        sum1 += d1;
+        sq0 = d0.fmadd(d0, sq0);
+        sq1 = d1.fmadd(d1, sq1);
+    }
+    for (; i + AVX_SIZE <= n; i += AVX_SIZE)
+    {
+        const simd_vector<float, AVX_SIZE> d =
+            simd_vector<float, AVX_SIZE>(_mm256_loadu_ps(x + i)) - shift;
+        sum0 += d;
+        sq0 = d.fmadd(d, sq0);
+    }
+    if (i < n)
+    {
+        // padding with the shift makes those lanes contribute zero
+        const simd_vector<float, AVX_SIZE> d =
+            simd_vector<float, AVX_SIZE>(load_tail(x + i, tail_mask(n - i), x[0])) - shift;
+        sum0 += d;
+        sq0 = d.fmadd(d, sq0);
+    }
+    const double count = static_cast<double>(n);
+    const double d_mean = static_cast<double>((sum0 + sum1).horizontal_sum()) / count;
+    const double d_sq = static_cast<double>((sq0 + sq1).horizontal_sum()) / count;
+    mean = static_cast<double>(x[0]) + d_mean;
+    variance = std::max(0.0, d_sq - d_mean * d_mean);
+}
+
+inline void layer_norm_row(const float *x, float *dst, size_t n, const float *gamma,
+                           const float *beta, float eps)
+{
+    double mean = 0.0;
+    double variance = 0.0;
+    row_moments(x, n, mean, variance);
+    const simd_vector<float, AVX_SIZE> center(static_cast<float>(mean));
+    const simd_vector<float, AVX_SIZE> rstd(
+        static_cast<float>(1.0 / std::sqrt(variance + static_cast<double>(eps))));
+    if (gamma == nullptr)
+    {
+        map_row(x, dst, n,
+                [&](const simd_vector<float, AVX_SIZE> &v) { return (v - center) * rstd; });
+        return;
+    }
+    size_t i = 0;
+    for (; i + AVX_SIZE <= n; i += AVX_SIZE)
+    {
+        const simd_vector<float, AVX_SIZE> y =
+            (simd_vector<float, AVX_SIZE>(_mm256_loadu_ps(x + i)) - center) * rstd;
+        const simd_vector<float, AVX_SIZE> g(_mm256_loadu_ps(gamma + i));
+        const simd_vector<float, AVX_SIZE> b(_mm256_loadu_ps(beta + i));
+        _mm256_storeu_ps(dst + i, y.fmadd(g, b).data);
+    }
+    if (i < n)
+    {
+        const __m256i mask = tail_mask(n - i);
+        const simd_vector<float, AVX_SIZE> y =
+            (simd_vector<float, AVX_SIZE>(load_tail(x + i, mask, 0.0f)) - center) * rstd;
+        const simd_vector<float, AVX_SIZE> g(load_tail(gamma + i, mask, 0.0f));
+        const simd_vector<float, AVX_SIZE> b(load_tail(beta + i, mask, 0.0f));
+        _mm256_maskstore_ps(dst + i, mask, y.fmadd(g, b).data);
+    }
+}
+
+// rows of a row-major [rows][cols] batch, and the thread chunks over them
+inline size_t row_count(size_t size, size_t cols, const char *what)
+{
+    if (cols == 0 || size % cols != 0)
+        throw std::invalid_argument(std::string(what) +
+                                    ": size is not a multiple of the row length");
+    return size / cols;
+}
+
+template <typename Row> inline void for_each_row(size_t rows, size_t cols, size_t threads, Row row)
+{
+    const size_t min_rows = std::max<size_t>(1, normalize_min_chunk / std::max<size_t>(cols, 1));
+    parallel_for(rows, chunk_count(threads, rows, min_rows),
+                 [&](size_t begin, size_t end, size_t)
+                 {
+                     for (size_t r = begin; r < end; ++r)
+                         row(r);
+                 });
+}
+
+inline void check_affine(size_t cols, std::span<const float> gamma, std::span<const float> beta)
+{
+    if (gamma.size() != beta.size() || (!gamma.empty() && gamma.size() != cols))
+        throw std::invalid_argument("layer_norm: gamma and beta must both be empty or match the "
+                                    "row length");
+}
+
+} // namespace detail
+
+// log(sum(exp(x))) in one read of the row with an online max, -inf for an empty row
+inline float log_sum_exp(std::span<const float> row)
+{
+    SIMDLIB_PERF_SCOPE("log_sum_exp", row.size_bytes());
+    return detail::log_sum_exp_row(row.data(), row.size());
+}
+
+// exp(x - max) / sum, two reads of the row; src and dst may be the same buffer
+inline void softmax(std::span<const float> src, std::span<float> dst)
+{
+    if (src.size() != dst.size())
+        throw std::invalid_argument("softmax: buffers differ in size");
+    SIMDLIB_PERF_SCOPE("softmax", 2 * src.size_bytes() + dst.size_bytes());
+    detail::softmax_row(src.data(), dst.data(), src.size());
+}
+
+// x - log_sum_exp(x), two reads of the row; src and dst may be the same buffer
+inline void log_softmax(std::span<const float> src, std::span<float> dst)
+{
+    if (src.size() != dst.size())
+        throw std::invalid_argument("log_softmax: buffers differ in size");
+    SIMDLIB_PERF_SCOPE("log_softmax", 2 * src.size_bytes() + dst.size_bytes());
+    detail::log_softmax_row(src.data(), dst.data(), src.size());
+}
+
+// (x - mean) / sqrt(variance + eps) * gamma + beta with the biased variance, two reads of the
+// row; gamma and beta are both empty (no affine step) or one per element
+inline void layer_norm(std::span<const float> src, std::span<float> dst,
+                       std::span<const float> gamma = {}, std::span<const float> beta = {},
+                       float eps = 1e-5f)
+{
+    if (src.size() != dst.size())
+        throw std::invalid_argument("layer_norm: buffers differ in size");
+    detail::check_affine(src.size(), gamma, beta);
+    if (src.empty())
+        return;
+    SIMDLIB_PERF_SCOPE("layer_norm", 2 * src.size_bytes() + dst.size_bytes());
+    detail::layer_norm_row(src.data(), dst.data(), src.size(),
+                           gamma.empty() ? nullptr : gamma.data(), beta.data(), eps);
+}
+
+// batched forms over a row-major [rows][cols] matrix, rows split across threads
+
+inline void log_sum_exp_rows(std::span<const float> src, size_t cols, std::span<float> dst,
+                             size_t threads = 1)
+{
+    const size_t rows = detail::row_count(src.size(), cols, "log_sum_exp_rows");
+    if (dst.size() != rows)
+        throw std::invalid_argument("log_sum_exp_rows: need one output per row");
+    SIMDLIB_PERF_SCOPE("log_sum_exp_rows", src.size_bytes() + dst.size_bytes());
+    detail::for_each_row(rows, cols, threads, [&](size_t r)
+                         { dst[r] = detail::log_sum_exp_row(src.data() + r * cols, cols); });
+}
+
+inline void softmax_rows(std::span<const float> src, std::span<float> dst, size_t cols,
+                         size_t threads = 1)
+{
+    if (src.size() != dst.size())
+        throw std::invalid_argument("softmax_rows: buffers differ in size");
+    const size_t rows = detail::row_count(src.size(), cols, "softmax_rows");
+    SIMDLIB_PERF_SCOPE("softmax_rows", 2 * src.size_bytes() + dst.size_bytes());
+    detail::for_each_row(rows, cols, threads,
+                         [&](size_t r) {
+                             detail::softmax_row(src.data() + r * cols, dst.data() + r * cols,
+                                                 cols);
+                         });
+}
+
+inline void log_softmax_rows(std::span<const float> src, std::span<float> dst, size_t cols,
+                             size_t threads = 1)
+{
+    if (src.size() != dst.size())
+        throw std::invalid_argument("log_softmax_rows: buffers differ in size");
+    const size_t rows = detail::row_count(src.size(), cols, "log_softmax_rows");
+    SIMDLIB_PERF_SCOPE("log_softmax_rows", 2 * src.size_bytes() + dst.size_bytes());
+    detail::for_each_row(rows, cols, threads,
+                         [&](size_t r) {
+                             detail::log_softmax_row(src.data() + r * cols, dst.data() + r * cols,
+                                                     cols);
+                         });
+}
+
+// gamma and beta are shared by every row
+inline void layer_norm_rows(std::span<const float> src, std::span<float> dst, size_t cols,
+                            std::span<const float> gamma = {}, std::span<const float> beta = {},
+                            float eps = 1e-5f, size_t threads = 1)
+{
+    if (src.size() != dst.size())
+        throw std::invalid_argument("layer_norm_rows: buffers differ in size");
+    const size_t rows = detail::row_count(src.size(), cols, "layer_norm_rows");
+    detail::check_affine(cols, gamma, beta);
+    SIMDLIB_PERF_SCOPE("layer_norm_rows", 2 * src.size_bytes() + dst.size_bytes());
+    const float *g = gamma.empty() ? nullptr : gamma.data();
+    detail::for_each_row(rows, cols, threads,
+                         [&](size_t r) {
+                             detail::layer_norm_row(src.data() + r * cols, dst.data() + r * cols,
+                                                    cols, g, beta.data(), eps);
+                         });
+}
+
+} // namespace simdlib
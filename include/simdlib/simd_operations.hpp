@@ -65,6 +65,14 @@ simd_vector<T, N> &operator/=(simd_vector<T, N> &lhs, const simd_vector<T, N> &r
     return lhs;
 }
 
+// fused multiply-add: a * b + c
+template <typename T, size_t N>
+simd_vector<T, N> fmadd(const simd_vector<T, N> &a, const simd_vector<T, N> &b,
+                        const simd_vector<T, N> &c)
+{
+    return a.fmadd(b, c);
+}
+
 // element-wise equality
 template <typename T, size_t N>
 simd_vector<T, N> operator==(const simd_vector<T, N> &lhs, const simd_vector<T, N> &rhs)
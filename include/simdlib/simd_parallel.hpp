@@ -0,0 +1,61 @@
+#pragma once
+
+#include "simd_traits.hpp"
+#include <algorithm>
+#include <exception>
+#include <thread>
+#include <vector>
+
+namespace simdlib
+{
+
+// number of chunks to split n elements into, 0 requests one per hardware thread
+inline size_t chunk_count(size_t requested, size_t n, size_t min_chunk)
+{
+    if (requested == 0)
+        requested = std::max<size_t>(1, std::thread::hardware_concurrency());
+    return std::clamp<size_t>(n / std::max<size_t>(min_chunk, 1), 1, requested);
+}
+
+// run body(begin, end, chunk) over `chunks` contiguous ranges of [0, n), one thread per chunk;
+// chunk boundaries are multiples of AVX_SIZE so vector loops stay aligned to the caller's base.
+// an exception from any chunk is rethrown here once every chunk has finished, the lowest
+// chunk's if several throw
+template <typename Body> void parallel_for(size_t n, size_t chunks, Body &&body)
+{
+    if (chunks <= 1)
+    {
+        body(size_t{0}, n, size_t{0});
+        return;
+    }
+
+    const auto boundary = [n, chunks](size_t chunk)
+    { return chunk == chunks ? n : (n * chunk / chunks) & ~(AVX_SIZE - 1); };
+
+    std::vector<std::exception_ptr> errors(chunks);
+    const auto run = [&body, &errors, &boundary](size_t chunk)
+    {
+        try
+        {
+            body(boundary(chunk), boundary(chunk + 1), chunk);
+        }
+        catch (...)
+        {
+            errors[chunk] = std::current_exception();
+        }
+    };
+    {
+        std::vector<std::jthread> workers;
+        workers.reserve(chunks - 1);
+        for (size_t chunk = 1; chunk < chunks; ++chunk)
+            workers.emplace_back(run, chunk);
+        run(0);
+    }
+    for (const auto &error : errors)
+    {
+        if (error)
+            std::rethrow_exception(error);
+    }
+}
+
+} // namespace simdlib
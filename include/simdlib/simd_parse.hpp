@@ -0,0 +1,389 @@
+#pragma once
+
+#include "simd_allocator.hpp"
+#include "simd_perf.hpp"
+#include "simd_traits.hpp"
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <charconv>
+#include <cstdlib>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <vector>
+
+#include <immintrin.h>
+
+namespace simdlib
+{
+
+namespace detail
+{
+
+// bytes classified per step of the tokenizer
+constexpr size_t parse_block = 32;
+
+// the digit converter reads this many bytes from the start of each digit run
+constexpr size_t parse_overread = 16;
+
+// longer tokens cannot take the fast path and go straight to from_chars
+constexpr size_t fast_token_length = 32;
+
+struct block_masks
+{
+    uint32_t separator; // whitespace or the delimiter
+    uint32_t delimiter;
+    uint32_t newline;
+};
+
+inline block_masks classify_block(const char *p, char delimiter)
+{
+#ifdef __AVX2__
+    const __m256i bytes = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(p));
+    const auto is = [&bytes](char c) { return _mm256_cmpeq_epi8(bytes, _mm256_set1_epi8(c)); };
+    const __m256i newline = is('\n');
+    const __m256i delim = is(delimiter);
+    const __m256i separator =
+        _mm256_or_si256(_mm256_or_si256(newline, delim),
+                        _mm256_or_si256(is(' '), _mm256_or_si256(is('\t'), is('\r'))));
+    return {static_cast<uint32_t>(_mm256_movemask_epi8(separator)),
+            static_cast<uint32_t>(_mm256_movemask_epi8(delim)),
+            static_cast<uint32_t>(_mm256_movemask_epi8(newline))};
+#else
+    block_masks masks{0, 0, 0};
+    for (size_t half = 0; half < 2; ++half)
+    {
+        const __m128i bytes = _mm_loadu_si128(reinterpret_cast<const __m128i *>(p + 16 * half));
+        const auto is = [&bytes](char c) { return _mm_cmpeq_epi8(bytes, _mm_set1_epi8(c)); };
+        const __m128i newline = is('\n');
+        const __m128i delim = is(delimiter);
+        const __m128i separator =
+            _mm_or_si128(_mm_or_si128(newline, delim),
+                         _mm_or_si128(is(' '), _mm_or_si128(is('\t'), is('\r'))));
+        masks.separator |= static_cast<uint32_t>(_mm_movemask_epi8(separator)) << (16 * half);
+        masks.delimiter |= static_cast<uint32_t>(_mm_movemask_epi8(delim)) << (16 * half);
+        masks.newline |= static_cast<uint32_t>(_mm_movemask_epi8(newline)) << (16 * half);
+    }
+    return masks;
+#endif
+}
+
+// calls emit(begin, end, new_row, delimiters) for every run of non-separator bytes; new_row
+// is set for the first token and for tokens with a newline between them and the previous
+// token, delimiters counts the delimiter bytes since the previous token
+template <typename Emit> void for_each_token(std::string_view text, char delimiter, Emit &&emit)
+{
+    const char *base = text.data();
+    const size_t n = text.size();
+    size_t token_begin = 0;
+    bool in_token = false;
+    bool token_new_row = false;
+    bool new_row = true;
+    size_t token_delimiters = 0;
+    size_t delimiters = 0;
+    uint32_t prev_separator = 1; // the byte before the text counts as a separator
+    std::array<char, parse_block> tail;
+    for (size_t pos = 0; pos < n; pos += parse_block)
+    {
+        const char *p = base + pos;
+        if (pos + parse_block > n)
+        {
+            // the last partial block is padded with separators
+            tail.fill(' ');
+            std::memcpy(tail.data(), p, n - pos);
+            p = tail.data();
+        }
+        const block_masks masks = classify_block(p, delimiter);
+        const uint32_t after_separator = (masks.separator << 1) | prev_separator;
+        const uint32_t starts = ~masks.separator & after_separator;
+        const uint32_t ends = masks.separator & ~after_separator;
+        prev_separator = masks.separator >> 31;
+
+        const uint32_t marks = starts | ends | masks.newline | masks.delimiter;
+        for (uint32_t events = marks; events != 0; events &= events - 1)
+        {
+            const uint32_t bit = events & (~events + 1);
+            const size_t at = pos + static_cast<size_t>(std::countr_zero(events));
+            if (ends & bit)
+            {
+                emit(base + token_begin, base + at, token_new_row, token_delimiters);
+                in_token = false;
+            }
+            if (masks.newline & bit)
+                new_row = true;
+            if (masks.delimiter & bit)
+                ++delimiters;
+            if (starts & bit)
+            {
+                token_begin = at;
+                token_new_row = new_row;
+                token_delimiters = delimiters;
+                new_row = false;
+                delimiters = 0;
+                in_token = true;
+            }
+        }
+    }
+    if (in_token)
+        emit(base + token_begin, base + n, token_new_row, token_delimiters);
+}
+
+// number of leading ASCII digits in the 16 bytes at p
+inline size_t digit_run(const char *p)
+{
+    const __m128i digits =
+        _mm_sub_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i *>(p)), _mm_set1_epi8('0'));
+    const __m128i is_digit = _mm_cmpeq_epi8(_mm_min_epu8(digits, _mm_set1_epi8(9)), digits);
+    return static_cast<size_t>(
+        std::countr_zero(~static_cast<uint32_t>(_mm_movemask_epi8(is_digit)) | 0x10000u));
+}
+
+// shuffle moving the first len bytes to the top of the register, zero below
+inline constexpr auto right_align_shuffles = []
+{
+    std::array<std::array<int8_t, 16>, 17> table{};
+    for (size_t len = 0; len <= 16; ++len)
+    {
+        for (size_t j = 0; j < 16; ++j)
+            table[len][j] = j >= 16 - len ? static_cast<int8_t>(j - (16 - len)) : int8_t{-128};
+    }
+    return table;
+}();
+
+// value of the len <= 16 decimal digits at p, 16 bytes must be readable
+inline uint64_t parse_digits(const char *p, size_t len)
+{
+    __m128i digits =
+        _mm_sub_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i *>(p)), _mm_set1_epi8('0'));
+    const __m128i align =
+        _mm_loadu_si128(reinterpret_cast<const __m128i *>(right_align_shuffles[len].data()));
+    digits = _mm_shuffle_epi8(digits, align);
+    // pairs, then quads, then eights of digits combined by multiply-add
+    const __m128i pairs = _mm_maddubs_epi16(digits, _mm_setr_epi8(10, 1, 10, 1, 10, 1, 10, 1, 10,
+                                                                  1, 10, 1, 10, 1, 10, 1));
+    const __m128i quads = _mm_madd_epi16(pairs, _mm_setr_epi16(100, 1, 100, 1, 100, 1, 100, 1));
+    const __m128i eights = _mm_madd_epi16(_mm_packus_epi32(quads, quads),
+                                          _mm_setr_epi16(10000, 1, 10000, 1, 0, 0, 0, 0));
+    return static_cast<uint64_t>(static_cast<uint32_t>(_mm_cvtsi128_si32(eights))) * 100000000u +
+           static_cast<uint32_t>(_mm_extract_epi32(eights, 1));
+}
+
+inline constexpr auto pow10_u64 = []
+{
+    std::array<uint64_t, 20> table{};
+    table[0] = 1;
+    for (size_t i = 1; i < table.size(); ++i)
+        table[i] = table[i - 1] * 10;
+    return table;
+}();
+
+// powers of ten up to 1e22 are exact in double
+inline constexpr std::array<double, 23> pow10_f64 = {
+    1e0,  1e1,  1e2,  1e3,  1e4,  1e5,  1e6,  1e7,  1e8,  1e9,  1e10, 1e11,
+    1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22};
+
+// [sign] digits [. digits] [e [sign] digits] with at most 19 significant digits, converted
+// exactly when the mantissa and power of ten fit double (Clinger's fast path); false means
+// the token needs the slow path, which also reports malformed input. The fraction and
+// exponent are always parsed, as empty runs when absent, so mixed formats do not mispredict
+inline bool parse_float_fast(const char *p, const char *end, float &out)
+{
+    const bool negative = *p == '-';
+    p += (*p == '-') | (*p == '+');
+    const size_t int_len = digit_run(p);
+    uint64_t mantissa = parse_digits(p, int_len);
+    p += int_len;
+
+    size_t frac_len = 0;
+    if (p < end && *p == '.')
+    {
+        ++p;
+        frac_len = digit_run(p);
+        mantissa = mantissa * pow10_u64[frac_len] + parse_digits(p, frac_len);
+        p += frac_len;
+    }
+    const size_t digits = int_len + frac_len;
+    if (digits == 0 || digits > 19 || int_len == 16 || frac_len == 16)
+        return false;
+
+    int exponent = 0;
+    if (p < end && (*p == 'e' || *p == 'E'))
+    {
+        ++p;
+        const bool negative_exponent = *p == '-';
+        p += (*p == '-') | (*p == '+');
+        const char *exp_begin = p;
+        for (; p < end && p - exp_begin < 3 && static_cast<unsigned>(*p - '0') < 10; ++p)
+            exponent = exponent * 10 + (*p - '0');
+        if (p == exp_begin)
+            return false;
+        exponent = negative_exponent ? -exponent : exponent;
+    }
+    if (p != end)
+        return false;
+
+    const int e10 = exponent - static_cast<int>(frac_len);
+    if (mantissa <= (uint64_t{1} << 24) && e10 >= -10 && e10 <= 10)
+    {
+        // mantissa and 10^|e10| are exact floats, so one float operation rounds correctly
+        const auto m = static_cast<float>(mantissa);
+        const auto scale = static_cast<float>(pow10_f64[static_cast<size_t>(std::abs(e10))]);
+        const float result = e10 < 0 ? m / scale : m * scale;
+        out = negative ? -result : result;
+        return true;
+    }
+    if (mantissa > (uint64_t{1} << 53) || e10 < -22 || e10 > 22)
+        return false;
+    const double scale = pow10_f64[static_cast<size_t>(std::abs(e10))];
+    const auto m = static_cast<double>(mantissa);
+    const double value = e10 < 0 ? m / scale : m * scale;
+
+    // value is the correctly rounded double; rounding it again to float is only wrong when
+    // it landed exactly on a float midpoint, or in the subnormal and overflow ranges
+    const auto bits = std::bit_cast<uint64_t>(value);
+    if ((bits & 0x1FFFFFFFu) == 0x10000000u)
+        return false;
+    if (value != 0.0 && (value < std::numeric_limits<float>::min() ||
+                         value > std::numeric_limits<float>::max()))
+        return false;
+    const auto result = static_cast<float>(value);
+    out = negative ? -result : result;
+    return true;
+}
+
+[[noreturn]] inline void malformed_number(const char *begin, const char *end)
+{
+    throw std::invalid_argument("parse_floats: malformed number '" + std::string(begin, end) +
+                                "'");
+}
+
+// from_chars for everything the fast path declines: long mantissas, large exponents,
+// inf/nan, and values outside the float range, which saturate to inf or flush to zero
+inline float parse_float_slow(const char *begin, const char *end)
+{
+    const char *p = begin;
+    if (p != end && *p == '+')
+    {
+        ++p;
+        if (p != end && *p == '-')
+            malformed_number(begin, end);
+    }
+    float value = 0.0f;
+    const auto [ptr, ec] = std::from_chars(p, end, value);
+    if (ptr != end)
+        malformed_number(begin, end);
+    if (ec == std::errc::result_out_of_range)
+    {
+        double wide = 0.0;
+        if (std::from_chars(p, end, wide).ec == std::errc())
+            return static_cast<float>(wide);
+        // beyond double as well: underflow if the exponent is negative, or without an
+        // exponent if every digit before the point is zero
+        const std::string_view token(p, static_cast<size_t>(end - p));
+        const size_t e = token.find_first_of("eE");
+        const bool tiny = e != std::string_view::npos
+                              ? token.find('-', e) != std::string_view::npos
+                              : token.find_first_of("123456789") > token.find('.');
+        const bool negative = *p == '-';
+        const float magnitude = tiny ? 0.0f : std::numeric_limits<float>::infinity();
+        return negative ? -magnitude : magnitude;
+    }
+    if (ec != std::errc())
+        malformed_number(begin, end);
+    return value;
+}
+
+// parses the token [begin, end) of a text ending at text_end
+inline float parse_token(const char *begin, const char *end, const char *text_end)
+{
+    const auto len = static_cast<size_t>(end - begin);
+    float value = 0.0f;
+    if (len <= fast_token_length)
+    {
+        if (static_cast<size_t>(text_end - end) >= parse_overread)
+        {
+            if (parse_float_fast(begin, end, value))
+                return value;
+        }
+        else
+        {
+            // too close to the end of the text for the 16-byte digit loads
+            std::array<char, fast_token_length + parse_overread> padded{};
+            std::memcpy(padded.data(), begin, len);
+            if (parse_float_fast(padded.data(), padded.data() + len, value))
+                return value;
+        }
+    }
+    return parse_float_slow(begin, end);
+}
+
+} // namespace detail
+
+// parse one number: [sign] digits [. digits] [e [sign] digits], or inf/nan
+inline float parse_float(std::string_view token)
+{
+    if (token.empty())
+        throw std::invalid_argument("parse_float: empty token");
+    return detail::parse_token(token.data(), token.data() + token.size(),
+                               token.data() + token.size());
+}
+
+// every number in text, separated by whitespace and/or the delimiter; empty fields are skipped
+inline aligned_vector<float> parse_floats(std::string_view text, char delimiter = ',')
+{
+    SIMDLIB_PERF_SCOPE("parse_floats", text.size());
+    aligned_vector<float> values;
+    values.reserve(text.size() / 8);
+    const char *text_end = text.data() + text.size();
+    detail::for_each_token(text, delimiter, [&](const char *begin, const char *end, bool, size_t)
+                           { values.push_back(detail::parse_token(begin, end, text_end)); });
+    return values;
+}
+
+// the columns of a delimited numeric table, rows end at '\n' and blank lines are skipped;
+// every row must have the same number of fields, and with a non-whitespace delimiter
+// exactly one delimiter must separate neighbouring fields
+inline std::vector<aligned_vector<float>> parse_columns(std::string_view text,
+                                                        char delimiter = ',')
+{
+    SIMDLIB_PERF_SCOPE("parse_columns", text.size());
+    std::vector<aligned_vector<float>> columns;
+    size_t rows = 0;
+    size_t field = 0;
+    const bool strict = delimiter != ' ' && delimiter != '\t';
+    const char *text_end = text.data() + text.size();
+    const auto fail = [&](const std::string &what)
+    { throw std::invalid_argument("parse_columns: row " + std::to_string(rows) + " " + what); };
+    const auto check_row = [&]
+    {
+        if (rows > 0 && field != columns.size())
+            fail("has " + std::to_string(field) + " fields, expected " +
+                 std::to_string(columns.size()));
+    };
+    const auto add_field = [&](const char *begin, const char *end, bool new_row, size_t delimiters)
+    {
+        if (new_row)
+        {
+            check_row();
+            ++rows;
+            field = 0;
+        }
+        if (strict && delimiters != (new_row ? 0 : 1))
+            fail("has an empty field");
+        if (rows == 1)
+            columns.emplace_back();
+        else if (field == columns.size())
+            fail("has more than " + std::to_string(columns.size()) + " fields");
+        columns[field++].push_back(detail::parse_token(begin, end, text_end));
+    };
+    detail::for_each_token(text, delimiter, add_field);
+    check_row();
+    return columns;
+}
+
+} // namespace simdlib
@@ -0,0 +1,383 @@
+#pragma once
+
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <map>
+#include <mutex>
+#include <ostream>
+#include <sstream>
+#include <string>
+#include <utility>
+
+#ifdef __linux__
+#include <cpuid.h>
+#include <cstring>
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+// Kernel instrumentation with hardware performance counters. Building with SIMDLIB_PERF
+// defined (the SIMDLIB_ENABLE_PERF cmake option) makes every SIMDLIB_PERF_SCOPE in the
+// library record calls, time, bytes and counter deltas into perf_registry::instance();
+// otherwise the scopes compile to nothing.
+
+namespace simdlib
+{
+
+enum class perf_event : size_t
+{
+    cycles,
+    instructions,
+    l1d_misses,
+    llc_misses,
+    // FP arithmetic instructions retired, Intel only: a packed instruction counts once however
+    // many lanes it has, an fma counts once, and 512-bit instructions are not counted, so this
+    // is not a flop count
+    fp_instructions,
+    count
+};
+
+constexpr size_t perf_event_count = static_cast<size_t>(perf_event::count);
+
+inline const char *perf_event_name(perf_event event)
+{
+    constexpr std::array<const char *, perf_event_count> names = {
+        "cycles", "instructions", "l1d_misses", "llc_misses", "fp_instructions"};
+    return names[static_cast<size_t>(event)];
+}
+
+// counter values over some interval, events that could not be opened are left unset
+struct perf_sample
+{
+    std::array<uint64_t, perf_event_count> values{};
+    std::array<bool, perf_event_count> valid{};
+
+    [[nodiscard]] bool has(perf_event event) const
+    {
+        return valid[static_cast<size_t>(event)];
+    }
+
+    [[nodiscard]] uint64_t operator[](perf_event event) const
+    {
+        return values[static_cast<size_t>(event)];
+    }
+};
+
+namespace detail
+{
+
+#ifdef __linux__
+inline bool intel_cpu()
+{
+    unsigned int eax = 0;
+    unsigned int ebx = 0;
+    unsigned int ecx = 0;
+    unsigned int edx = 0;
+    if (!__get_cpuid(0, &eax, &ebx, &ecx, &edx))
+        return false;
+    char vendor[13] = {};
+    std::memcpy(vendor, &ebx, 4);
+    std::memcpy(vendor + 4, &edx, 4);
+    std::memcpy(vendor + 8, &ecx, 4);
+    return std::strcmp(vendor, "GenuineIntel") == 0;
+}
+
+inline perf_event_attr perf_attr(perf_event event)
+{
+    perf_event_attr attr{};
+    attr.size = sizeof(attr);
+    attr.disabled = 1;
+    attr.exclude_kernel = 1; // lets perf_event_paranoid <= 2 count our own threads
+    attr.exclude_hv = 1;
+    attr.read_format = PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+    switch (event)
+    {
+    case perf_event::cycles:
+        attr.type = PERF_TYPE_HARDWARE;
+        attr.config = PERF_COUNT_HW_CPU_CYCLES;
+        break;
+    case perf_event::instructions:
+        attr.type = PERF_TYPE_HARDWARE;
+        attr.config = PERF_COUNT_HW_INSTRUCTIONS;
+        break;
+    case perf_event::l1d_misses:
+        attr.type = PERF_TYPE_HW_CACHE;
+        attr.config = PERF_COUNT_HW_CACHE_L1D | (PERF_COUNT_HW_CACHE_OP_READ << 8) |
+                      (PERF_COUNT_HW_CACHE_RESULT_MISS << 16);
+        break;
+    case perf_event::llc_misses:
+        attr.type = PERF_TYPE_HARDWARE;
+        attr.config = PERF_COUNT_HW_CACHE_MISSES;
+        break;
+    default:
+        // FP_ARITH_INST_RETIRED (event 0xc7), umask 0x3f: scalar and 128/256-bit packed,
+        // single and double; the 512-bit umasks 0x40 and 0x80 are left out
+        attr.type = PERF_TYPE_RAW;
+        attr.config = 0x3fc7;
+        break;
+    }
+    return attr;
+}
+#endif
+
+} // namespace detail
+
+// per-thread counter set for the calling thread, events the kernel refuses are skipped
+class perf_counters
+{
+  public:
+    perf_counters()
+    {
+        fds_.fill(-1);
+#ifdef __linux__
+        const bool intel = detail::intel_cpu();
+        for (size_t e = 0; e < perf_event_count; ++e)
+        {
+            const auto event = static_cast<perf_event>(e);
+            if (event == perf_event::fp_instructions && !intel)
+                continue;
+            perf_event_attr attr = detail::perf_attr(event);
+            fds_[e] = static_cast<int>(syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0));
+            if (fds_[e] >= 0)
+                ioctl(fds_[e], PERF_EVENT_IOC_ENABLE, 0);
+        }
+#endif
+    }
+
+    perf_counters(const perf_counters &) = delete;
+    perf_counters &operator=(const perf_counters &) = delete;
+
+    ~perf_counters()
+    {
+#ifdef __linux__
+        for (const int fd : fds_)
+        {
+            if (fd >= 0)
+                close(fd);
+        }
+#endif
+    }
+
+    // true if at least one event is being counted
+    [[nodiscard]] bool available() const
+    {
+        for (const int fd : fds_)
+        {
+            if (fd >= 0)
+                return true;
+        }
+        return false;
+    }
+
+    // running totals since construction, scaled up when the kernel multiplexed an event
+    [[nodiscard]] perf_sample read() const
+    {
+        perf_sample sample;
+#ifdef __linux__
+        for (size_t e = 0; e < perf_event_count; ++e)
+        {
+            uint64_t buf[3] = {}; // value, time enabled, time running
+            if (fds_[e] < 0 || ::read(fds_[e], buf, sizeof(buf)) != sizeof(buf))
+                continue;
+            double value = static_cast<double>(buf[0]);
+            if (buf[2] != 0 && buf[2] < buf[1])
+                value *= static_cast<double>(buf[1]) / static_cast<double>(buf[2]);
+            sample.values[e] = static_cast<uint64_t>(value);
+            sample.valid[e] = true;
+        }
+#endif
+        return sample;
+    }
+
+    // counters of the calling thread, opened on first use
+    static perf_counters &thread_local_instance()
+    {
+        thread_local perf_counters counters;
+        return counters;
+    }
+
+  private:
+    std::array<int, perf_event_count> fds_{};
+};
+
+// end - begin for every event valid in both samples
+inline perf_sample operator-(const perf_sample &end, const perf_sample &begin)
+{
+    perf_sample delta;
+    for (size_t e = 0; e < perf_event_count; ++e)
+    {
+        delta.valid[e] = end.valid[e] && begin.valid[e];
+        delta.values[e] = delta.valid[e] ? end.values[e] - begin.values[e] : 0;
+    }
+    return delta;
+}
+
+struct kernel_stats
+{
+    uint64_t calls = 0;
+    uint64_t nanoseconds = 0;
+    uint64_t bytes = 0; // bytes read and written as declared by the kernel
+    perf_sample counters;
+
+    // bytes moved per cycle and instructions per cycle tell bandwidth- from compute-bound
+    [[nodiscard]] double ipc() const
+    {
+        const uint64_t cycles = counters[perf_event::cycles];
+        return cycles == 0 ? 0.0
+                           : static_cast<double>(counters[perf_event::instructions]) /
+                                 static_cast<double>(cycles);
+    }
+
+    [[nodiscard]] double bytes_per_cycle() const
+    {
+        const uint64_t cycles = counters[perf_event::cycles];
+        return cycles == 0 ? 0.0 : static_cast<double>(bytes) / static_cast<double>(cycles);
+    }
+
+    [[nodiscard]] double gigabytes_per_second() const
+    {
+        return nanoseconds == 0 ? 0.0
+                                : static_cast<double>(bytes) / static_cast<double>(nanoseconds);
+    }
+};
+
+// process-wide stats keyed by kernel name
+class perf_registry
+{
+  public:
+    static perf_registry &instance()
+    {
+        static perf_registry registry;
+        return registry;
+    }
+
+    void record(const std::string &kernel, uint64_t nanoseconds, uint64_t bytes,
+                const perf_sample &delta)
+    {
+        const std::lock_guard lock(mutex_);
+        kernel_stats &stats = stats_[kernel];
+        if (stats.calls == 0)
+            stats.counters.valid = delta.valid;
+        ++stats.calls;
+        stats.nanoseconds += nanoseconds;
+        stats.bytes += bytes;
+        for (size_t e = 0; e < perf_event_count; ++e)
+        {
+            stats.counters.valid[e] = stats.counters.valid[e] && delta.valid[e];
+            stats.counters.values[e] += delta.values[e];
+        }
+    }
+
+    [[nodiscard]] std::map<std::string, kernel_stats> snapshot() const
+    {
+        const std::lock_guard lock(mutex_);
+        return stats_;
+    }
+
+    void reset()
+    {
+        const std::lock_guard lock(mutex_);
+        stats_.clear();
+    }
+
+    // {"kernel": {"calls": .., "nanoseconds": .., "bytes": .., "cycles": .., ...}, ...},
+    // counters that were not available are omitted
+    void dump_json(std::ostream &os) const
+    {
+        constexpr const char *hex_digits = "0123456789abcdef";
+        const auto stats = snapshot();
+        os << "{";
+        bool first = true;
+        for (const auto &[name, s] : stats)
+        {
+            os << (first ? "\n" : ",\n") << "  \"";
+            for (const char c : name)
+            {
+                // control characters are not allowed raw inside a JSON string
+                const auto byte = static_cast<unsigned char>(c);
+                if (byte < 0x20)
+                    os << "\\u00" << hex_digits[byte >> 4] << hex_digits[byte & 15];
+                else if (c == '"' || c == '\\')
+                    os << '\\' << c;
+                else
+                    os << c;
+            }
+            os << "\": {\"calls\": " << s.calls << ", \"nanoseconds\": " << s.nanoseconds
+               << ", \"bytes\": " << s.bytes;
+            for (size_t e = 0; e < perf_event_count; ++e)
+            {
+                if (s.counters.valid[e])
+                    os << ", \"" << perf_event_name(static_cast<perf_event>(e))
+                       << "\": " << s.counters.values[e];
+            }
+            if (s.counters.has(perf_event::cycles) && s.counters.has(perf_event::instructions))
+                os << ", \"ipc\": " << s.ipc() << ", \"bytes_per_cycle\": " << s.bytes_per_cycle();
+            os << "}";
+            first = false;
+        }
+        os << (first ? "}" : "\n}") << "\n";
+    }
+
+    [[nodiscard]] std::string to_json() const
+    {
+        std::ostringstream os;
+        dump_json(os);
+        return os.str();
+    }
+
+  private:
+    perf_registry() = default;
+
+    mutable std::mutex mutex_;
+    std::map<std::string, kernel_stats> stats_;
+};
+
+// records one kernel call into the registry on destruction; counters cover the calling
+// thread only, so worker threads of a multithreaded call show up in time but not in events
+class perf_scope
+{
+  public:
+    explicit perf_scope(const char *kernel, uint64_t bytes = 0)
+        : kernel_(kernel), bytes_(bytes), counters_(perf_counters::thread_local_instance()),
+          begin_(counters_.read()), start_(std::chrono::steady_clock::now())
+    {
+    }
+
+    perf_scope(const perf_scope &) = delete;
+    perf_scope &operator=(const perf_scope &) = delete;
+
+    ~perf_scope()
+    {
+        const auto elapsed = std::chrono::steady_clock::now() - start_;
+        const perf_sample delta = counters_.read() - begin_;
+        perf_registry::instance().record(
+            kernel_,
+            static_cast<uint64_t>(
+                std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count()),
+            bytes_, delta);
+    }
+
+  private:
+    const char *kernel_;
+    uint64_t bytes_;
+    const perf_counters &counters_;
+    perf_sample begin_;
+    std::chrono::steady_clock::time_point start_;
+};
+
+} // namespace simdlib
+
+#define SIMDLIB_PERF_CONCAT_IMPL(a, b) a##b
+#define SIMDLIB_PERF_CONCAT(a, b) SIMDLIB_PERF_CONCAT_IMPL(a, b)
+
+#ifdef SIMDLIB_PERF
+#define SIMDLIB_PERF_SCOPE(kernel, bytes)                                                          \
+    const ::simdlib::perf_scope SIMDLIB_PERF_CONCAT(simdlib_perf_scope_, __LINE__)(kernel, bytes)
+#else
+// the arguments stay unevaluated but count as used, so a parameter that only names the kernel
+// does not warn when the counters are off
+#define SIMDLIB_PERF_SCOPE(kernel, bytes) static_cast<void>(sizeof((kernel), (bytes)))
+#endif
@@ -0,0 +1,304 @@
+#pragma once
+
+#include "simd_allocator.hpp"
+#include "simd_perf.hpp"
+#include "simd_reduce.hpp"
+#include "simd_vector.hpp"
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <span>
+#include <stdexcept>
+#include <thread>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+namespace simdlib
+{
+
+struct pipeline_options
+{
+    // bytes per chunk buffer, small enough that a chunk and its spare stay in L2 from one stage
+    // to the next
+    size_t chunk_bytes = size_t{1} << 16;
+    // chunks in flight, 0 for two per stage so each stage can work on one while its successor
+    // drains the other
+    size_t chunks = 0;
+};
+
+namespace detail
+{
+class pipeline_state;
+}
+
+// one chunk of a stream: a buffer of capacity() bytes with the first size() in use, plus a spare
+// buffer of the same capacity for stages whose output does not fit in place, such as a decode
+// that widens its input
+class pipeline_chunk
+{
+  public:
+    explicit pipeline_chunk(size_t capacity) : current_(capacity), spare_(capacity)
+    {
+    }
+
+    // position of the chunk in the stream, counting from 0
+    [[nodiscard]] size_t index() const
+    {
+        return index_;
+    }
+
+    [[nodiscard]] size_t capacity() const
+    {
+        return current_.size();
+    }
+
+    [[nodiscard]] size_t size() const
+    {
+        return size_;
+    }
+
+    // the bytes in use viewed as T
+    template <typename T> [[nodiscard]] std::span<T> values()
+    {
+        return {reinterpret_cast<T *>(current_.data()), size_ / sizeof(T)};
+    }
+
+    // puts count T in use and returns them, for a source to fill
+    template <typename T> std::span<T> resize(size_t count)
+    {
+        check_fits(count, sizeof(T));
+        size_ = count * sizeof(T);
+        return values<T>();
+    }
+
+    // count T of the spare buffer to write into; commit<T>(count) then makes them current
+    template <typename T> [[nodiscard]] std::span<T> spare(size_t count)
+    {
+        check_fits(count, sizeof(T));
+        return {reinterpret_cast<T *>(spare_.data()), count};
+    }
+
+    template <typename T> void commit(size_t count)
+    {
+        check_fits(count, sizeof(T));
+        std::swap(current_, spare_);
+        size_ = count * sizeof(T);
+    }
+
+  private:
+    friend class detail::pipeline_state;
+
+    void check_fits(size_t count, size_t size) const
+    {
+        if (count > capacity() / size)
+            throw std::invalid_argument("pipeline_chunk: more values than the chunk holds");
+    }
+
+    aligned_vector<std::byte> current_;
+    aligned_vector<std::byte> spare_;
+    size_t size_ = 0;
+    size_t index_ = 0;
+};
+
+namespace detail
+{
+
+// chunks handed from one pipeline thread to the next; the pool bounds how many exist, so the
+// queue needs no bound of its own
+class chunk_queue
+{
+  public:
+    void push(pipeline_chunk *chunk)
+    {
+        {
+            const std::lock_guard lock(mutex_);
+            if (aborted_)
+                return;
+            chunks_.push_back(chunk);
+        }
+        ready_.notify_one();
+    }
+
+    // the next chunk, nullptr once the queue is closed and drained or aborted
+    pipeline_chunk *pop()
+    {
+        std::unique_lock lock(mutex_);
+        ready_.wait(lock, [this] { return !chunks_.empty() || closed_ || aborted_; });
+        if (aborted_ || chunks_.empty())
+            return nullptr;
+        pipeline_chunk *chunk = chunks_.front();
+        chunks_.pop_front();
+        return chunk;
+    }
+
+    // no more chunks will be pushed
+    void close()
+    {
+        {
+            const std::lock_guard lock(mutex_);
+            closed_ = true;
+        }
+        ready_.notify_all();
+    }
+
+    // drops the queued chunks and wakes every waiter
+    void abort()
+    {
+        {
+            const std::lock_guard lock(mutex_);
+            aborted_ = true;
+            chunks_.clear();
+        }
+        ready_.notify_all();
+    }
+
+  private:
+    std::mutex mutex_;
+    std::condition_variable ready_;
+    std::deque<pipeline_chunk *> chunks_;
+    bool closed_ = false;
+    bool aborted_ = false;
+};
+
+// the chunk pool and the queues of a running pipeline: queue 0 holds the free chunks the source
+// fills, queue s + 1 feeds stage s, and the last stage returns its chunks to queue 0
+class pipeline_state
+{
+  public:
+    pipeline_state(size_t stages, size_t chunks, size_t chunk_bytes) : queues_(stages + 1)
+    {
+        pool_.reserve(chunks);
+        for (size_t c = 0; c < chunks; ++c)
+        {
+            pool_.push_back(std::make_unique<pipeline_chunk>(chunk_bytes));
+            queues_[0].push(pool_.back().get());
+        }
+    }
+
+    // fills chunks from source until it returns false, passing each to the first stage
+    template <typename Source> size_t run_source(Source &source)
+    {
+        size_t produced = 0;
+        guard(
+            [&]
+            {
+                while (pipeline_chunk *chunk = queues_[0].pop())
+                {
+                    chunk->size_ = 0;
+                    chunk->index_ = produced;
+                    if (!source(*chunk))
+                        break;
+                    ++produced;
+                    queues_[1].push(chunk);
+                }
+            });
+        queues_[1].close();
+        return produced;
+    }
+
+    // runs stage s on each chunk in stream order and hands it on, the last stage back to the pool
+    template <typename Stage> void run_stage(size_t s, Stage &stage)
+    {
+        const bool last = s + 2 == queues_.size();
+        chunk_queue &out = queues_[last ? 0 : s + 2];
+        guard(
+            [&]
+            {
+                while (pipeline_chunk *chunk = queues_[s + 1].pop())
+                {
+                    stage(*chunk);
+                    out.push(chunk);
+                }
+            });
+        if (!last)
+            out.close();
+    }
+
+    // rethrows the first exception any thread hit
+    void rethrow()
+    {
+        if (error_)
+            std::rethrow_exception(error_);
+    }
+
+  private:
+    template <typename Body> void guard(Body &&body)
+    {
+        try
+        {
+            body();
+        }
+        catch (...)
+        {
+            {
+                const std::lock_guard lock(error_mutex_);
+                if (!error_)
+                    error_ = std::current_exception();
+            }
+            for (auto &queue : queues_)
+                queue.abort();
+        }
+    }
+
+    std::vector<std::unique_ptr<pipeline_chunk>> pool_;
+    std::vector<chunk_queue> queues_;
+    std::mutex error_mutex_;
+    std::exception_ptr error_;
+};
+
+template <typename Source, typename Stages, size_t... S>
+size_t run_pipeline_threads(pipeline_state &state, Source &source, Stages &stages,
+                            std::index_sequence<S...>)
+{
+    size_t produced = 0;
+    {
+        std::vector<std::jthread> workers;
+        workers.reserve(sizeof...(S));
+        (workers.emplace_back([&state, &stages] { state.run_stage(S, std::get<S>(stages)); }),
+         ...);
+        produced = state.run_source(source);
+    }
+    return produced;
+}
+
+} // namespace detail
+
+// streams chunks through source and then each stage in order, the source on the calling thread and
+// each stage on its own, so reading chunk k + 1 overlaps the math on chunk k while no stage output
+// is ever materialized in full. source(pipeline_chunk &) fills a recycled chunk and returns false
+// once the stream has ended; each stage(pipeline_chunk &) works on it in place or through its spare
+// buffer, and sees the chunks in stream order. An exception in any callable stops the pipeline and
+// is rethrown here. Returns the number of chunks the source produced.
+template <typename Source, typename... Stages>
+size_t run_pipeline(const pipeline_options &options, Source &&source, Stages &&...stages)
+{
+    static_assert(sizeof...(Stages) > 0, "run_pipeline: at least one stage must follow the source");
+    if (options.chunk_bytes == 0)
+        throw std::invalid_argument("run_pipeline: chunk_bytes must be positive");
+    SIMDLIB_PERF_SCOPE("run_pipeline", 0);
+
+    const size_t chunks = options.chunks != 0 ? options.chunks : 2 * (sizeof...(Stages) + 1);
+    detail::pipeline_state state(sizeof...(Stages), chunks, options.chunk_bytes);
+    std::tuple<Stages &...> stage_refs(stages...);
+    const size_t produced = detail::run_pipeline_threads(
+        state, source, stage_refs, std::make_index_sequence<sizeof...(Stages)>());
+    state.rethrow();
+    return produced;
+}
+
+// a stage applying op to a chunk of floats in place, eight lanes at a time; op maps
+// simd_vector<float, 8> to simd_vector<float, 8> as in transform_values
+template <typename Op> auto pipeline_transform(Op op)
+{
+    return [op](pipeline_chunk &chunk) mutable
+    {
+        const std::span<float> values = chunk.values<float>();
+        detail::transform_block(values.data(), values.data(), values.size(), op);
+    };
+}
+
+} // namespace simdlib
@@ -0,0 +1,310 @@
+#pragma once
+
+#include "simd_perf.hpp"
+#include "simd_vector.hpp"
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <span>
+#include <stdexcept>
+#include <type_traits>
+
+namespace simdlib
+{
+
+// affine quantization: real = scale * (q - zero_point)
+struct quant_params
+{
+    float scale = 1.0f;
+    int32_t zero_point = 0;
+};
+
+template <typename Q>
+struct is_quantized_type
+    : std::integral_constant<bool, std::is_same_v<Q, int8_t> || std::is_same_v<Q, uint8_t>>
+{
+};
+
+namespace detail
+{
+
+// horizontal sum of eight int32 lanes
+inline int32_t horizontal_sum_epi32(__m256i vec)
+{
+    __m128i sums = _mm_add_epi32(_mm256_castsi256_si128(vec), _mm256_extractf128_si256(vec, 1));
+    sums = _mm_add_epi32(sums, _mm_shuffle_epi32(sums, _MM_SHUFFLE(1, 0, 3, 2)));
+    sums = _mm_add_epi32(sums, _mm_shuffle_epi32(sums, _MM_SHUFFLE(2, 3, 0, 1)));
+    return _mm_cvtsi128_si32(sums);
+}
+
+// eight floats scaled, shifted, clamped to Q's range and rounded to nearest even
+template <typename Q> struct quantizer
+{
+    simd_vector<float, AVX_SIZE> inv_scale;
+    simd_vector<float, AVX_SIZE> zero_point;
+    simd_vector<float, AVX_SIZE> lo{static_cast<float>(std::numeric_limits<Q>::min())};
+    simd_vector<float, AVX_SIZE> hi{static_cast<float>(std::numeric_limits<Q>::max())};
+
+    explicit quantizer(quant_params params)
+        : inv_scale(1.0f / params.scale), zero_point(static_cast<float>(params.zero_point))
+    {
+    }
+
+    [[nodiscard]] __m256i to_int(const float *src) const
+    {
+        const simd_vector<float, AVX_SIZE> q =
+            simd_vector<float, AVX_SIZE>(_mm256_loadu_ps(src)).fmadd(inv_scale, zero_point);
+        // max first so NaN lands on the lower bound
+        return _mm256_cvtps_epi32(_mm256_min_ps(_mm256_max_ps(q.data, lo.data), hi.data));
+    }
+
+    void store8(const float *src, Q *dst) const
+    {
+        const __m256i q = to_int(src);
+        const __m128i words =
+            _mm_packs_epi32(_mm256_castsi256_si128(q), _mm256_extractf128_si256(q, 1));
+        const __m128i bytes = std::is_signed_v<Q> ? _mm_packs_epi16(words, words)
+                                                  : _mm_packus_epi16(words, words);
+        _mm_storel_epi64(reinterpret_cast<__m128i *>(dst), bytes);
+    }
+};
+
+template <typename Q>
+inline void quantize_range(const float *src, Q *dst, size_t n, quant_params params)
+{
+    const quantizer<Q> quant(params);
+    size_t i = 0;
+#ifdef __AVX2__
+    const __m256i order = _mm256_setr_epi32(0, 4, 1, 5, 2, 6, 3, 7);
+    for (; i + 4 * AVX_SIZE <= n; i += 4 * AVX_SIZE)
+    {
+        const __m256i ab = _mm256_packs_epi32(quant.to_int(src + i), quant.to_int(src + i + 8));
+        const __m256i cd =
+            _mm256_packs_epi32(quant.to_int(src + i + 16), quant.to_int(src + i + 24));
+        const __m256i bytes =
+            std::is_signed_v<Q> ? _mm256_packs_epi16(ab, cd) : _mm256_packus_epi16(ab, cd);
+        // packs interleave the 128-bit lanes, put the dwords back in source order
+        _mm256_storeu_si256(reinterpret_cast<__m256i *>(dst + i),
+                            _mm256_permutevar8x32_epi32(bytes, order));
+    }
+#endif
+    for (; i + AVX_SIZE <= n; i += AVX_SIZE)
+        quant.store8(src + i, dst + i);
+    if (i < n)
+    {
+        // run the tail through the vector path so rounding matches the body exactly
+        std::array<float, AVX_SIZE> tail_src{};
+        std::array<Q, AVX_SIZE> tail_dst{};
+        std::copy(src + i, src + n, tail_src.begin());
+        quant.store8(tail_src.data(), tail_dst.data());
+        std::copy(tail_dst.begin(), tail_dst.begin() + static_cast<std::ptrdiff_t>(n - i), dst + i);
+    }
+}
+
+// eight quantized values widened to float lanes
+template <typename Q> inline simd_vector<float, AVX_SIZE> widen8(const Q *src)
+{
+    const __m128i bytes = _mm_loadl_epi64(reinterpret_cast<const __m128i *>(src));
+#ifdef __AVX2__
+    const __m256i ints =
+        std::is_signed_v<Q> ? _mm256_cvtepi8_epi32(bytes) : _mm256_cvtepu8_epi32(bytes);
+#else
+    const __m128i upper = _mm_srli_si128(bytes, 4);
+    const __m256i ints =
+        std::is_signed_v<Q>
+            ? _mm256_setr_m128i(_mm_cvtepi8_epi32(bytes), _mm_cvtepi8_epi32(upper))
+            : _mm256_setr_m128i(_mm_cvtepu8_epi32(bytes), _mm_cvtepu8_epi32(upper));
+#endif
+    return simd_vector<float, AVX_SIZE>(_mm256_cvtepi32_ps(ints));
+}
+
+template <typename Q>
+inline void dequantize_range(const Q *src, float *dst, size_t n, quant_params params)
+{
+    const simd_vector<float, AVX_SIZE> scale(params.scale);
+    const simd_vector<float, AVX_SIZE> zero_point(static_cast<float>(params.zero_point));
+    size_t i = 0;
+    for (; i + AVX_SIZE <= n; i += AVX_SIZE)
+        _mm256_storeu_ps(dst + i, ((widen8(src + i) - zero_point) * scale).data);
+    for (; i < n; ++i)
+        dst[i] = static_cast<float>(static_cast<int32_t>(src[i]) - params.zero_point) *
+                 params.scale;
+}
+
+inline void check_channels(size_t size, size_t channels)
+{
+    if (channels == 0 || size % channels != 0)
+        throw std::invalid_argument("per-channel quantization: size is not a multiple of the "
+                                    "channel count");
+}
+
+} // namespace detail
+
+// scale and zero point mapping [min(values, 0), max(values, 0)] onto Q's full range
+template <typename Q> quant_params compute_quant_params(std::span<const float> values)
+{
+    static_assert(is_quantized_type<Q>::value, "quantized type must be int8_t or uint8_t");
+    simd_vector<float, AVX_SIZE> lo_vec;
+    simd_vector<float, AVX_SIZE> hi_vec;
+    size_t i = 0;
+    for (; i + AVX_SIZE <= values.size(); i += AVX_SIZE)
+    {
+        const __m256 vec = _mm256_loadu_ps(values.data() + i);
+        lo_vec.data = _mm256_min_ps(lo_vec.data, vec);
+        hi_vec.data = _mm256_max_ps(hi_vec.data, vec);
+    }
+    float lo = lo_vec.horizontal_min();
+    float hi = hi_vec.horizontal_max();
+    for (; i < values.size(); ++i)
+    {
+        lo = std::min(lo, values[i]);
+        hi = std::max(hi, values[i]);
+    }
+
+    constexpr auto qmin = static_cast<float>(std::numeric_limits<Q>::min());
+    constexpr auto qmax = static_cast<float>(std::numeric_limits<Q>::max());
+    quant_params params;
+    params.scale = hi > lo ? (hi - lo) / (qmax - qmin) : 1.0f;
+    params.zero_point =
+        static_cast<int32_t>(std::clamp(std::nearbyint(qmin - lo / params.scale), qmin, qmax));
+    return params;
+}
+
+// per-tensor quantization, saturating to Q's range
+template <typename Q>
+void quantize(std::span<const float> src, std::span<Q> dst, quant_params params)
+{
+    static_assert(is_quantized_type<Q>::value, "quantized type must be int8_t or uint8_t");
+    if (src.size() != dst.size())
+        throw std::invalid_argument("quantize: buffers differ in size");
+    SIMDLIB_PERF_SCOPE("quantize", src.size_bytes() + dst.size_bytes());
+    detail::quantize_range(src.data(), dst.data(), src.size(), params);
+}
+
+// per-tensor dequantization
+template <typename Q>
+void dequantize(std::span<const Q> src, std::span<float> dst, quant_params params)
+{
+    static_assert(is_quantized_type<Q>::value, "quantized type must be int8_t or uint8_t");
+    if (src.size() != dst.size())
+        throw std::invalid_argument("dequantize: buffers differ in size");
+    SIMDLIB_PERF_SCOPE("dequantize", src.size_bytes() + dst.size_bytes());
+    detail::dequantize_range(src.data(), dst.data(), src.size(), params);
+}
+
+// per-channel quantization of a row-major [channels][size / channels] tensor
+template <typename Q>
+void quantize_per_channel(std::span<const float> src, std::span<Q> dst,
+                          std::span<const quant_params> params)
+{
+    static_assert(is_quantized_type<Q>::value, "quantized type must be int8_t or uint8_t");
+    if (src.size() != dst.size())
+        throw std::invalid_argument("quantize_per_channel: buffers differ in size");
+    SIMDLIB_PERF_SCOPE("quantize_per_channel", src.size_bytes() + dst.size_bytes());
+    detail::check_channels(src.size(), params.size());
+    const size_t inner = src.size() / params.size();
+    for (size_t c = 0; c < params.size(); ++c)
+        detail::quantize_range(src.data() + c * inner, dst.data() + c * inner, inner, params[c]);
+}
+
+// per-channel dequantization of a row-major [channels][size / channels] tensor
+template <typename Q>
+void dequantize_per_channel(std::span<const Q> src, std::span<float> dst,
+                            std::span<const quant_params> params)
+{
+    static_assert(is_quantized_type<Q>::value, "quantized type must be int8_t or uint8_t");
+    if (src.size() != dst.size())
+        throw std::invalid_argument("dequantize_per_channel: buffers differ in size");
+    SIMDLIB_PERF_SCOPE("dequantize_per_channel", src.size_bytes() + dst.size_bytes());
+    detail::check_channels(src.size(), params.size());
+    const size_t inner = src.size() / params.size();
+    for (size_t c = 0; c < params.size(); ++c)
+        detail::dequantize_range(src.data() + c * inner, dst.data() + c * inner, inner, params[c]);
+}
+
+// u8 x s8 dot product accumulated in int32, exact while the result fits in int32
+inline int32_t dot(std::span<const uint8_t> a, std::span<const int8_t> b)
+{
+    if (a.size() != b.size())
+        throw std::invalid_argument("dot: operands differ in size");
+    SIMDLIB_PERF_SCOPE("dot_u8_i8", a.size_bytes() + b.size_bytes());
+    const size_t n = a.size();
+    size_t i = 0;
+    int32_t sum = 0;
+#if defined(__AVXVNNI__)
+    __m256i acc = _mm256_setzero_si256();
+    for (; i + 32 <= n; i += 32)
+    {
+        const __m256i va = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(a.data() + i));
+        const __m256i vb = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(b.data() + i));
+        acc = _mm256_dpbusd_avx_epi32(acc, va, vb);
+    }
+    sum = detail::horizontal_sum_epi32(acc);
+#elif defined(__AVX2__)
+    // maddubs saturates its int16 pair sums, so split a into its low 7 bits and its top bit:
+    // 2 * 127 * 128 still fits in int16, and the top-bit products are rescaled in the madd
+    const __m256i low_bits = _mm256_set1_epi8(0x7F);
+    const __m256i one_byte = _mm256_set1_epi8(1);
+    const __m256i ones = _mm256_set1_epi16(1);
+    const __m256i top_weight = _mm256_set1_epi16(128);
+    __m256i acc = _mm256_setzero_si256();
+    for (; i + 32 <= n; i += 32)
+    {
+        const __m256i va = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(a.data() + i));
+        const __m256i vb = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(b.data() + i));
+        const __m256i lo = _mm256_maddubs_epi16(_mm256_and_si256(va, low_bits), vb);
+        const __m256i top = _mm256_and_si256(_mm256_srli_epi16(va, 7), one_byte);
+        const __m256i hi = _mm256_maddubs_epi16(top, vb);
+        acc = _mm256_add_epi32(acc, _mm256_madd_epi16(lo, ones));
+        acc = _mm256_add_epi32(acc, _mm256_madd_epi16(hi, top_weight));
+    }
+    sum = detail::horizontal_sum_epi32(acc);
+#endif
+    for (; i < n; ++i)
+        sum += static_cast<int32_t>(a[i]) * static_cast<int32_t>(b[i]);
+    return sum;
+}
+
+// s8 x s8 dot product accumulated in int32, exact while the result fits in int32
+inline int32_t dot(std::span<const int8_t> a, std::span<const int8_t> b)
+{
+    if (a.size() != b.size())
+        throw std::invalid_argument("dot: operands differ in size");
+    SIMDLIB_PERF_SCOPE("dot_i8", a.size_bytes() + b.size_bytes());
+    const size_t n = a.size();
+    size_t i = 0;
+    int32_t sum = 0;
+#if defined(__AVXVNNI__)
+    // a + 128 is unsigned, so dot(a, b) = dot(a + 128, b) - 128 * sum(b)
+    const __m256i bias = _mm256_set1_epi8(static_cast<char>(0x80));
+    const __m256i ones = _mm256_set1_epi8(1);
+    __m256i acc = _mm256_setzero_si256();
+    __m256i b_sum = _mm256_setzero_si256();
+    for (; i + 32 <= n; i += 32)
+    {
+        const __m256i va = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(a.data() + i));
+        const __m256i vb = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(b.data() + i));
+        acc = _mm256_dpbusd_avx_epi32(acc, _mm256_xor_si256(va, bias), vb);
+        b_sum = _mm256_dpbusd_avx_epi32(b_sum, ones, vb);
+    }
+    sum = detail::horizontal_sum_epi32(_mm256_sub_epi32(acc, _mm256_slli_epi32(b_sum, 7)));
+#elif defined(__AVX2__)
+    __m256i acc = _mm256_setzero_si256();
+    for (; i + 16 <= n; i += 16)
+    {
+        const __m256i va = _mm256_cvtepi8_epi16(
+            _mm_loadu_si128(reinterpret_cast<const __m128i *>(a.data() + i)));
+        const __m256i vb = _mm256_cvtepi8_epi16(
+            _mm_loadu_si128(reinterpret_cast<const __m128i *>(b.data() + i)));
+        acc = _mm256_add_epi32(acc, _mm256_madd_epi16(va, vb));
+    }
+    sum = detail::horizontal_sum_epi32(acc);
+#endif
+    for (; i < n; ++i)
+        sum += static_cast<int32_t>(a[i]) * static_cast<int32_t>(b[i]);
+    return sum;
+}
+
+} // namespace simdlib
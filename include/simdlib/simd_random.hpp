@@ -0,0 +1,445 @@
+#pragma once
+
+#include "simd_math.hpp"
+#include "simd_parallel.hpp"
+#include "simd_perf.hpp"
+#include "simd_vector.hpp"
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <span>
+
+namespace simdlib
+{
+
+namespace detail
+{
+
+inline uint64_t splitmix64(uint64_t &state)
+{
+    uint64_t z = (state += 0x9E3779B97F4A7C15ull);
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+    return z ^ (z >> 31);
+}
+
+template <int Shift> inline __m256i rotl_epi32(__m256i a)
+{
+    return or_si256(slli_epi32<Shift>(a), srli_epi32<32 - Shift>(a));
+}
+
+// top 24 bits of each word as a float in [0, 1)
+inline simd_vector<float, AVX_SIZE> to_unit(__m256i bits)
+{
+    return simd_vector<float, AVX_SIZE>(_mm256_mul_ps(_mm256_cvtepi32_ps(srli_epi32<8>(bits)),
+                                                      _mm256_set1_ps(0x1.0p-24f)));
+}
+
+// the same in (0, 1], safe to take the log of
+inline simd_vector<float, AVX_SIZE> to_unit_open(__m256i bits)
+{
+    const __m256i top = add_epi32(srli_epi32<8>(bits), _mm256_set1_epi32(1));
+    return simd_vector<float, AVX_SIZE>(
+        _mm256_mul_ps(_mm256_cvtepi32_ps(top), _mm256_set1_ps(0x1.0p-24f)));
+}
+
+// Box-Muller: sixteen standard normals from sixteen words of random bits
+inline void box_muller(__m256i bits1, __m256i bits2, simd_vector<float, AVX_SIZE> &z0,
+                       simd_vector<float, AVX_SIZE> &z1)
+{
+    const simd_vector<float, AVX_SIZE> radius(
+        _mm256_sqrt_ps((log(to_unit_open(bits1)) * simd_vector<float, AVX_SIZE>(-2.0f)).data));
+    const simd_vector<float, AVX_SIZE> angle =
+        to_unit(bits2) * simd_vector<float, AVX_SIZE>(6.28318530717958647692f);
+    sincos(angle, z0, z1);
+    z0 *= radius;
+    z1 *= radius;
+}
+
+// a = a * scale + shift, the affine map onto the requested range or distribution
+inline simd_vector<float, AVX_SIZE> affine(const simd_vector<float, AVX_SIZE> &a, float scale,
+                                           float shift)
+{
+    return a.fmadd(simd_vector<float, AVX_SIZE>(scale), simd_vector<float, AVX_SIZE>(shift));
+}
+
+// the cap keeping uniform values below hi: u * (hi - lo) + lo rounds up to hi for u close to 1,
+// e.g. 1 - 2^-24 onto [1, 2). No cap for an empty or reversed range
+inline float uniform_top(float lo, float hi)
+{
+    return lo < hi ? std::nextafter(hi, lo) : std::numeric_limits<float>::infinity();
+}
+
+// u in [0, 1) onto [lo, lo + scale), top from uniform_top
+inline simd_vector<float, AVX_SIZE> uniform_in(const simd_vector<float, AVX_SIZE> &u, float lo,
+                                               float scale, float top)
+{
+    return simd_vector<float, AVX_SIZE>(
+        _mm256_min_ps(affine(u, scale, lo).data, _mm256_set1_ps(top)));
+}
+
+// writes n values from successive next() vectors to dst, the last vector cut short
+template <typename Next> inline void store_values(float *dst, size_t n, Next &&next)
+{
+    size_t i = 0;
+    for (; i + AVX_SIZE <= n; i += AVX_SIZE)
+        _mm256_storeu_ps(dst + i, next().data);
+    if (i < n)
+    {
+        alignas(AVX_ALIGNMENT) std::array<float, AVX_SIZE> tail{};
+        _mm256_store_ps(tail.data(), next().data);
+        std::copy(tail.begin(), tail.begin() + static_cast<std::ptrdiff_t>(n - i), dst + i);
+    }
+}
+
+// four vectors of random words, a generator's state or one Philox block
+struct word_block
+{
+    __m256i words[4];
+};
+
+// 32 x 32 -> 64 bit products of every lane with m, split into high and low words
+inline void mulhilo_epu32(__m256i a, uint32_t m, __m256i &hi, __m256i &lo)
+{
+#ifdef __AVX2__
+    const __m256i mul = _mm256_set1_epi64x(m);
+    const __m256i even = _mm256_mul_epu32(a, mul);
+    const __m256i odd = _mm256_mul_epu32(_mm256_srli_epi64(a, 32), mul);
+    hi = _mm256_blend_epi32(_mm256_srli_epi64(even, 32), odd, 0xAA);
+    lo = _mm256_blend_epi32(even, _mm256_slli_epi64(odd, 32), 0xAA);
+#else
+    const __m128i mul = _mm_set1_epi64x(m);
+    const auto half = [&mul](__m128i x, __m128i &h, __m128i &l)
+    {
+        const __m128i even = _mm_mul_epu32(x, mul);
+        const __m128i odd = _mm_mul_epu32(_mm_srli_epi64(x, 32), mul);
+        h = _mm_blend_epi16(_mm_srli_epi64(even, 32), odd, 0xCC);
+        l = _mm_blend_epi16(even, _mm_slli_epi64(odd, 32), 0xCC);
+    };
+    __m128i h0, l0, h1, l1;
+    half(_mm256_castsi256_si128(a), h0, l0);
+    half(_mm256_extractf128_si256(a, 1), h1, l1);
+    hi = _mm256_setr_m128i(h0, h1);
+    lo = _mm256_setr_m128i(l0, l1);
+#endif
+}
+
+} // namespace detail
+
+// eight independent xoshiro128+ generators, one per lane; lane 0 is seeded from splitmix64(seed)
+// and every further lane is the previous one jumped ahead 2^64 steps, so the lanes never overlap
+class xoshiro128p_x8
+{
+  public:
+    explicit xoshiro128p_x8(uint64_t seed)
+    {
+        std::array<std::array<uint32_t, 4>, AVX_SIZE> lanes{};
+        uint64_t sm = seed;
+        for (size_t w = 0; w < 4; w += 2)
+        {
+            const uint64_t v = detail::splitmix64(sm);
+            lanes[0][w] = static_cast<uint32_t>(v);
+            lanes[0][w + 1] = static_cast<uint32_t>(v >> 32);
+        }
+        for (size_t lane = 1; lane < AVX_SIZE; ++lane)
+        {
+            lanes[lane] = lanes[lane - 1];
+            jump(lanes[lane]);
+        }
+        for (size_t w = 0; w < 4; ++w)
+        {
+            alignas(AVX_ALIGNMENT) std::array<uint32_t, AVX_SIZE> words{};
+            for (size_t lane = 0; lane < AVX_SIZE; ++lane)
+                words[lane] = lanes[lane][w];
+            state_.words[w] = _mm256_load_si256(reinterpret_cast<const __m256i *>(words.data()));
+        }
+    }
+
+    // 32 random bits per lane
+    __m256i next_u32()
+    {
+        using namespace detail;
+        auto &[s0, s1, s2, s3] = state_.words;
+        const __m256i result = add_epi32(s0, s3);
+        const __m256i t = slli_epi32<9>(s1);
+        s2 = xor_si256(s2, s0);
+        s3 = xor_si256(s3, s1);
+        s1 = xor_si256(s1, s2);
+        s0 = xor_si256(s0, s3);
+        s2 = xor_si256(s2, t);
+        s3 = rotl_epi32<11>(s3);
+        return result;
+    }
+
+    // uniform in [0, 1), from the top 24 bits where xoshiro128+ is strongest
+    simd_vector<float, AVX_SIZE> uniform()
+    {
+        return detail::to_unit(next_u32());
+    }
+
+    // standard normal by Box-Muller, which yields pairs; the second vector is kept for the
+    // next call
+    simd_vector<float, AVX_SIZE> normal()
+    {
+        if (has_spare_)
+        {
+            has_spare_ = false;
+            return spare_;
+        }
+        const __m256i bits1 = next_u32();
+        const __m256i bits2 = next_u32();
+        simd_vector<float, AVX_SIZE> z0;
+        detail::box_muller(bits1, bits2, z0, spare_);
+        has_spare_ = true;
+        return z0;
+    }
+
+    // uniform floats in [lo, hi)
+    void fill_uniform(std::span<float> out, float lo = 0.0f, float hi = 1.0f)
+    {
+        SIMDLIB_PERF_SCOPE("fill_uniform", out.size_bytes());
+        const float top = detail::uniform_top(lo, hi);
+        detail::store_values(out.data(), out.size(),
+                             [&] { return detail::uniform_in(uniform(), lo, hi - lo, top); });
+    }
+
+    void fill_normal(std::span<float> out, float mean = 0.0f, float stddev = 1.0f)
+    {
+        SIMDLIB_PERF_SCOPE("fill_normal", out.size_bytes());
+        detail::store_values(out.data(), out.size(),
+                             [&] { return detail::affine(normal(), stddev, mean); });
+    }
+
+  private:
+    // advance one lane's state by 2^64 steps
+    static void jump(std::array<uint32_t, 4> &s)
+    {
+        constexpr std::array<uint32_t, 4> polynomial = {0x8764000b, 0xf542d2d3, 0x6fa035c3,
+                                                        0x77f2db5b};
+        std::array<uint32_t, 4> acc{};
+        for (const uint32_t word : polynomial)
+        {
+            for (int b = 0; b < 32; ++b)
+            {
+                if (word & (uint32_t{1} << b))
+                {
+                    for (size_t w = 0; w < 4; ++w)
+                        acc[w] ^= s[w];
+                }
+                const uint32_t t = s[1] << 9;
+                s[2] ^= s[0];
+                s[3] ^= s[1];
+                s[1] ^= s[2];
+                s[0] ^= s[3];
+                s[2] ^= t;
+                s[3] = (s[3] << 11) | (s[3] >> 21);
+            }
+        }
+        s = acc;
+    }
+
+    detail::word_block state_{};
+    simd_vector<float, AVX_SIZE> spare_;
+    bool has_spare_ = false;
+};
+
+namespace detail
+{
+
+// vectors of floats made from one block of words
+using float_block = std::array<simd_vector<float, AVX_SIZE>, 4>;
+
+// four vectors of standard normals, Box-Muller pairing word vectors 0 with 2 and 1 with 3
+inline float_block normals_of(const word_block &block)
+{
+    float_block z;
+    box_muller(block.words[0], block.words[2], z[0], z[2]);
+    box_muller(block.words[1], block.words[3], z[1], z[3]);
+    return z;
+}
+
+} // namespace detail
+
+// counter-based Philox4x32-10, eight counters per step; block b of a stream holds the 32 words
+// of counters 8b .. 8b + 7 (vector j, lane k = word j of counter 8b + k), so any part of a
+// stream can be generated on its own and parallel fills match sequential ones exactly
+class philox_x8
+{
+  public:
+    // words per block
+    static constexpr size_t block_size = 4 * AVX_SIZE;
+
+    // seed is the key; stream selects one of 2^64 independent sequences under it
+    explicit philox_x8(uint64_t seed, uint64_t stream = 0, uint64_t block = 0)
+        : key_{static_cast<uint32_t>(seed), static_cast<uint32_t>(seed >> 32)}, stream_(stream),
+          counter_(block * AVX_SIZE)
+    {
+    }
+
+    // continue from block `block` of the stream
+    void seek(uint64_t block)
+    {
+        counter_ = block * AVX_SIZE;
+        next_ = 4;
+        next_normal_ = normals_.size();
+    }
+
+    // the next Count blocks, computed together: a lone block is bound by the latency of the
+    // ten dependent multiply rounds
+    template <size_t Count> std::array<detail::word_block, Count> next_blocks()
+    {
+        using namespace detail;
+        std::array<word_block, Count> blocks;
+        for (auto &block : blocks)
+        {
+            alignas(AVX_ALIGNMENT) std::array<uint32_t, AVX_SIZE> low{};
+            alignas(AVX_ALIGNMENT) std::array<uint32_t, AVX_SIZE> high{};
+            for (size_t k = 0; k < AVX_SIZE; ++k)
+            {
+                low[k] = static_cast<uint32_t>(counter_ + k);
+                high[k] = static_cast<uint32_t>((counter_ + k) >> 32);
+            }
+            counter_ += AVX_SIZE;
+            block.words[0] = _mm256_load_si256(reinterpret_cast<const __m256i *>(low.data()));
+            block.words[1] = _mm256_load_si256(reinterpret_cast<const __m256i *>(high.data()));
+            block.words[2] = _mm256_set1_epi32(static_cast<int>(static_cast<uint32_t>(stream_)));
+            block.words[3] =
+                _mm256_set1_epi32(static_cast<int>(static_cast<uint32_t>(stream_ >> 32)));
+        }
+
+        uint32_t k0 = key_[0];
+        uint32_t k1 = key_[1];
+        for (int round = 0; round < 10; ++round)
+        {
+            const __m256i key0 = _mm256_set1_epi32(static_cast<int>(k0));
+            const __m256i key1 = _mm256_set1_epi32(static_cast<int>(k1));
+            for (auto &block : blocks)
+            {
+                auto &[c0, c1, c2, c3] = block.words;
+                __m256i hi0, lo0, hi1, lo1;
+                mulhilo_epu32(c0, 0xD2511F53u, hi0, lo0);
+                mulhilo_epu32(c2, 0xCD9E8D57u, hi1, lo1);
+                c0 = xor_si256(xor_si256(hi1, c1), key0);
+                c1 = lo1;
+                c2 = xor_si256(xor_si256(hi0, c3), key1);
+                c3 = lo0;
+            }
+            k0 += 0x9E3779B9u;
+            k1 += 0xBB67AE85u;
+        }
+        return blocks;
+    }
+
+    // the next block: four vectors of eight random words
+    detail::word_block next_block()
+    {
+        return next_blocks<1>()[0];
+    }
+
+    // uniform in [0, 1), four vectors per block
+    simd_vector<float, AVX_SIZE> uniform()
+    {
+        if (next_ == 4)
+        {
+            words_ = next_block();
+            next_ = 0;
+        }
+        return detail::to_unit(words_.words[next_++]);
+    }
+
+    // standard normal by Box-Muller, four vectors per block
+    simd_vector<float, AVX_SIZE> normal()
+    {
+        if (next_normal_ == normals_.size())
+        {
+            normals_ = detail::normals_of(next_block());
+            next_normal_ = 0;
+        }
+        return normals_[next_normal_++];
+    }
+
+  private:
+    std::array<uint32_t, 2> key_;
+    uint64_t stream_;
+    uint64_t counter_;
+    detail::word_block words_{};
+    size_t next_ = 4;
+    detail::float_block normals_;
+    size_t next_normal_ = 4;
+};
+
+namespace detail
+{
+
+// blocks a thread must have before a Philox fill is split
+constexpr size_t philox_min_blocks = size_t{1} << 12;
+
+// blocks generated together by the fills
+constexpr size_t philox_batch = 4;
+
+// fills out with convert(block) for the blocks of (seed, stream) from 0 on, each thread
+// seeking to its own first block
+template <typename Convert>
+inline void philox_fill(std::span<float> out, uint64_t seed, uint64_t stream, size_t threads,
+                        Convert convert)
+{
+    const size_t blocks = (out.size() + philox_x8::block_size - 1) / philox_x8::block_size;
+    parallel_for(blocks, chunk_count(threads, blocks, philox_min_blocks),
+                 [&](size_t begin, size_t end, size_t)
+                 {
+                     philox_x8 gen(seed, stream, begin);
+                     for (size_t b = begin; b < end; b += philox_batch)
+                     {
+                         const auto batch = gen.next_blocks<philox_batch>();
+                         for (size_t i = 0; i < philox_batch && b + i < end; ++i)
+                         {
+                             const float_block v = convert(batch[i]);
+                             const size_t first = (b + i) * philox_x8::block_size;
+                             size_t j = 0;
+                             store_values(out.data() + first,
+                                          std::min(philox_x8::block_size, out.size() - first),
+                                          [&] { return v[j++]; });
+                         }
+                     }
+                 });
+}
+
+} // namespace detail
+
+// uniform floats in [lo, hi) from Philox stream (seed, stream); the result does not depend on
+// the thread count, value i is always the i-th uniform() of philox_x8(seed, stream)
+inline void fill_uniform(std::span<float> out, uint64_t seed, uint64_t stream = 0,
+                         float lo = 0.0f, float hi = 1.0f, size_t threads = 1)
+{
+    SIMDLIB_PERF_SCOPE("fill_uniform", out.size_bytes());
+    detail::philox_fill(out, seed, stream, threads,
+                        [lo, scale = hi - lo,
+                         top = detail::uniform_top(lo, hi)](const detail::word_block &block)
+                        {
+                            detail::float_block v;
+                            for (size_t j = 0; j < v.size(); ++j)
+                                v[j] = detail::uniform_in(detail::to_unit(block.words[j]), lo,
+                                                          scale, top);
+                            return v;
+                        });
+}
+
+// normal floats with the given mean and standard deviation from Philox stream (seed, stream);
+// value i is always the i-th normal() of philox_x8(seed, stream)
+inline void fill_normal(std::span<float> out, uint64_t seed, uint64_t stream = 0,
+                        float mean = 0.0f, float stddev = 1.0f, size_t threads = 1)
+{
+    SIMDLIB_PERF_SCOPE("fill_normal", out.size_bytes());
+    detail::philox_fill(out, seed, stream, threads,
+                        [mean, stddev](const detail::word_block &block)
+                        {
+                            detail::float_block v = detail::normals_of(block);
+                            for (auto &z : v)
+                                z = detail::affine(z, stddev, mean);
+                            return v;
+                        });
+}
+
+} // namespace simdlib
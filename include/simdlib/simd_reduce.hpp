@@ -0,0 +1,229 @@
+#pragma once
+
+#include "simd_parallel.hpp"
+#include "simd_perf.hpp"
+#include "simd_vector.hpp"
+#include <algorithm>
+#include <array>
+#include <limits>
+#include <span>
+#include <stdexcept>
+#include <vector>
+
+namespace simdlib
+{
+
+namespace detail
+{
+
+// floats summed in float lanes before the partial is widened into the double total
+constexpr size_t sum_flush_block = size_t{1} << 14;
+
+// floats per streaming step, the next step is announced to the readahead hook before the
+// current one is processed
+constexpr size_t stream_chunk = size_t{1} << 20;
+
+// floats a worker thread must have before a reduction is split
+constexpr size_t reduce_min_chunk = size_t{1} << 18;
+
+// how far ahead of the loads the software prefetch runs, in floats
+constexpr size_t prefetch_distance = 512;
+
+struct no_readahead
+{
+    void operator()(size_t, size_t) const
+    {
+    }
+};
+
+inline void prefetch_ahead(const float *p)
+{
+    _mm_prefetch(reinterpret_cast<const char *>(p + prefetch_distance), _MM_HINT_T0);
+    _mm_prefetch(reinterpret_cast<const char *>(p + prefetch_distance + 16), _MM_HINT_T0);
+}
+
+// runs body(begin, end) over [begin, end) in stream_chunk steps
+template <typename Readahead, typename Body>
+void stream_range(size_t begin, size_t end, Readahead &readahead, Body &&body)
+{
+    for (size_t chunk = begin; chunk < end; chunk += stream_chunk)
+    {
+        const size_t chunk_end = std::min(end, chunk + stream_chunk);
+        if (chunk_end < end)
+            readahead(chunk_end, std::min(end, chunk_end + stream_chunk));
+        body(chunk, chunk_end);
+    }
+}
+
+inline double sum_block(const float *values, size_t n)
+{
+    double total = 0.0;
+    for (size_t block = 0; block < n; block += sum_flush_block)
+    {
+        const size_t block_end = std::min(n, block + sum_flush_block);
+        simd_vector<float, AVX_SIZE> acc0;
+        simd_vector<float, AVX_SIZE> acc1;
+        simd_vector<float, AVX_SIZE> acc2;
+        simd_vector<float, AVX_SIZE> acc3;
+        size_t i = block;
+        for (; i + 4 * AVX_SIZE <= block_end; i += 4 * AVX_SIZE)
+        {
+            prefetch_ahead(values + i);
+            acc0 += simd_vector<float, AVX_SIZE>(_mm256_loadu_ps(values + i));
+            acc1 += simd_vector<float, AVX_SIZE>(_mm256_loadu_ps(values + i + AVX_SIZE));
+            acc2 += simd_vector<float, AVX_SIZE>(_mm256_loadu_ps(values + i + 2 * AVX_SIZE));
+            acc3 += simd_vector<float, AVX_SIZE>(_mm256_loadu_ps(values + i + 3 * AVX_SIZE));
+        }
+        for (; i + AVX_SIZE <= block_end; i += AVX_SIZE)
+            acc0 += simd_vector<float, AVX_SIZE>(_mm256_loadu_ps(values + i));
+        float tail = 0.0f;
+        for (; i < block_end; ++i)
+            tail += values[i];
+        total += static_cast<double>(((acc0 + acc1) + (acc2 + acc3)).horizontal_sum()) + tail;
+    }
+    return total;
+}
+
+// minimum (Max = false) or maximum of a range, NaN values never win
+template <bool Max> inline float extreme_block(const float *values, size_t n)
+{
+    const auto pick = [](__m256 x, __m256 acc)
+    {
+        // min/max return the second operand when either is NaN, so keep acc second
+        if constexpr (Max)
+            return _mm256_max_ps(x, acc);
+        else
+            return _mm256_min_ps(x, acc);
+    };
+    const float init =
+        Max ? -std::numeric_limits<float>::infinity() : std::numeric_limits<float>::infinity();
+    __m256 acc0 = _mm256_set1_ps(init);
+    __m256 acc1 = acc0;
+    __m256 acc2 = acc0;
+    __m256 acc3 = acc0;
+    size_t i = 0;
+    for (; i + 4 * AVX_SIZE <= n; i += 4 * AVX_SIZE)
+    {
+        prefetch_ahead(values + i);
+        acc0 = pick(_mm256_loadu_ps(values + i), acc0);
+        acc1 = pick(_mm256_loadu_ps(values + i + AVX_SIZE), acc1);
+        acc2 = pick(_mm256_loadu_ps(values + i + 2 * AVX_SIZE), acc2);
+        acc3 = pick(_mm256_loadu_ps(values + i + 3 * AVX_SIZE), acc3);
+    }
+    for (; i + AVX_SIZE <= n; i += AVX_SIZE)
+        acc0 = pick(_mm256_loadu_ps(values + i), acc0);
+    const simd_vector<float, AVX_SIZE> acc(pick(pick(acc0, acc1), pick(acc2, acc3)));
+    float result = Max ? acc.horizontal_max() : acc.horizontal_min();
+    for (; i < n; ++i)
+        result = (Max ? values[i] > result : values[i] < result) ? values[i] : result;
+    return result;
+}
+
+template <typename Readahead>
+double sum_streamed(std::span<const float> values, size_t threads, Readahead readahead)
+{
+    SIMDLIB_PERF_SCOPE("reduce_sum", values.size_bytes());
+    const size_t chunks = chunk_count(threads, values.size(), reduce_min_chunk);
+    std::vector<double> partial(chunks);
+    parallel_for(values.size(), chunks,
+                 [&](size_t begin, size_t end, size_t chunk)
+                 {
+                     stream_range(begin, end, readahead, [&](size_t b, size_t e)
+                                  { partial[chunk] += sum_block(values.data() + b, e - b); });
+                 });
+    double total = 0.0;
+    for (const double p : partial)
+        total += p;
+    return total;
+}
+
+template <bool Max, typename Readahead>
+float extreme_streamed(std::span<const float> values, size_t threads, Readahead readahead)
+{
+    SIMDLIB_PERF_SCOPE(Max ? "reduce_max" : "reduce_min", values.size_bytes());
+    const float init =
+        Max ? -std::numeric_limits<float>::infinity() : std::numeric_limits<float>::infinity();
+    const size_t chunks = chunk_count(threads, values.size(), reduce_min_chunk);
+    std::vector<float> partial(chunks, init);
+    parallel_for(values.size(), chunks,
+                 [&](size_t begin, size_t end, size_t chunk)
+                 {
+                     stream_range(begin, end, readahead,
+                                  [&](size_t b, size_t e)
+                                  {
+                                      const float r = extreme_block<Max>(values.data() + b, e - b);
+                                      partial[chunk] = Max ? std::max(partial[chunk], r)
+                                                           : std::min(partial[chunk], r);
+                                  });
+                 });
+    return Max ? *std::max_element(partial.begin(), partial.end())
+               : *std::min_element(partial.begin(), partial.end());
+}
+
+template <typename Op>
+inline void transform_block(const float *src, float *dst, size_t n, Op &op)
+{
+    size_t i = 0;
+    for (; i + AVX_SIZE <= n; i += AVX_SIZE)
+    {
+        prefetch_ahead(src + i);
+        const simd_vector<float, AVX_SIZE> result =
+            op(simd_vector<float, AVX_SIZE>(_mm256_loadu_ps(src + i)));
+        _mm256_storeu_ps(dst + i, result.data);
+    }
+    if (i < n)
+    {
+        // the tail goes through op as a zero-padded vector so op needs no scalar form
+        alignas(AVX_ALIGNMENT) std::array<float, AVX_SIZE> buf{};
+        std::copy(src + i, src + n, buf.begin());
+        const simd_vector<float, AVX_SIZE> result =
+            op(simd_vector<float, AVX_SIZE>(_mm256_load_ps(buf.data())));
+        _mm256_store_ps(buf.data(), result.data);
+        std::copy(buf.begin(), buf.begin() + static_cast<std::ptrdiff_t>(n - i), dst + i);
+    }
+}
+
+template <typename Op, typename Readahead>
+void transform_streamed(std::span<const float> src, std::span<float> dst, Op &op, size_t threads,
+                        Readahead readahead)
+{
+    if (src.size() != dst.size())
+        throw std::invalid_argument("transform_values: buffers differ in size");
+    SIMDLIB_PERF_SCOPE("transform_values", src.size_bytes() + dst.size_bytes());
+    parallel_for(src.size(), chunk_count(threads, src.size(), reduce_min_chunk),
+                 [&](size_t begin, size_t end, size_t)
+                 {
+                     stream_range(begin, end, readahead, [&](size_t b, size_t e)
+                                  { transform_block(src.data() + b, dst.data() + b, e - b, op); });
+                 });
+}
+
+} // namespace detail
+
+// sum of all values, float lanes widened into a double total every few thousand elements
+inline double reduce_sum(std::span<const float> values, size_t threads = 1)
+{
+    return detail::sum_streamed(values, threads, detail::no_readahead{});
+}
+
+// smallest value ignoring NaN, +inf for an empty or all-NaN input
+inline float reduce_min(std::span<const float> values, size_t threads = 1)
+{
+    return detail::extreme_streamed<false>(values, threads, detail::no_readahead{});
+}
+
+// largest value ignoring NaN, -inf for an empty or all-NaN input
+inline float reduce_max(std::span<const float> values, size_t threads = 1)
+{
+    return detail::extreme_streamed<true>(values, threads, detail::no_readahead{});
+}
+
+// dst = op(src) eight lanes at a time, op maps simd_vector<float, 8> to simd_vector<float, 8>;
+// src and dst may be the same buffer
+template <typename Op>
+void transform_values(std::span<const float> src, std::span<float> dst, Op op, size_t threads = 1)
+{
+    detail::transform_streamed(src, dst, op, threads, detail::no_readahead{});
+}
+
+} // namespace simdlib
@@ -0,0 +1,380 @@
+#pragma once
+
+#include "simd_convolve.hpp"
+#include "simd_perf.hpp"
+#include "simd_vector.hpp"
+#include <algorithm>
+#include <array>
+#include <limits>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace simdlib
+{
+
+namespace detail
+{
+
+// windows up to this size take the extreme over the window directly, longer ones use
+// van Herk/Gil-Werman at a constant three comparisons per element
+constexpr size_t direct_extreme_window = 16;
+
+// lane j gets lane j - Shift of vec, the first Shift lanes get fill
+template <size_t Shift> inline __m256 shift_up(__m256 vec, __m256 fill)
+{
+    return window<AVX_SIZE - Shift>(simd_vector<float, AVX_SIZE>(fill),
+                                    simd_vector<float, AVX_SIZE>(vec))
+        .data;
+}
+
+// lane j gets lane j + Shift of vec, the last Shift lanes get fill
+template <size_t Shift> inline __m256 shift_down(__m256 vec, __m256 fill)
+{
+    return window<Shift>(simd_vector<float, AVX_SIZE>(vec), simd_vector<float, AVX_SIZE>(fill))
+        .data;
+}
+
+inline __m256 broadcast_first(__m256 vec)
+{
+    return _mm256_permute_ps(_mm256_permute2f128_ps(vec, vec, 0x00), 0x00);
+}
+
+inline __m256 broadcast_last(__m256 vec)
+{
+    return _mm256_permute_ps(_mm256_permute2f128_ps(vec, vec, 0x11), 0xFF);
+}
+
+// inclusive prefix sum across the eight lanes
+inline __m256 prefix_sum8(__m256 vec)
+{
+    const __m256 zero = _mm256_setzero_ps();
+    vec = _mm256_add_ps(vec, shift_up<1>(vec, zero));
+    vec = _mm256_add_ps(vec, shift_up<2>(vec, zero));
+    return _mm256_add_ps(vec, shift_up<4>(vec, zero));
+}
+
+// s + err == a + b exactly (Knuth two-sum)
+inline __m256 two_sum(__m256 a, __m256 b, __m256 &err)
+{
+    const __m256 s = _mm256_add_ps(a, b);
+    const __m256 bb = _mm256_sub_ps(s, a);
+    err = _mm256_add_ps(_mm256_sub_ps(a, _mm256_sub_ps(s, bb)), _mm256_sub_ps(b, bb));
+    return s;
+}
+
+inline float two_sum(float a, float b, float &err)
+{
+    const float s = a + b;
+    const float bb = s - a;
+    err = (a - (s - bb)) + (b - bb);
+    return s;
+}
+
+// prefix sums of (x - shift) or (x - shift)^2 kept as hi + lo float pairs, hi[0] = lo[0] = 0;
+// the rounding error of every carry addition lands in lo, so a window difference far
+// into a long series keeps the precision of the window rather than of the running total
+template <bool Square>
+inline void compensated_prefix(const float *x, size_t n, float shift, float *hi, float *lo)
+{
+    hi[0] = 0.0f;
+    lo[0] = 0.0f;
+    const __m256 shift_vec = _mm256_set1_ps(shift);
+    __m256 carry_hi = _mm256_setzero_ps();
+    __m256 carry_lo = _mm256_setzero_ps();
+    size_t i = 0;
+    for (; i + AVX_SIZE <= n; i += AVX_SIZE)
+    {
+        __m256 d = _mm256_sub_ps(_mm256_loadu_ps(x + i), shift_vec);
+        if constexpr (Square)
+            d = _mm256_mul_ps(d, d);
+        __m256 err;
+        const __m256 s = two_sum(carry_hi, prefix_sum8(d), err);
+        const __m256 c = _mm256_add_ps(carry_lo, err);
+        _mm256_storeu_ps(hi + i + 1, s);
+        _mm256_storeu_ps(lo + i + 1, c);
+        carry_hi = broadcast_last(s);
+        carry_lo = broadcast_last(c);
+    }
+    for (; i < n; ++i)
+    {
+        float d = x[i] - shift;
+        if constexpr (Square)
+            d *= d;
+        float err;
+        hi[i + 1] = two_sum(hi[i], d, err);
+        lo[i + 1] = lo[i] + err;
+    }
+}
+
+// out[i] = scale * (prefix[i + w] - prefix[i])
+inline void window_sums(const float *hi, const float *lo, size_t n_out, size_t w, float scale,
+                        float *out)
+{
+    const __m256 scale_vec = _mm256_set1_ps(scale);
+    size_t i = 0;
+    for (; i + AVX_SIZE <= n_out; i += AVX_SIZE)
+    {
+        const __m256 dh = _mm256_sub_ps(_mm256_loadu_ps(hi + i + w), _mm256_loadu_ps(hi + i));
+        const __m256 dl = _mm256_sub_ps(_mm256_loadu_ps(lo + i + w), _mm256_loadu_ps(lo + i));
+        _mm256_storeu_ps(out + i, _mm256_mul_ps(_mm256_add_ps(dh, dl), scale_vec));
+    }
+    for (; i < n_out; ++i)
+        out[i] = ((hi[i + w] - hi[i]) + (lo[i + w] - lo[i])) * scale;
+}
+
+inline size_t rolling_outputs(size_t n, size_t window, size_t out, const char *what)
+{
+    if (window == 0)
+        throw std::invalid_argument(std::string(what) + ": window must be positive");
+    const size_t n_out = n >= window ? n - window + 1 : 0;
+    if (out != n_out)
+        throw std::invalid_argument(std::string(what) +
+                                    ": output size must be values - window + 1");
+    return n_out;
+}
+
+inline void rolling_sum_scaled(std::span<const float> values, size_t window, float scale,
+                               std::span<float> out)
+{
+    std::vector<float> hi(values.size() + 1);
+    std::vector<float> lo(values.size() + 1);
+    compensated_prefix<false>(values.data(), values.size(), 0.0f, hi.data(), lo.data());
+    window_sums(hi.data(), lo.data(), out.size(), window, scale, out.data());
+}
+
+template <bool Max> inline __m256 pick(__m256 a, __m256 b)
+{
+    if constexpr (Max)
+        return _mm256_max_ps(a, b);
+    else
+        return _mm256_min_ps(a, b);
+}
+
+template <bool Max> inline float pick(float a, float b)
+{
+    return Max ? std::max(a, b) : std::min(a, b);
+}
+
+template <bool Max> constexpr float extreme_identity()
+{
+    return Max ? -std::numeric_limits<float>::infinity() : std::numeric_limits<float>::infinity();
+}
+
+// running extreme across the lanes, forwards (prefix) or backwards (suffix)
+template <bool Max> inline __m256 prefix_extreme8(__m256 vec)
+{
+    const __m256 fill = _mm256_set1_ps(extreme_identity<Max>());
+    vec = pick<Max>(vec, shift_up<1>(vec, fill));
+    vec = pick<Max>(vec, shift_up<2>(vec, fill));
+    return pick<Max>(vec, shift_up<4>(vec, fill));
+}
+
+template <bool Max> inline __m256 suffix_extreme8(__m256 vec)
+{
+    const __m256 fill = _mm256_set1_ps(extreme_identity<Max>());
+    vec = pick<Max>(vec, shift_down<1>(vec, fill));
+    vec = pick<Max>(vec, shift_down<2>(vec, fill));
+    return pick<Max>(vec, shift_down<4>(vec, fill));
+}
+
+template <bool Max>
+inline void rolling_extreme_direct(const float *x, size_t n_out, size_t w, float *out)
+{
+    size_t i = 0;
+    for (; i + AVX_SIZE <= n_out; i += AVX_SIZE)
+    {
+        __m256 acc = _mm256_loadu_ps(x + i);
+        for (size_t k = 1; k < w; ++k)
+            acc = pick<Max>(acc, _mm256_loadu_ps(x + i + k));
+        _mm256_storeu_ps(out + i, acc);
+    }
+    for (; i < n_out; ++i)
+        out[i] = *(Max ? std::max_element(x + i, x + i + w) : std::min_element(x + i, x + i + w));
+}
+
+// van Herk/Gil-Werman: split the series into blocks of w, take the running extreme forwards
+// (g) and backwards (h) inside each block, then every window is pick(h[i], g[i + w - 1]);
+// the in-block scans run eight lanes at a time with one block boundary per vector at most
+template <bool Max>
+inline void rolling_extreme_vhgw(const float *x, size_t n, size_t w, float *out)
+{
+    const size_t padded = (n + AVX_SIZE - 1) / AVX_SIZE * AVX_SIZE;
+    std::vector<float> g(padded);
+    std::vector<float> h(padded);
+    const __m256 identity = _mm256_set1_ps(extreme_identity<Max>());
+    const __m256 lane = _mm256_setr_ps(0.0f, 1.0f, 2.0f, 3.0f, 4.0f, 5.0f, 6.0f, 7.0f);
+    const auto load = [&](size_t i)
+    {
+        if (i + AVX_SIZE <= n)
+            return _mm256_loadu_ps(x + i);
+        alignas(AVX_ALIGNMENT) std::array<float, AVX_SIZE> buf;
+        buf.fill(extreme_identity<Max>());
+        std::copy(x + i, x + n, buf.begin());
+        return _mm256_load_ps(buf.data());
+    };
+
+    // lanes >= b start a new block, lanes < b continue the block of the previous vector
+    __m256 carry = identity;
+    for (size_t i = 0; i < padded; i += AVX_SIZE)
+    {
+        const size_t offset = i % w;
+        const size_t b = w - offset;
+        const __m256 v = load(i);
+        __m256 r = prefix_extreme8<Max>(v);
+        if (offset > 0)
+            r = pick<Max>(r, carry);
+        if (b < AVX_SIZE)
+        {
+            const __m256 fresh =
+                _mm256_cmp_ps(lane, _mm256_set1_ps(static_cast<float>(b)), _CMP_GE_OQ);
+            const __m256 next = prefix_extreme8<Max>(_mm256_blendv_ps(identity, v, fresh));
+            r = _mm256_blendv_ps(r, next, fresh);
+        }
+        _mm256_storeu_ps(g.data() + i, r);
+        carry = broadcast_last(r);
+    }
+
+    // lanes < b end their block at lane b - 1, lanes >= b continue into the next vector
+    carry = identity;
+    for (size_t i = padded; i > 0;)
+    {
+        i -= AVX_SIZE;
+        const size_t b = w - i % w;
+        const __m256 v = load(i);
+        __m256 r = suffix_extreme8<Max>(v);
+        if (b < AVX_SIZE)
+        {
+            const __m256 fresh =
+                _mm256_cmp_ps(lane, _mm256_set1_ps(static_cast<float>(b)), _CMP_GE_OQ);
+            const __m256 head = suffix_extreme8<Max>(_mm256_blendv_ps(v, identity, fresh));
+            r = _mm256_blendv_ps(head, pick<Max>(r, carry), fresh);
+        }
+        else if (b > AVX_SIZE)
+        {
+            r = pick<Max>(r, carry);
+        }
+        _mm256_storeu_ps(h.data() + i, r);
+        carry = broadcast_first(r);
+    }
+
+    const size_t n_out = n - w + 1;
+    size_t i = 0;
+    for (; i + AVX_SIZE <= n_out; i += AVX_SIZE)
+        _mm256_storeu_ps(out + i, pick<Max>(_mm256_loadu_ps(h.data() + i),
+                                            _mm256_loadu_ps(g.data() + i + w - 1)));
+    for (; i < n_out; ++i)
+        out[i] = pick<Max>(h[i], g[i + w - 1]);
+}
+
+template <bool Max>
+inline void rolling_extreme(std::span<const float> values, size_t window, std::span<float> out)
+{
+    if (window <= direct_extreme_window)
+        rolling_extreme_direct<Max>(values.data(), out.size(), window, out.data());
+    else
+        rolling_extreme_vhgw<Max>(values.data(), values.size(), window, out.data());
+}
+
+} // namespace detail
+
+// Sliding windows in valid mode: out[i] covers values[i, i + window), so out must hold
+// values.size() - window + 1 results (or none if the series is shorter than the window).
+
+// out[i] = sum of the window, from compensated prefix sums
+inline void rolling_sum(std::span<const float> values, size_t window, std::span<float> out)
+{
+    if (detail::rolling_outputs(values.size(), window, out.size(), "rolling_sum") == 0)
+        return;
+    SIMDLIB_PERF_SCOPE("rolling_sum", values.size_bytes() + out.size_bytes());
+    detail::rolling_sum_scaled(values, window, 1.0f, out);
+}
+
+// out[i] = mean of the window
+inline void rolling_mean(std::span<const float> values, size_t window, std::span<float> out)
+{
+    if (detail::rolling_outputs(values.size(), window, out.size(), "rolling_mean") == 0)
+        return;
+    SIMDLIB_PERF_SCOPE("rolling_mean", values.size_bytes() + out.size_bytes());
+    detail::rolling_sum_scaled(values, window, 1.0f / static_cast<float>(window), out);
+}
+
+// out[i] = variance of the window with window - ddof degrees of freedom; the series is
+// shifted by the mean of its first window so a large common offset does not cancel away
+inline void rolling_variance(std::span<const float> values, size_t window, std::span<float> out,
+                             size_t ddof = 0)
+{
+    if (detail::rolling_outputs(values.size(), window, out.size(), "rolling_variance") == 0)
+        return;
+    if (ddof >= window)
+        throw std::invalid_argument("rolling_variance: ddof must be less than the window");
+    SIMDLIB_PERF_SCOPE("rolling_variance", values.size_bytes() + out.size_bytes());
+
+    const size_t n = values.size();
+    double first = 0.0;
+    for (size_t i = 0; i < window; ++i)
+        first += values[i];
+    const auto shift = static_cast<float>(first / static_cast<double>(window));
+
+    std::vector<float> hi1(n + 1);
+    std::vector<float> lo1(n + 1);
+    std::vector<float> hi2(n + 1);
+    std::vector<float> lo2(n + 1);
+    detail::compensated_prefix<false>(values.data(), n, shift, hi1.data(), lo1.data());
+    detail::compensated_prefix<true>(values.data(), n, shift, hi2.data(), lo2.data());
+
+    // the moments are combined in double, four windows at a time
+    const double inv_window = 1.0 / static_cast<double>(window);
+    const double inv_dof = 1.0 / static_cast<double>(window - ddof);
+    const auto moment = [window](const std::vector<float> &hi, const std::vector<float> &lo,
+                                 size_t i)
+    {
+        const __m128 dh = _mm_sub_ps(_mm_loadu_ps(hi.data() + i + window),
+                                     _mm_loadu_ps(hi.data() + i));
+        const __m128 dl = _mm_sub_ps(_mm_loadu_ps(lo.data() + i + window),
+                                     _mm_loadu_ps(lo.data() + i));
+        return _mm256_add_pd(_mm256_cvtps_pd(dh), _mm256_cvtps_pd(dl));
+    };
+    const __m256d inv_window_vec = _mm256_set1_pd(inv_window);
+    const __m256d inv_dof_vec = _mm256_set1_pd(inv_dof);
+    size_t i = 0;
+    for (; i + 4 <= out.size(); i += 4)
+    {
+        const __m256d s1 = moment(hi1, lo1, i);
+        const __m256d s2 = moment(hi2, lo2, i);
+        const __m256d centered = _mm256_sub_pd(s2, _mm256_mul_pd(_mm256_mul_pd(s1, s1),
+                                                                 inv_window_vec));
+        const __m256d var = _mm256_max_pd(_mm256_mul_pd(centered, inv_dof_vec),
+                                          _mm256_setzero_pd());
+        _mm_storeu_ps(out.data() + i, _mm256_cvtpd_ps(var));
+    }
+    for (; i < out.size(); ++i)
+    {
+        const double s1 = static_cast<double>(hi1[i + window] - hi1[i]) +
+                          static_cast<double>(lo1[i + window] - lo1[i]);
+        const double s2 = static_cast<double>(hi2[i + window] - hi2[i]) +
+                          static_cast<double>(lo2[i + window] - lo2[i]);
+        out[i] = static_cast<float>(std::max((s2 - s1 * s1 * inv_window) * inv_dof, 0.0));
+    }
+}
+
+// out[i] = smallest value in the window, values must not be NaN
+inline void rolling_min(std::span<const float> values, size_t window, std::span<float> out)
+{
+    if (detail::rolling_outputs(values.size(), window, out.size(), "rolling_min") == 0)
+        return;
+    SIMDLIB_PERF_SCOPE("rolling_min", values.size_bytes() + out.size_bytes());
+    detail::rolling_extreme<false>(values, window, out);
+}
+
+// out[i] = largest value in the window, values must not be NaN
+inline void rolling_max(std::span<const float> values, size_t window, std::span<float> out)
+{
+    if (detail::rolling_outputs(values.size(), window, out.size(), "rolling_max") == 0)
+        return;
+    SIMDLIB_PERF_SCOPE("rolling_max", values.size_bytes() + out.size_bytes());
+    detail::rolling_extreme<true>(values, window, out);
+}
+
+} // namespace simdlib
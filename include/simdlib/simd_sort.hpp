@@ -0,0 +1,442 @@
+#pragma once
+
+#include "simd_perf.hpp"
+#include "simd_vector.hpp"
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cstdint>
+#include <limits>
+#include <span>
+#include <stdexcept>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+namespace simdlib
+{
+
+namespace detail
+{
+
+// lane permutations used by the sorting networks, built on the shuffle/permute members
+struct swap_adjacent
+{
+    simd_vector<float, AVX_SIZE> operator()(const simd_vector<float, AVX_SIZE> &vec) const
+    {
+        return vec.shuffle(_MM_SHUFFLE(2, 3, 0, 1)); // lane i <-> lane i ^ 1
+    }
+};
+
+struct swap_pairs
+{
+    simd_vector<float, AVX_SIZE> operator()(const simd_vector<float, AVX_SIZE> &vec) const
+    {
+        return vec.shuffle(_MM_SHUFFLE(1, 0, 3, 2)); // lane i <-> lane i ^ 2
+    }
+};
+
+struct swap_halves
+{
+    simd_vector<float, AVX_SIZE> operator()(const simd_vector<float, AVX_SIZE> &vec) const
+    {
+        return vec.permute(0x01); // lane i <-> lane i ^ 4
+    }
+};
+
+struct reverse_quads
+{
+    simd_vector<float, AVX_SIZE> operator()(const simd_vector<float, AVX_SIZE> &vec) const
+    {
+        return vec.shuffle(_MM_SHUFFLE(0, 1, 2, 3)); // lane i <-> lane i ^ 3
+    }
+};
+
+struct reverse_all
+{
+    simd_vector<float, AVX_SIZE> operator()(const simd_vector<float, AVX_SIZE> &vec) const
+    {
+        return vec.permute(0x01).shuffle(_MM_SHUFFLE(0, 1, 2, 3)); // lane i <-> lane 7 - i
+    }
+};
+
+// compare-exchange every lane with its partner; lanes set in Mask keep the larger key
+template <int Mask, typename Perm>
+inline void bitonic_step(Perm perm, simd_vector<float, AVX_SIZE> &keys)
+{
+    const simd_vector<float, AVX_SIZE> partner = perm(keys);
+    const simd_vector<float, AVX_SIZE> lo(_mm256_min_ps(keys.data, partner.data));
+    const simd_vector<float, AVX_SIZE> hi(_mm256_max_ps(keys.data, partner.data));
+    keys = lo.blend(hi, Mask);
+}
+
+// key-value compare-exchange, payload bits ride along in float lanes and are only moved
+template <int Mask, typename Perm>
+inline void bitonic_step(Perm perm, simd_vector<float, AVX_SIZE> &keys,
+                         simd_vector<float, AVX_SIZE> &values)
+{
+    const simd_vector<float, AVX_SIZE> partner_keys = perm(keys);
+    const simd_vector<float, AVX_SIZE> partner_values = perm(values);
+    // a pair swaps only when its keys are strictly out of order, so ties never duplicate payloads
+    const simd_vector<float, AVX_SIZE> take =
+        (partner_keys < keys).blend(partner_keys > keys, Mask);
+    keys.data = _mm256_blendv_ps(keys.data, partner_keys.data, take.data);
+    values.data = _mm256_blendv_ps(values.data, partner_values.data, take.data);
+}
+
+template <typename... Regs> inline void bitonic_sort8(Regs &...regs)
+{
+    bitonic_step<0xAA>(swap_adjacent{}, regs...);
+    bitonic_step<0xCC>(reverse_quads{}, regs...);
+    bitonic_step<0xAA>(swap_adjacent{}, regs...);
+    bitonic_step<0xF0>(reverse_all{}, regs...);
+    bitonic_step<0xCC>(swap_pairs{}, regs...);
+    bitonic_step<0xAA>(swap_adjacent{}, regs...);
+}
+
+// sorts a bitonic 8-lane sequence
+template <typename... Regs> inline void bitonic_merge8(Regs &...regs)
+{
+    bitonic_step<0xF0>(swap_halves{}, regs...);
+    bitonic_step<0xCC>(swap_pairs{}, regs...);
+    bitonic_step<0xAA>(swap_adjacent{}, regs...);
+}
+
+inline void bitonic_sort16(simd_vector<float, AVX_SIZE> &lo, simd_vector<float, AVX_SIZE> &hi)
+{
+    bitonic_sort8(lo);
+    bitonic_sort8(hi);
+    const simd_vector<float, AVX_SIZE> rev = reverse_all{}(hi);
+    hi.data = _mm256_max_ps(lo.data, rev.data);
+    lo.data = _mm256_min_ps(lo.data, rev.data);
+    bitonic_merge8(lo);
+    bitonic_merge8(hi);
+}
+
+inline void bitonic_sort16(simd_vector<float, AVX_SIZE> &lo_keys,
+                           simd_vector<float, AVX_SIZE> &hi_keys,
+                           simd_vector<float, AVX_SIZE> &lo_values,
+                           simd_vector<float, AVX_SIZE> &hi_values)
+{
+    bitonic_sort8(lo_keys, lo_values);
+    bitonic_sort8(hi_keys, hi_values);
+    const simd_vector<float, AVX_SIZE> rev_keys = reverse_all{}(hi_keys);
+    const simd_vector<float, AVX_SIZE> rev_values = reverse_all{}(hi_values);
+    const simd_vector<float, AVX_SIZE> take = rev_keys < lo_keys;
+    hi_keys.data = _mm256_blendv_ps(rev_keys.data, lo_keys.data, take.data);
+    hi_values.data = _mm256_blendv_ps(rev_values.data, lo_values.data, take.data);
+    lo_keys.data = _mm256_blendv_ps(lo_keys.data, rev_keys.data, take.data);
+    lo_values.data = _mm256_blendv_ps(lo_values.data, rev_values.data, take.data);
+    bitonic_merge8(lo_keys, lo_values);
+    bitonic_merge8(hi_keys, hi_values);
+}
+
+// partitions below this size are finished with a sorting network
+constexpr size_t small_sort_threshold = 2 * AVX_SIZE;
+
+inline void small_sort(float *keys, size_t n)
+{
+    alignas(AVX_ALIGNMENT) std::array<float, 2 * AVX_SIZE> buf{};
+    buf.fill(std::numeric_limits<float>::infinity());
+    std::copy(keys, keys + n, buf.begin());
+    simd_vector<float, AVX_SIZE> lo(_mm256_load_ps(buf.data()));
+    simd_vector<float, AVX_SIZE> hi(_mm256_load_ps(buf.data() + AVX_SIZE));
+    if (n <= AVX_SIZE)
+        bitonic_sort8(lo);
+    else
+        bitonic_sort16(lo, hi);
+    _mm256_store_ps(buf.data(), lo.data);
+    _mm256_store_ps(buf.data() + AVX_SIZE, hi.data);
+    std::copy(buf.begin(), buf.begin() + static_cast<std::ptrdiff_t>(n), keys);
+}
+
+inline void small_sort(float *keys, uint32_t *values, size_t n)
+{
+    // +inf padding could trade places with a real +inf key and drop its payload
+    if (std::find(keys, keys + n, std::numeric_limits<float>::infinity()) != keys + n)
+    {
+        for (size_t i = 1; i < n; ++i)
+        {
+            const float key = keys[i];
+            const uint32_t value = values[i];
+            size_t j = i;
+            for (; j > 0 && key < keys[j - 1]; --j)
+            {
+                keys[j] = keys[j - 1];
+                values[j] = values[j - 1];
+            }
+            keys[j] = key;
+            values[j] = value;
+        }
+        return;
+    }
+
+    alignas(AVX_ALIGNMENT) std::array<float, 2 * AVX_SIZE> key_buf{};
+    alignas(AVX_ALIGNMENT) std::array<uint32_t, 2 * AVX_SIZE> value_buf{};
+    key_buf.fill(std::numeric_limits<float>::infinity());
+    std::copy(keys, keys + n, key_buf.begin());
+    std::copy(values, values + n, value_buf.begin());
+    simd_vector<float, AVX_SIZE> lo_keys(_mm256_load_ps(key_buf.data()));
+    simd_vector<float, AVX_SIZE> hi_keys(_mm256_load_ps(key_buf.data() + AVX_SIZE));
+    simd_vector<float, AVX_SIZE> lo_values(_mm256_castsi256_ps(
+        _mm256_load_si256(reinterpret_cast<const __m256i *>(value_buf.data()))));
+    simd_vector<float, AVX_SIZE> hi_values(_mm256_castsi256_ps(
+        _mm256_load_si256(reinterpret_cast<const __m256i *>(value_buf.data() + AVX_SIZE))));
+    if (n <= AVX_SIZE)
+        bitonic_sort8(lo_keys, lo_values);
+    else
+        bitonic_sort16(lo_keys, hi_keys, lo_values, hi_values);
+    _mm256_store_ps(key_buf.data(), lo_keys.data);
+    _mm256_store_ps(key_buf.data() + AVX_SIZE, hi_keys.data);
+    _mm256_store_si256(reinterpret_cast<__m256i *>(value_buf.data()),
+                       _mm256_castps_si256(lo_values.data));
+    _mm256_store_si256(reinterpret_cast<__m256i *>(value_buf.data() + AVX_SIZE),
+                       _mm256_castps_si256(hi_values.data));
+    std::copy(key_buf.begin(), key_buf.begin() + static_cast<std::ptrdiff_t>(n), keys);
+    std::copy(value_buf.begin(), value_buf.begin() + static_cast<std::ptrdiff_t>(n), values);
+}
+
+#ifdef __AVX2__
+// for each 8-bit comparison mask, a permutation moving the selected lanes to the front
+inline constexpr auto partition_permutations = []
+{
+    std::array<std::array<uint32_t, AVX_SIZE>, 256> lut{};
+    for (uint32_t mask = 0; mask < 256; ++mask)
+    {
+        uint32_t low = 0;
+        uint32_t high = static_cast<uint32_t>(std::popcount(mask));
+        for (uint32_t lane = 0; lane < AVX_SIZE; ++lane)
+        {
+            if ((mask >> lane) & 1U)
+                lut[mask][low++] = lane;
+            else
+                lut[mask][high++] = lane;
+        }
+    }
+    return lut;
+}();
+
+// writes the lanes that belong left of the pivot at left_w and the rest just below right_w,
+// each side as one full-width store into the slack freed by earlier loads
+template <bool Inclusive, bool HasValues>
+inline void partition_block(float *keys, uint32_t *values, const simd_vector<float, AVX_SIZE> &vec,
+                            __m256i payload, const simd_vector<float, AVX_SIZE> &pivot,
+                            size_t &left_w, size_t &right_w)
+{
+    const simd_vector<float, AVX_SIZE> goes_left = Inclusive ? vec <= pivot : vec < pivot;
+    const int mask = _mm256_movemask_ps(goes_left.data);
+    const auto nb_low = static_cast<size_t>(std::popcount(static_cast<uint32_t>(mask)));
+    const __m256i perm = _mm256_loadu_si256(
+        reinterpret_cast<const __m256i *>(partition_permutations[mask].data()));
+
+    const __m256 packed = _mm256_permutevar8x32_ps(vec.data, perm);
+    _mm256_storeu_ps(keys + left_w, packed);
+    _mm256_storeu_ps(keys + right_w - AVX_SIZE, packed);
+    if constexpr (HasValues)
+    {
+        const __m256i packed_values = _mm256_permutevar8x32_epi32(payload, perm);
+        _mm256_storeu_si256(reinterpret_cast<__m256i *>(values + left_w), packed_values);
+        _mm256_storeu_si256(reinterpret_cast<__m256i *>(values + right_w - AVX_SIZE),
+                            packed_values);
+    }
+    left_w += nb_low;
+    right_w -= AVX_SIZE - nb_low;
+}
+#endif
+
+// in-place partition around pivot, returns the size of the left part; n >= small_sort_threshold
+template <bool Inclusive, bool HasValues>
+inline size_t partition(float *keys, uint32_t *values, size_t n, float pivot)
+{
+    const auto goes_left = [pivot](float key) { return Inclusive ? key <= pivot : key < pivot; };
+#ifdef __AVX2__
+    const simd_vector<float, AVX_SIZE> pivot_vec(pivot);
+    const auto load_values = [values](size_t i)
+    {
+        if constexpr (HasValues)
+            return _mm256_loadu_si256(reinterpret_cast<const __m256i *>(values + i));
+        else
+            return _mm256_setzero_si256();
+    };
+
+    // the first and last blocks are held back so every later store lands in already-read slots
+    alignas(AVX_ALIGNMENT) std::array<float, 3 * AVX_SIZE> rest_keys{};
+    alignas(AVX_ALIGNMENT) std::array<uint32_t, 3 * AVX_SIZE> rest_values{};
+    std::copy(keys, keys + AVX_SIZE, rest_keys.begin());
+    std::copy(keys + n - AVX_SIZE, keys + n, rest_keys.begin() + AVX_SIZE);
+    if constexpr (HasValues)
+    {
+        std::copy(values, values + AVX_SIZE, rest_values.begin());
+        std::copy(values + n - AVX_SIZE, values + n, rest_values.begin() + AVX_SIZE);
+    }
+
+    size_t left = AVX_SIZE;
+    size_t right = n - AVX_SIZE;
+    size_t left_w = 0;
+    size_t right_w = n;
+    while (right - left >= AVX_SIZE)
+    {
+        // read from whichever side has less slack so both sides keep a full block free
+        size_t i = 0;
+        if (left - left_w <= right_w - right)
+        {
+            i = left;
+            left += AVX_SIZE;
+        }
+        else
+        {
+            right -= AVX_SIZE;
+            i = right;
+        }
+        const simd_vector<float, AVX_SIZE> vec(_mm256_loadu_ps(keys + i));
+        partition_block<Inclusive, HasValues>(keys, values, vec, load_values(i), pivot_vec, left_w,
+                                              right_w);
+    }
+
+    const size_t remaining = right - left;
+    std::copy(keys + left, keys + right, rest_keys.begin() + 2 * AVX_SIZE);
+    if constexpr (HasValues)
+        std::copy(values + left, values + right, rest_values.begin() + 2 * AVX_SIZE);
+    for (size_t i = 0; i < 2 * AVX_SIZE + remaining; ++i)
+    {
+        const size_t dst = goes_left(rest_keys[i]) ? left_w++ : --right_w;
+        keys[dst] = rest_keys[i];
+        if constexpr (HasValues)
+            values[dst] = rest_values[i];
+    }
+    return left_w;
+#else
+    size_t left_w = 0;
+    for (size_t i = 0; i < n; ++i)
+    {
+        if (goes_left(keys[i]))
+        {
+            std::swap(keys[i], keys[left_w]);
+            if constexpr (HasValues)
+                std::swap(values[i], values[left_w]);
+            ++left_w;
+        }
+    }
+    return left_w;
+#endif
+}
+
+template <bool HasValues>
+inline void quicksort(float *keys, uint32_t *values, size_t n, int depth)
+{
+    while (n > small_sort_threshold)
+    {
+        if (depth-- == 0)
+        {
+            // too many unbalanced splits, finish this range with a guaranteed n log n sort
+            if constexpr (HasValues)
+            {
+                std::vector<std::pair<float, uint32_t>> pairs(n);
+                for (size_t i = 0; i < n; ++i)
+                    pairs[i] = {keys[i], values[i]};
+                std::sort(pairs.begin(), pairs.end(),
+                          [](const auto &a, const auto &b) { return a.first < b.first; });
+                for (size_t i = 0; i < n; ++i)
+                    std::tie(keys[i], values[i]) = pairs[i];
+            }
+            else
+            {
+                std::sort(keys, keys + n);
+            }
+            return;
+        }
+
+        const float a = keys[0];
+        const float b = keys[n / 2];
+        const float c = keys[n - 1];
+        const float pivot = std::max(std::min(a, b), std::min(std::max(a, b), c));
+
+        size_t mid = partition<true, HasValues>(keys, values, n, pivot);
+        if (mid == n)
+        {
+            // pivot is the maximum, split off every copy of it
+            mid = partition<false, HasValues>(keys, values, n, pivot);
+            if (mid == 0)
+                return; // all keys equal
+            n = mid;
+            continue;
+        }
+
+        // recurse into the smaller side, loop on the larger one
+        if (mid < n - mid)
+        {
+            quicksort<HasValues>(keys, values, mid, depth);
+            keys += mid;
+            if constexpr (HasValues)
+                values += mid;
+            n -= mid;
+        }
+        else
+        {
+            quicksort<HasValues>(keys + mid, HasValues ? values + mid : values, n - mid, depth);
+            n = mid;
+        }
+    }
+    if constexpr (HasValues)
+        small_sort(keys, values, n);
+    else
+        small_sort(keys, n);
+}
+
+inline int quicksort_depth_limit(size_t n)
+{
+    return 2 * static_cast<int>(std::bit_width(n));
+}
+
+} // namespace detail
+
+// sort 8 floats held in one register
+inline void sort(simd_vector<float, AVX_SIZE> &vec)
+{
+    detail::bitonic_sort8(vec);
+}
+
+// sort 16 floats held in two registers, lo receives the smallest eight
+inline void sort(simd_vector<float, AVX_SIZE> &lo, simd_vector<float, AVX_SIZE> &hi)
+{
+    detail::bitonic_sort16(lo, hi);
+}
+
+// sort 8 keys and carry a uint32 payload per lane
+inline void sort(simd_vector<float, AVX_SIZE> &keys, __m256i &values)
+{
+    simd_vector<float, AVX_SIZE> payload(_mm256_castsi256_ps(values));
+    detail::bitonic_sort8(keys, payload);
+    values = _mm256_castps_si256(payload.data);
+}
+
+// sort 16 keys and their uint32 payloads held in two register pairs
+inline void sort(simd_vector<float, AVX_SIZE> &lo_keys, simd_vector<float, AVX_SIZE> &hi_keys,
+                 __m256i &lo_values, __m256i &hi_values)
+{
+    simd_vector<float, AVX_SIZE> lo_payload(_mm256_castsi256_ps(lo_values));
+    simd_vector<float, AVX_SIZE> hi_payload(_mm256_castsi256_ps(hi_values));
+    detail::bitonic_sort16(lo_keys, hi_keys, lo_payload, hi_payload);
+    lo_values = _mm256_castps_si256(lo_payload.data);
+    hi_values = _mm256_castps_si256(hi_payload.data);
+}
+
+// ascending in-place sort of a float array, keys must not be NaN
+inline void sort(std::span<float> keys)
+{
+    SIMDLIB_PERF_SCOPE("sort", 2 * keys.size_bytes());
+    detail::quicksort<false>(keys.data(), nullptr, keys.size(),
+                             detail::quicksort_depth_limit(keys.size()));
+}
+
+// ascending in-place sort of keys, applying the same permutation to values (not stable)
+inline void sort_key_value(std::span<float> keys, std::span<uint32_t> values)
+{
+    if (keys.size() != values.size())
+        throw std::invalid_argument("sort_key_value: keys and values differ in size");
+    SIMDLIB_PERF_SCOPE("sort_key_value", 2 * (keys.size_bytes() + values.size_bytes()));
+    detail::quicksort<true>(keys.data(), values.data(), keys.size(),
+                            detail::quicksort_depth_limit(keys.size()));
+}
+
+} // namespace simdlib
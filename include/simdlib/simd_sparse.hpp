@@ -0,0 +1,293 @@
+#pragma once
+
+#include "simd_allocator.hpp"
+#include "simd_parallel.hpp"
+#include "simd_perf.hpp"
+#include "simd_vector.hpp"
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <limits>
+#include <numeric>
+#include <span>
+#include <stdexcept>
+#include <vector>
+
+namespace simdlib
+{
+
+// compressed sparse row matrix: row r holds entries row_ptr[r] .. row_ptr[r + 1] of col_idx
+// and values
+struct csr_matrix
+{
+    size_t rows = 0;
+    size_t cols = 0;
+    std::vector<uint64_t> row_ptr{0};
+    std::vector<uint32_t> col_idx;
+    std::vector<float> values;
+
+    [[nodiscard]] size_t nonzeros() const
+    {
+        return values.size();
+    }
+};
+
+// SELL-C-sigma with C = 8: rows are sorted by length inside windows of sigma rows, cut into
+// chunks of eight and each chunk padded to its longest row. A chunk is stored column by
+// column, entry j of its eight rows in one vector, so the rows fill the lanes of a
+// simd_vector<float, 8>.
+struct sell_matrix
+{
+    static constexpr size_t chunk_rows = AVX_SIZE;
+    // column index of a padding slot; negative as the gather's signed index, so never a column
+    static constexpr uint32_t padding = std::numeric_limits<uint32_t>::max();
+
+    size_t rows = 0;
+    size_t cols = 0;
+    size_t sigma = 1;
+    // offset of each chunk's first entry, chunks + 1 of them, all multiples of 8
+    std::vector<uint64_t> chunk_ptr{0};
+    // original row held by each lane of each chunk, rows for the padding lanes of the last chunk
+    std::vector<uint32_t> row_of_slot;
+    aligned_vector<uint32_t> col_idx;
+    aligned_vector<float> values;
+
+    [[nodiscard]] size_t chunks() const
+    {
+        return chunk_ptr.size() - 1;
+    }
+
+    // stored entries including padding, over the real non-zeros is the padding overhead
+    [[nodiscard]] size_t stored() const
+    {
+        return values.size();
+    }
+};
+
+namespace detail
+{
+
+// non-zeros a worker thread must have before an SpMV is split
+constexpr size_t spmv_min_chunk = size_t{1} << 16;
+
+inline void check_csr(const csr_matrix &a)
+{
+    if (a.row_ptr.size() != a.rows + 1 || a.row_ptr.front() != 0 ||
+        a.row_ptr.back() != a.values.size() || a.col_idx.size() != a.values.size())
+        throw std::invalid_argument("csr_matrix: row_ptr, col_idx and values are inconsistent");
+    if (a.cols > static_cast<size_t>(std::numeric_limits<int32_t>::max()) ||
+        a.rows > std::numeric_limits<uint32_t>::max())
+        throw std::invalid_argument("csr_matrix: dimensions must fit the 32-bit gather indices");
+}
+
+inline void check_spmv(size_t rows, size_t cols, std::span<const float> x, std::span<float> y)
+{
+    if (x.size() != cols || y.size() != rows)
+        throw std::invalid_argument("spmv: x must have one entry per column and y one per row");
+}
+
+// runs body(first, last) over the units [0, units) in thread ranges holding about the same
+// number of entries; offsets[u] is where unit u's entries start, offsets[units] the total
+template <typename Body>
+inline void partition_by_entries(std::span<const uint64_t> offsets, size_t threads, Body body)
+{
+    const size_t units = offsets.size() - 1;
+    const size_t entries = offsets.back();
+    // the first unit starting at or after entry e
+    const auto unit_at = [&](size_t e)
+    {
+        return static_cast<size_t>(std::lower_bound(offsets.begin(), offsets.end() - 1, e) -
+                                   offsets.begin());
+    };
+    parallel_for(entries, chunk_count(threads, entries, spmv_min_chunk),
+                 [&](size_t begin, size_t end, size_t)
+                 { body(unit_at(begin), end == entries ? units : unit_at(end)); });
+}
+
+inline float csr_row_dot(const csr_matrix &a, const float *x, size_t r)
+{
+    const size_t begin = a.row_ptr[r];
+    const size_t end = a.row_ptr[r + 1];
+    const uint32_t *cols = a.col_idx.data();
+    const float *vals = a.values.data();
+    size_t j = begin;
+    float sum = 0.0f;
+#ifdef __AVX2__
+    if (end - begin >= AVX_SIZE)
+    {
+        simd_vector<float, AVX_SIZE> acc;
+        for (; j + AVX_SIZE <= end; j += AVX_SIZE)
+        {
+            const __m256i idx = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(cols + j));
+            const simd_vector<float, AVX_SIZE> xv(_mm256_i32gather_ps(x, idx, sizeof(float)));
+            acc = simd_vector<float, AVX_SIZE>(_mm256_loadu_ps(vals + j)).fmadd(xv, acc);
+        }
+        sum = acc.horizontal_sum();
+    }
+#endif
+    // short rows and tails are cheaper scalar than through a masked gather
+    for (; j < end; ++j)
+        sum += vals[j] * x[cols[j]];
+    return sum;
+}
+
+#ifdef __AVX2__
+// x at the eight column indices, 0 in padding slots without touching x
+inline simd_vector<float, AVX_SIZE> sell_gather(const float *x, const uint32_t *cols)
+{
+    const __m256i idx = _mm256_load_si256(reinterpret_cast<const __m256i *>(cols));
+    const __m256 real = _mm256_castsi256_ps(_mm256_cmpgt_epi32(idx, _mm256_set1_epi32(-1)));
+    return simd_vector<float, AVX_SIZE>(
+        _mm256_mask_i32gather_ps(_mm256_setzero_ps(), x, idx, real, sizeof(float)));
+}
+#endif
+
+inline void sell_chunk(const sell_matrix &a, const float *x, size_t c, float *y)
+{
+    const size_t begin = a.chunk_ptr[c];
+    const size_t end = a.chunk_ptr[c + 1];
+    const uint32_t *slots = a.row_of_slot.data() + c * AVX_SIZE;
+#ifdef __AVX2__
+    simd_vector<float, AVX_SIZE> acc0;
+    simd_vector<float, AVX_SIZE> acc1;
+    size_t j = begin;
+    // two accumulators so consecutive gathers do not wait on each other's fma
+    for (; j + 2 * AVX_SIZE <= end; j += 2 * AVX_SIZE)
+    {
+        const auto x0 = sell_gather(x, a.col_idx.data() + j);
+        const auto x1 = sell_gather(x, a.col_idx.data() + j + AVX_SIZE);
+        acc0 = simd_vector<float, AVX_SIZE>(_mm256_load_ps(a.values.data() + j)).fmadd(x0, acc0);
+        acc1 = simd_vector<float, AVX_SIZE>(_mm256_load_ps(a.values.data() + j + AVX_SIZE))
+                   .fmadd(x1, acc1);
+    }
+    if (j < end)
+    {
+        const auto xv = sell_gather(x, a.col_idx.data() + j);
+        acc0 = simd_vector<float, AVX_SIZE>(_mm256_load_ps(a.values.data() + j)).fmadd(xv, acc0);
+    }
+    alignas(AVX_ALIGNMENT) std::array<float, AVX_SIZE> sums{};
+    _mm256_store_ps(sums.data(), (acc0 + acc1).data);
+#else
+    std::array<float, AVX_SIZE> sums{};
+    for (size_t j = begin; j < end; j += AVX_SIZE)
+    {
+        for (size_t k = 0; k < AVX_SIZE; ++k)
+        {
+            if (a.col_idx[j + k] != sell_matrix::padding)
+                sums[k] += a.values[j + k] * x[a.col_idx[j + k]];
+        }
+    }
+#endif
+    for (size_t k = 0; k < AVX_SIZE; ++k)
+    {
+        if (slots[k] < a.rows)
+            y[slots[k]] = sums[k];
+    }
+}
+
+} // namespace detail
+
+// SELL-C-sigma copy of a CSR matrix; sigma is 1 (no sorting, rows stay in order) or a
+// multiple of 8, larger windows cut the padding but scatter y further
+inline sell_matrix to_sell(const csr_matrix &a, size_t sigma = 256)
+{
+    detail::check_csr(a);
+    if (sigma != 1 && (sigma == 0 || sigma % sell_matrix::chunk_rows != 0))
+        throw std::invalid_argument("to_sell: sigma must be 1 or a multiple of 8");
+    for (const uint32_t c : a.col_idx)
+    {
+        if (c >= a.cols)
+            throw std::invalid_argument("to_sell: column index out of range");
+    }
+
+    constexpr size_t lanes = sell_matrix::chunk_rows;
+    sell_matrix s;
+    s.rows = a.rows;
+    s.cols = a.cols;
+    s.sigma = sigma;
+    const size_t chunks = (a.rows + lanes - 1) / lanes;
+    const auto length = [&a](size_t r) { return a.row_ptr[r + 1] - a.row_ptr[r]; };
+
+    // longest rows first within each window; stable so equal rows keep their order
+    s.row_of_slot.resize(chunks * lanes, static_cast<uint32_t>(a.rows));
+    std::iota(s.row_of_slot.begin(), s.row_of_slot.begin() + static_cast<std::ptrdiff_t>(a.rows),
+              uint32_t{0});
+    if (sigma > 1)
+    {
+        for (size_t w = 0; w < a.rows; w += sigma)
+        {
+            const auto first = s.row_of_slot.begin() + static_cast<std::ptrdiff_t>(w);
+            const auto last =
+                s.row_of_slot.begin() + static_cast<std::ptrdiff_t>(std::min(a.rows, w + sigma));
+            std::stable_sort(first, last,
+                             [&](uint32_t p, uint32_t q) { return length(p) > length(q); });
+        }
+    }
+
+    s.chunk_ptr.resize(chunks + 1);
+    for (size_t c = 0; c < chunks; ++c)
+    {
+        uint64_t width = 0;
+        for (size_t k = 0; k < lanes; ++k)
+        {
+            const uint32_t r = s.row_of_slot[c * lanes + k];
+            if (r < a.rows)
+                width = std::max(width, length(r));
+        }
+        s.chunk_ptr[c + 1] = s.chunk_ptr[c] + width * lanes;
+    }
+
+    // padding slots are masked out of the gather, so a non-finite x cannot leak into short rows
+    s.col_idx.assign(s.chunk_ptr.back(), sell_matrix::padding);
+    s.values.assign(s.chunk_ptr.back(), 0.0f);
+    for (size_t c = 0; c < chunks; ++c)
+    {
+        for (size_t k = 0; k < lanes; ++k)
+        {
+            const uint32_t r = s.row_of_slot[c * lanes + k];
+            if (r >= a.rows)
+                continue;
+            for (uint64_t j = 0; j < length(r); ++j)
+            {
+                s.col_idx[s.chunk_ptr[c] + j * lanes + k] = a.col_idx[a.row_ptr[r] + j];
+                s.values[s.chunk_ptr[c] + j * lanes + k] = a.values[a.row_ptr[r] + j];
+            }
+        }
+    }
+    return s;
+}
+
+// y = A x, rows split across threads by non-zero count; column indices are trusted to be
+// below a.cols
+inline void spmv(const csr_matrix &a, std::span<const float> x, std::span<float> y,
+                 size_t threads = 1)
+{
+    detail::check_csr(a);
+    detail::check_spmv(a.rows, a.cols, x, y);
+    SIMDLIB_PERF_SCOPE("spmv_csr", a.nonzeros() * (sizeof(float) + sizeof(uint32_t)) +
+                                       x.size_bytes() + y.size_bytes());
+    detail::partition_by_entries(a.row_ptr, threads,
+                                 [&](size_t first, size_t last)
+                                 {
+                                     for (size_t r = first; r < last; ++r)
+                                         y[r] = detail::csr_row_dot(a, x.data(), r);
+                                 });
+}
+
+// y = A x over the SELL-C-sigma layout, eight rows per vector, chunks split across threads by
+// stored entries
+inline void spmv(const sell_matrix &a, std::span<const float> x, std::span<float> y,
+                 size_t threads = 1)
+{
+    detail::check_spmv(a.rows, a.cols, x, y);
+    SIMDLIB_PERF_SCOPE("spmv_sell", a.stored() * (sizeof(float) + sizeof(uint32_t)) +
+                                        x.size_bytes() + y.size_bytes());
+    detail::partition_by_entries(a.chunk_ptr, threads,
+                                 [&](size_t first, size_t last)
+                                 {
+                                     for (size_t c = first; c < last; ++c)
+                                         detail::sell_chunk(a, x.data(), c, y.data());
+                                 });
+}
+
+} // namespace simdlib
@@ -73,6 +73,16 @@ template <> struct simd_vector<float, SSE_SIZE>
         return simd_vector(_mm_div_ps(data, other.data));
     }
 
+    // Fused multiply-add: *this * mul + add
+    simd_vector fmadd(const simd_vector &mul, const simd_vector &add) const
+    {
+#ifdef __FMA__
+        return simd_vector(_mm_fmadd_ps(data, mul.data, add.data));
+#else
+        return simd_vector(_mm_add_ps(_mm_mul_ps(data, mul.data), add.data));
+#endif
+    }
+
     // Element-wise conditional operations
     simd_vector operator==(const simd_vector &other) const
     {
@@ -104,6 +114,49 @@ template <> struct simd_vector<float, SSE_SIZE>
         return simd_vector(_mm_cmpge_ps(data, other.data));
     }
 
+    // Bitwise operations, for combining comparison masks
+    simd_vector operator&(const simd_vector &other) const
+    {
+        return simd_vector(_mm_and_ps(data, other.data));
+    }
+
+    simd_vector operator|(const simd_vector &other) const
+    {
+        return simd_vector(_mm_or_ps(data, other.data));
+    }
+
+    simd_vector operator^(const simd_vector &other) const
+    {
+        return simd_vector(_mm_xor_ps(data, other.data));
+    }
+
+    simd_vector &operator&=(const simd_vector &other)
+    {
+        return *this = *this & other;
+    }
+
+    simd_vector &operator|=(const simd_vector &other)
+    {
+        return *this = *this | other;
+    }
+
+    simd_vector &operator^=(const simd_vector &other)
+    {
+        return *this = *this ^ other;
+    }
+
+    // ~*this & other
+    simd_vector andnot(const simd_vector &other) const
+    {
+        return simd_vector(_mm_andnot_ps(data, other.data));
+    }
+
+    // sign bit of each lane, lane 0 in bit 0
+    [[nodiscard]] int movemask() const
+    {
+        return _mm_movemask_ps(data);
+    }
+
     // Transpose method for 4x4 matrix
     static void transpose(simd_vector &row0, simd_vector &row1, simd_vector &row2,
                           simd_vector &row3)
@@ -234,6 +287,16 @@ template <> struct simd_vector<float, AVX_SIZE>
         return simd_vector(_mm256_div_ps(data, other.data));
     }
 
+    // Fused multiply-add: *this * mul + add
+    simd_vector fmadd(const simd_vector &mul, const simd_vector &add) const
+    {
+#ifdef __FMA__
+        return simd_vector(_mm256_fmadd_ps(data, mul.data, add.data));
+#else
+        return simd_vector(_mm256_add_ps(_mm256_mul_ps(data, mul.data), add.data));
+#endif
+    }
+
     // Element-wise conditional operations
     simd_vector operator==(const simd_vector &other) const
     {
@@ -265,6 +328,49 @@ template <> struct simd_vector<float, AVX_SIZE>
         return simd_vector(_mm256_cmp_ps(data, other.data, _CMP_GE_OQ));
     }
 
+    // Bitwise operations, for combining comparison masks
+    simd_vector operator&(const simd_vector &other) const
+    {
+        return simd_vector(_mm256_and_ps(data, other.data));
+    }
+
+    simd_vector operator|(const simd_vector &other) const
+    {
+        return simd_vector(_mm256_or_ps(data, other.data));
+    }
+
+    simd_vector operator^(const simd_vector &other) const
+    {
+        return simd_vector(_mm256_xor_ps(data, other.data));
+    }
+
+    simd_vector &operator&=(const simd_vector &other)
+    {
+        return *this = *this & other;
+    }
+
+    simd_vector &operator|=(const simd_vector &other)
+    {
+        return *this = *this | other;
+    }
+
+    simd_vector &operator^=(const simd_vector &other)
+    {
+        return *this = *this ^ other;
+    }
+
+    // ~*this & other
+    simd_vector andnot(const simd_vector &other) const
+    {
+        return simd_vector(_mm256_andnot_ps(data, other.data));
+    }
+
+    // sign bit of each lane, lane 0 in bit 0
+    [[nodiscard]] int movemask() const
+    {
+        return _mm256_movemask_ps(data);
+    }
+
     // Transpose method for 8x8 matrix
     static void transpose(simd_vector &row0, simd_vector &row1, simd_vector &row2,
                           simd_vector &row3, simd_vector &row4, simd_vector &row5,
@@ -291,34 +397,35 @@ template <> struct simd_vector<float, AVX_SIZE>
 
     [[nodiscard]]float horizontal_sum() const
     {
-        __m256 shuf = _mm256_movehdup_ps(data); // Broadcast elements 3,1 to 2,0
-        __m256 sums = _mm256_add_ps(data, shuf);
-        shuf = _mm256_permute2f128_ps(sums, sums, 0x1);
-        sums = _mm256_add_ps(sums, shuf);
-        return _mm_cvtss_f32(
-            _mm_add_ps(_mm256_castps256_ps128(sums), _mm256_extractf128_ps(sums, 1)));
+        // Fold the high 128-bit half onto the low half, then reduce 4 lanes
+        __m128 sums = _mm_add_ps(_mm256_castps256_ps128(data), _mm256_extractf128_ps(data, 1));
+        __m128 shuf = _mm_movehdup_ps(sums); // Broadcast elements 3,1 to 2,0
+        sums = _mm_add_ps(sums, shuf);
+        shuf = _mm_movehl_ps(shuf, sums); // High half -> low half
+        sums = _mm_add_ss(sums, shuf);
+        return _mm_cvtss_f32(sums);
     }
 
     // Horizontal max
     [[nodiscard]]float horizontal_max() const
     {
-        __m256 shuf = _mm256_movehdup_ps(data);
-        __m256 maxs = _mm256_max_ps(data, shuf);
-        shuf = _mm256_permute2f128_ps(maxs, maxs, 0x1);
-        maxs = _mm256_max_ps(maxs, shuf);
-        return _mm_cvtss_f32(
-            _mm_max_ps(_mm256_castps256_ps128(maxs), _mm256_extractf128_ps(maxs, 1)));
+        __m128 maxs = _mm_max_ps(_mm256_castps256_ps128(data), _mm256_extractf128_ps(data, 1));
+        __m128 shuf = _mm_movehdup_ps(maxs);
+        maxs = _mm_max_ps(maxs, shuf);
+        shuf = _mm_movehl_ps(shuf, maxs);
+        maxs = _mm_max_ss(maxs, shuf);
+        return _mm_cvtss_f32(maxs);
     }
 
     // Horizontal min
     [[nodiscard]]float horizontal_min() const
     {
-        __m256 shuf = _mm256_movehdup_ps(data);
-        __m256 mins = _mm256_min_ps(data, shuf);
-        shuf = _mm256_permute2f128_ps(mins, mins, 0x1);
-        mins = _mm256_min_ps(mins, shuf);
-        return _mm_cvtss_f32(
-            _mm_min_ps(_mm256_castps256_ps128(mins), _mm256_extractf128_ps(mins, 1)));
+        __m128 mins = _mm_min_ps(_mm256_castps256_ps128(data), _mm256_extractf128_ps(data, 1));
+        __m128 shuf = _mm_movehdup_ps(mins);
+        mins = _mm_min_ps(mins, shuf);
+        shuf = _mm_movehl_ps(shuf, mins);
+        mins = _mm_min_ss(mins, shuf);
+        return _mm_cvtss_f32(mins);
     }
     // Shuffle operation
     simd_vector shuffle(int imm8) const
@@ -408,6 +515,12 @@ template <> struct simd_vector<float, SSE_SIZE>
         return simd_vector(vdivq_f32(data, other.data));
     }
 
+    // Fused multiply-add: *this * mul + add
+    simd_vector fmadd(const simd_vector &mul, const simd_vector &add) const
+    {
+        return simd_vector(vfmaq_f32(add.data, data, mul.data));
+    }
+
     // Element-wise conditional operations
     simd_vector operator==(const simd_vector &other) const
     {
@@ -439,6 +552,55 @@ template <> struct simd_vector<float, SSE_SIZE>
         return simd_vector(vcgeq_f32(data, other.data));
     }
 
+    // Bitwise operations, for combining comparison masks
+    simd_vector operator&(const simd_vector &other) const
+    {
+        return simd_vector(vreinterpretq_f32_u32(
+            vandq_u32(vreinterpretq_u32_f32(data), vreinterpretq_u32_f32(other.data))));
+    }
+
+    simd_vector operator|(const simd_vector &other) const
+    {
+        return simd_vector(vreinterpretq_f32_u32(
+            vorrq_u32(vreinterpretq_u32_f32(data), vreinterpretq_u32_f32(other.data))));
+    }
+
+    simd_vector operator^(const simd_vector &other) const
+    {
+        return simd_vector(vreinterpretq_f32_u32(
+            veorq_u32(vreinterpretq_u32_f32(data), vreinterpretq_u32_f32(other.data))));
+    }
+
+    simd_vector &operator&=(const simd_vector &other)
+    {
+        return *this = *this & other;
+    }
+
+    simd_vector &operator|=(const simd_vector &other)
+    {
+        return *this = *this | other;
+    }
+
+    simd_vector &operator^=(const simd_vector &other)
+    {
+        return *this = *this ^ other;
+    }
+
+    // ~*this & other
+    simd_vector andnot(const simd_vector &other) const
+    {
+        return simd_vector(vreinterpretq_f32_u32(
+            vbicq_u32(vreinterpretq_u32_f32(other.data), vreinterpretq_u32_f32(data))));
+    }
+
+    // sign bit of each lane, lane 0 in bit 0
+    [[nodiscard]] int movemask() const
+    {
+        const int32x4_t shifts = {0, 1, 2, 3};
+        const uint32x4_t signs = vshrq_n_u32(vreinterpretq_u32_f32(data), 31);
+        return static_cast<int>(vaddvq_u32(vshlq_u32(signs, shifts)));
+    }
+
     // Transpose method for 4x4 matrix
     static void transpose(simd_vector &row0, simd_vector &row1, simd_vector &row2,
                           simd_vector &row3)
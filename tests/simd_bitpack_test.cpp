@@ -0,0 +1,136 @@
+#include <gtest/gtest.h>
+#include "../include/simdlib/simd_bitpack.hpp"
+#include <limits>
+#include <random>
+#include <vector>
+
+namespace simdlib
+{
+
+namespace
+{
+
+std::vector<int32_t> random_column(size_t n, int32_t lo, int32_t hi, unsigned seed)
+{
+    std::mt19937 rng(seed);
+    std::uniform_int_distribution<int32_t> dist(lo, hi);
+    std::vector<int32_t> values(n);
+    for (auto &v : values)
+        v = dist(rng);
+    return values;
+}
+
+void expect_round_trip(const std::vector<int32_t> &values, bitpack_encoding encoding)
+{
+    const packed_column column(values, encoding, 3);
+    ASSERT_EQ(column.size(), values.size());
+    std::vector<int32_t> decoded(values.size());
+    column.decode(decoded, 2);
+    EXPECT_EQ(decoded, values);
+    std::vector<float> floats(values.size());
+    column.decode(floats);
+    for (size_t i = 0; i < values.size(); ++i)
+        EXPECT_EQ(floats[i], static_cast<float>(values[i])) << i;
+}
+
+} // namespace
+
+TEST(SimdBitpackTest, BlocksRoundTripAtEveryWidth)
+{
+    std::mt19937 rng(1);
+    for (unsigned bits = 0; bits <= 32; ++bits)
+    {
+        std::vector<uint32_t> values(bitpack_block_size);
+        for (auto &v : values)
+            v = static_cast<uint32_t>(rng()) & detail::low_bits_mask(bits);
+        std::vector<uint32_t> words(bits * 8);
+        bitpack_block(values, bits, words);
+        std::vector<uint32_t> back(bitpack_block_size);
+        bitunpack_block(words, bits, back);
+        EXPECT_EQ(back, values) << bits;
+    }
+}
+
+TEST(SimdBitpackTest, BlockLayoutIsVertical)
+{
+    // value i sits in lane i % 8 at bit position (i / 8) * bits of that lane's words
+    std::vector<uint32_t> values(bitpack_block_size);
+    for (size_t i = 0; i < values.size(); ++i)
+        values[i] = (i % 8 == 3) ? 1 : 0;
+    std::vector<uint32_t> words(8);
+    bitpack_block(values, 1, words);
+    for (size_t lane = 0; lane < 8; ++lane)
+        EXPECT_EQ(words[lane], lane == 3 ? ~uint32_t{0} : 0u);
+
+    // high bits beyond the width are dropped
+    std::fill(values.begin(), values.end(), 0xFFu);
+    words.assign(4 * 8, 0);
+    bitpack_block(values, 4, words);
+    std::vector<uint32_t> back(bitpack_block_size);
+    bitunpack_block(words, 4, back);
+    EXPECT_EQ(back, std::vector<uint32_t>(bitpack_block_size, 0xFu));
+}
+
+TEST(SimdBitpackTest, ColumnsRoundTrip)
+{
+    constexpr int32_t lo = std::numeric_limits<int32_t>::min();
+    constexpr int32_t hi = std::numeric_limits<int32_t>::max();
+    for (const size_t n : {0, 1, 255, 256, 257, 10000})
+    {
+        for (const auto encoding : {bitpack_encoding::frame_of_reference, bitpack_encoding::delta})
+        {
+            expect_round_trip(random_column(n, -1000, 1000, 2), encoding);
+            expect_round_trip(random_column(n, lo, hi, 3), encoding);
+        }
+    }
+    expect_round_trip({lo, hi, lo, hi, 0, -1, 1}, bitpack_encoding::delta);
+}
+
+TEST(SimdBitpackTest, WidthsFollowTheData)
+{
+    // sorted ids with gaps below 16: row deltas stay under 8 * 16
+    std::vector<int32_t> sorted(5000);
+    std::mt19937 rng(4);
+    int32_t id = -70000;
+    for (auto &v : sorted)
+        v = id += static_cast<int32_t>(rng() % 16);
+    const packed_column delta(sorted, bitpack_encoding::delta);
+    for (size_t b = 0; b < delta.blocks(); ++b)
+        EXPECT_LE(delta.block_bits(b), 7u) << b;
+    EXPECT_LT(delta.packed_bytes(), sorted.size() * sizeof(int32_t) / 4);
+
+    const auto narrow = random_column(1000, 500, 500 + 1023, 5);
+    const packed_column reference(narrow);
+    for (size_t b = 0; b < reference.blocks(); ++b)
+        EXPECT_LE(reference.block_bits(b), 10u);
+
+    const packed_column constant(std::vector<int32_t>(600, 42));
+    EXPECT_EQ(constant.block_bits(0), 0u);
+    std::vector<int32_t> out(600);
+    constant.decode(out);
+    EXPECT_EQ(out, std::vector<int32_t>(600, 42));
+}
+
+TEST(SimdBitpackTest, SingleBlocksAndErrors)
+{
+    const auto values = random_column(600, -5, 5000, 6);
+    const packed_column column(values, bitpack_encoding::delta);
+    ASSERT_EQ(column.blocks(), 3u);
+    std::vector<int32_t> block(bitpack_block_size);
+    column.decode_block(1, block);
+    EXPECT_TRUE(std::equal(block.begin(), block.end(), values.begin() + 256));
+    std::vector<float> last(600 - 512);
+    column.decode_block(2, last);
+    for (size_t i = 0; i < last.size(); ++i)
+        EXPECT_EQ(last[i], static_cast<float>(values[512 + i]));
+
+    EXPECT_THROW(column.decode_block(2, block), std::invalid_argument);
+    EXPECT_THROW(column.decode_block(3, last), std::invalid_argument);
+    std::vector<int32_t> wrong(599);
+    EXPECT_THROW(column.decode(wrong), std::invalid_argument);
+    std::vector<uint32_t> raw(bitpack_block_size), words(8 * 3);
+    EXPECT_THROW(bitpack_block(raw, 4, words), std::invalid_argument);
+    EXPECT_THROW(bitunpack_block(words, 33, raw), std::invalid_argument);
+}
+
+} // namespace simdlib
@@ -0,0 +1,132 @@
+#include <gtest/gtest.h>
+#include "../include/simdlib/simd_bitset.hpp"
+#include <bit>
+#include <random>
+#include <vector>
+
+namespace simdlib
+{
+
+namespace
+{
+
+// a mix of dense, sparse, empty and full words
+std::vector<uint64_t> random_bitmap(size_t words, unsigned seed)
+{
+    std::mt19937_64 rng(seed);
+    std::vector<uint64_t> map(words);
+    for (size_t i = 0; i < words; ++i)
+    {
+        switch (rng() % 4)
+        {
+        case 0:
+            map[i] = 0;
+            break;
+        case 1:
+            map[i] = ~uint64_t{0};
+            break;
+        case 2:
+            map[i] = rng() & rng() & rng();
+            break;
+        default:
+            map[i] = rng();
+        }
+    }
+    return map;
+}
+
+uint64_t scalar_popcount(const std::vector<uint64_t> &words)
+{
+    uint64_t count = 0;
+    for (const uint64_t w : words)
+        count += static_cast<uint64_t>(std::popcount(w));
+    return count;
+}
+
+} // namespace
+
+TEST(SimdBitsetTest, OperationsMatchScalar)
+{
+    for (const size_t words : {0, 1, 3, 4, 63, 64, 65, 1000, 70001})
+    {
+        const auto a = random_bitmap(words, static_cast<unsigned>(words));
+        const auto b = random_bitmap(words, static_cast<unsigned>(words) + 1);
+        std::vector<uint64_t> expected_and(words), expected_or(words), expected_xor(words),
+            expected_andnot(words);
+        for (size_t i = 0; i < words; ++i)
+        {
+            expected_and[i] = a[i] & b[i];
+            expected_or[i] = a[i] | b[i];
+            expected_xor[i] = a[i] ^ b[i];
+            expected_andnot[i] = a[i] & ~b[i];
+        }
+
+        EXPECT_EQ(bitmap_popcount(a), scalar_popcount(a));
+        std::vector<uint64_t> out(words);
+        EXPECT_EQ(bitmap_and(a, b, out), scalar_popcount(expected_and));
+        EXPECT_EQ(out, expected_and);
+        EXPECT_EQ(bitmap_or(a, b, out), scalar_popcount(expected_or));
+        EXPECT_EQ(out, expected_or);
+        EXPECT_EQ(bitmap_xor(a, b, out), scalar_popcount(expected_xor));
+        EXPECT_EQ(out, expected_xor);
+        EXPECT_EQ(bitmap_andnot(a, b, out), scalar_popcount(expected_andnot));
+        EXPECT_EQ(out, expected_andnot);
+
+        EXPECT_EQ(bitmap_and_count(a, b), scalar_popcount(expected_and));
+        EXPECT_EQ(bitmap_or_count(a, b), scalar_popcount(expected_or));
+        EXPECT_EQ(bitmap_xor_count(a, b), scalar_popcount(expected_xor));
+        EXPECT_EQ(bitmap_andnot_count(a, b), scalar_popcount(expected_andnot));
+    }
+}
+
+TEST(SimdBitsetTest, ThreadsAndAliasing)
+{
+    const auto a = random_bitmap(300001, 9);
+    auto b = random_bitmap(300001, 10);
+    const uint64_t expected = bitmap_and_count(a, b);
+    EXPECT_EQ(bitmap_and_count(a, b, 4), expected);
+    EXPECT_EQ(bitmap_popcount(a, 0), scalar_popcount(a));
+    EXPECT_EQ(bitmap_and(a, b, b, 3), expected);
+    EXPECT_EQ(bitmap_popcount(b), expected);
+}
+
+TEST(SimdBitsetTest, SetBitIteration)
+{
+    for (const size_t words : {0, 1, 5, 8, 129})
+    {
+        const auto map = random_bitmap(words, static_cast<unsigned>(words) + 20);
+        std::vector<uint32_t> expected;
+        for (size_t i = 0; i < words * 64; ++i)
+        {
+            if ((map[i / 64] >> (i % 64)) & 1)
+                expected.push_back(static_cast<uint32_t>(i));
+        }
+
+        std::vector<uint32_t> visited;
+        for_each_set_bit(map, [&](size_t i) { visited.push_back(static_cast<uint32_t>(i)); });
+        EXPECT_EQ(visited, expected);
+
+        // exactly sized output takes the one-at-a-time path near the end
+        std::vector<uint32_t> positions(expected.size());
+        EXPECT_EQ(set_bit_positions(map, positions), expected.size());
+        EXPECT_EQ(positions, expected);
+        std::vector<uint32_t> roomy(expected.size() + 64, 7);
+        EXPECT_EQ(set_bit_positions(map, roomy), expected.size());
+        EXPECT_TRUE(std::equal(expected.begin(), expected.end(), roomy.begin()));
+        if (!expected.empty())
+        {
+            std::vector<uint32_t> small(expected.size() - 1);
+            EXPECT_THROW(set_bit_positions(map, small), std::invalid_argument);
+        }
+    }
+}
+
+TEST(SimdBitsetTest, SizeMismatchThrows)
+{
+    std::vector<uint64_t> a(4), b(5);
+    EXPECT_THROW(bitmap_and(a, b, a), std::invalid_argument);
+    EXPECT_THROW(bitmap_or(a, a, b), std::invalid_argument);
+    EXPECT_THROW((void)bitmap_xor_count(a, b), std::invalid_argument);
+}
+
+} // namespace simdlib
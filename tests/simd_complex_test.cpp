@@ -0,0 +1,149 @@
+#include <gtest/gtest.h>
+#include "../include/simdlib/simd_complex.hpp"
+#include <cmath>
+#include <complex>
+#include <random>
+#include <vector>
+
+namespace simdlib
+{
+
+namespace
+{
+
+std::vector<std::complex<float>> random_complex(size_t n, unsigned seed)
+{
+    std::mt19937 rng(seed);
+    std::uniform_real_distribution<float> dist(-2.0f, 2.0f);
+    std::vector<std::complex<float>> z(n);
+    for (auto &v : z)
+        v = {dist(rng), dist(rng)};
+    return z;
+}
+
+void expect_near(std::complex<float> actual, std::complex<double> expected, double tolerance)
+{
+    EXPECT_NEAR(actual.real(), expected.real(), tolerance);
+    EXPECT_NEAR(actual.imag(), expected.imag(), tolerance);
+}
+
+std::complex<double> widen(std::complex<float> z)
+{
+    return {z.real(), z.imag()};
+}
+
+} // namespace
+
+TEST(SimdComplexTest, VectorArithmetic)
+{
+    const std::vector<std::complex<float>> a = {{1, 2}, {-3, 0.5f}, {0, -1}, {4, 4}};
+    const std::vector<std::complex<float>> b = {{3, -1}, {2, 2}, {-1, 0}, {0.5f, -0.25f}};
+    const auto x = simd_complex<float, AVX_SIZE>::load(a.data());
+    const auto y = simd_complex<float, AVX_SIZE>::load(b.data());
+    const simd_complex<float, AVX_SIZE> acc(std::complex<float>(10, -10));
+    for (size_t i = 0; i < 4; ++i)
+    {
+        EXPECT_EQ((x * y)[i], a[i] * b[i]);
+        EXPECT_EQ((x + y)[i], a[i] + b[i]);
+        EXPECT_EQ((x - y)[i], a[i] - b[i]);
+        EXPECT_EQ(x.conj()[i], std::conj(a[i]));
+        EXPECT_EQ(x.fmadd(y, acc)[i], a[i] * b[i] + std::complex<float>(10, -10));
+        EXPECT_FLOAT_EQ(x.norm()[2 * i], std::norm(a[i]));
+        EXPECT_FLOAT_EQ(x.abs()[2 * i + 1], std::abs(a[i]));
+    }
+    expect_near(x.horizontal_sum(), widen(a[0] + a[1] + a[2] + a[3]), 1e-6);
+
+    const auto s = simd_complex<float, SSE_SIZE>::load(a.data());
+    const auto t = simd_complex<float, SSE_SIZE>::load(b.data());
+    for (size_t i = 0; i < 2; ++i)
+    {
+        EXPECT_EQ((s * t)[i], a[i] * b[i]);
+        EXPECT_EQ((s * 2.0f)[i], a[i] * 2.0f);
+    }
+    const auto one = simd_complex<float, SSE_SIZE>::load1(&a[1]);
+    EXPECT_EQ(one[0], a[1]);
+    EXPECT_EQ(one[1], std::complex<float>());
+}
+
+TEST(SimdComplexTest, InterleavedKernels)
+{
+    for (const size_t n : {0, 1, 2, 3, 5, 8, 13, 1001})
+    {
+        const auto a = random_complex(n, static_cast<unsigned>(n));
+        const auto b = random_complex(n, static_cast<unsigned>(n) + 100);
+
+        std::vector<std::complex<float>> product(n);
+        complex_multiply(a, b, product);
+        std::vector<std::complex<float>> acc(n, {0.5f, -0.5f});
+        complex_multiply_accumulate(a, b, acc);
+        std::vector<std::complex<float>> conjugate(n);
+        complex_conj(a, conjugate);
+        std::vector<float> magnitude(n);
+        complex_abs(a, magnitude);
+
+        std::complex<double> dot;
+        std::complex<double> dot_conj;
+        for (size_t i = 0; i < n; ++i)
+        {
+            expect_near(product[i], widen(a[i]) * widen(b[i]), 1e-5);
+            expect_near(acc[i], widen(a[i]) * widen(b[i]) + std::complex<double>(0.5, -0.5), 1e-5);
+            EXPECT_EQ(conjugate[i], std::conj(a[i]));
+            EXPECT_NEAR(magnitude[i], std::abs(widen(a[i])), 1e-5);
+            dot += widen(a[i]) * widen(b[i]);
+            dot_conj += std::conj(widen(a[i])) * widen(b[i]);
+        }
+        expect_near(complex_dot(a, b), dot, 1e-3);
+        expect_near(complex_dot_conj(a, b), dot_conj, 1e-3);
+    }
+}
+
+TEST(SimdComplexTest, SplitKernelsMatchInterleaved)
+{
+    for (const size_t n : {0, 1, 7, 8, 9, 100})
+    {
+        const auto a = random_complex(n, static_cast<unsigned>(n) + 7);
+        const auto b = random_complex(n, static_cast<unsigned>(n) + 8);
+        std::vector<float> are(n), aim(n), bre(n), bim(n);
+        deinterleave(a, {are, aim});
+        deinterleave(b, {bre, bim});
+        for (size_t i = 0; i < n; ++i)
+        {
+            EXPECT_EQ(are[i], a[i].real());
+            EXPECT_EQ(aim[i], a[i].imag());
+        }
+
+        std::vector<float> pre(n), pim(n);
+        complex_multiply({are, aim}, {bre, bim}, {pre, pim});
+        std::vector<float> cre(n, 1.0f), cim(n, 2.0f);
+        complex_multiply_accumulate({are, aim}, {bre, bim}, {cre, cim});
+        std::vector<float> magnitude(n);
+        complex_abs({are, aim}, magnitude);
+        std::vector<std::complex<float>> product(n);
+        interleave({pre, pim}, product);
+
+        std::complex<double> dot;
+        std::complex<double> dot_conj;
+        for (size_t i = 0; i < n; ++i)
+        {
+            const std::complex<double> expected = widen(a[i]) * widen(b[i]);
+            expect_near(product[i], expected, 1e-5);
+            expect_near({cre[i], cim[i]}, expected + std::complex<double>(1, 2), 1e-5);
+            EXPECT_NEAR(magnitude[i], std::abs(widen(a[i])), 1e-5);
+            dot += expected;
+            dot_conj += std::conj(widen(a[i])) * widen(b[i]);
+        }
+        expect_near(complex_dot({are, aim}, {bre, bim}), dot, 1e-3);
+        expect_near(complex_dot_conj({are, aim}, {bre, bim}), dot_conj, 1e-3);
+    }
+}
+
+TEST(SimdComplexTest, SizeMismatchThrows)
+{
+    std::vector<std::complex<float>> a(4), b(5);
+    std::vector<float> re(4), im(3);
+    EXPECT_THROW(complex_multiply(a, b, a), std::invalid_argument);
+    EXPECT_THROW((void)complex_dot(a, b), std::invalid_argument);
+    EXPECT_THROW(deinterleave(a, {re, im}), std::invalid_argument);
+}
+
+} // namespace simdlib
@@ -0,0 +1,127 @@
+#include <gtest/gtest.h>
+#include "../include/simdlib/simd_convolve.hpp"
+#include <cmath>
+#include <random>
+#include <vector>
+
+namespace simdlib
+{
+
+static std::vector<float> random_signal(size_t n, unsigned seed)
+{
+    std::mt19937 rng(seed);
+    std::uniform_real_distribution<float> dist(-1.0f, 1.0f);
+    std::vector<float> values(n);
+    for (auto &v : values)
+        v = dist(rng);
+    return values;
+}
+
+static std::vector<float> reference_convolve(const std::vector<float> &signal,
+                                             const std::vector<float> &taps)
+{
+    if (signal.size() < taps.size())
+        return {};
+    std::vector<float> out(signal.size() - taps.size() + 1);
+    for (size_t i = 0; i < out.size(); ++i)
+    {
+        double sum = 0.0;
+        for (size_t k = 0; k < taps.size(); ++k)
+            sum += static_cast<double>(taps[k]) * signal[i + taps.size() - 1 - k];
+        out[i] = static_cast<float>(sum);
+    }
+    return out;
+}
+
+TEST(SimdConvolveTest, SmallExample)
+{
+    const std::vector<float> signal = {1.0f, 2.0f, 3.0f, 4.0f, 5.0f};
+    const std::vector<float> taps = {1.0f, 0.0f, -1.0f};
+    std::vector<float> out(3);
+    convolve1d(signal, taps, out);
+
+    // numpy.convolve(signal, taps, 'valid')
+    EXPECT_EQ(out, (std::vector<float>{2.0f, 2.0f, 2.0f}));
+}
+
+TEST(SimdConvolveTest, MatchesReferenceForAllTapCounts)
+{
+    const std::vector<float> signal = random_signal(1000, 1);
+    for (size_t k = 1; k <= 40; ++k)
+    {
+        const std::vector<float> taps = random_signal(k, static_cast<unsigned>(k + 100));
+        const std::vector<float> expected = reference_convolve(signal, taps);
+        std::vector<float> out(expected.size());
+        convolve1d(signal, taps, out);
+        for (size_t i = 0; i < out.size(); ++i)
+        {
+            ASSERT_NEAR(out[i], expected[i], 1e-4f) << "taps = " << k << ", i = " << i;
+        }
+    }
+}
+
+TEST(SimdConvolveTest, CompileTimeTaps)
+{
+    const std::vector<float> signal = random_signal(517, 2);
+    const std::array<float, 5> taps = {0.1f, 0.2f, 0.4f, 0.2f, 0.1f};
+    const std::vector<float> expected =
+        reference_convolve(signal, std::vector<float>(taps.begin(), taps.end()));
+    std::vector<float> out(expected.size());
+    convolve1d(signal, taps, out);
+    for (size_t i = 0; i < out.size(); ++i)
+    {
+        ASSERT_NEAR(out[i], expected[i], 1e-5f) << "i = " << i;
+    }
+
+    const std::array<float, 21> wide = {};
+    std::vector<float> wide_out(signal.size() - wide.size() + 1, 1.0f);
+    convolve1d(signal, wide, wide_out);
+    for (const float v : wide_out)
+    {
+        EXPECT_EQ(v, 0.0f);
+    }
+}
+
+TEST(SimdConvolveTest, ShortSignalAndBadSizes)
+{
+    const std::vector<float> signal(3, 1.0f);
+    const std::vector<float> taps(5, 1.0f);
+    std::vector<float> none;
+    convolve1d(signal, taps, none);
+
+    std::vector<float> wrong(2);
+    EXPECT_THROW(convolve1d(signal, taps, wrong), std::invalid_argument);
+    EXPECT_THROW(convolve1d(signal, std::vector<float>{}, none), std::invalid_argument);
+}
+
+TEST(SimdConvolveTest, StreamingMatchesOneShot)
+{
+    const std::vector<float> signal = random_signal(3001, 3);
+    for (size_t k : {1, 4, 9, 25})
+    {
+        const std::vector<float> taps = random_signal(k, 7);
+        std::vector<float> padded(k - 1, 0.0f);
+        padded.insert(padded.end(), signal.begin(), signal.end());
+        const std::vector<float> expected = reference_convolve(padded, taps);
+
+        fir_filter filter(taps);
+        std::vector<float> out(signal.size());
+        size_t pos = 0;
+        for (size_t chunk : {1, 2, 7, 100, 3, 1000, 5})
+        {
+            chunk = std::min(chunk, signal.size() - pos);
+            filter.process(std::span<const float>(signal).subspan(pos, chunk),
+                           std::span<float>(out).subspan(pos, chunk));
+            pos += chunk;
+        }
+        filter.process(std::span<const float>(signal).subspan(pos),
+                       std::span<float>(out).subspan(pos));
+
+        for (size_t i = 0; i < out.size(); ++i)
+        {
+            ASSERT_NEAR(out[i], expected[i], 1e-4f) << "taps = " << k << ", i = " << i;
+        }
+    }
+}
+
+} // namespace simdlib
@@ -0,0 +1,181 @@
+#include <gtest/gtest.h>
+#include "../include/simdlib/simd_fft.hpp"
+#include <cmath>
+#include <complex>
+#include <numbers>
+#include <random>
+#include <vector>
+
+namespace simdlib
+{
+
+namespace
+{
+
+std::vector<std::complex<float>> random_signal(size_t n, unsigned seed)
+{
+    std::mt19937 rng(seed);
+    std::uniform_real_distribution<float> dist(-1.0f, 1.0f);
+    std::vector<std::complex<float>> z(n);
+    for (auto &v : z)
+        v = {dist(rng), dist(rng)};
+    return z;
+}
+
+std::vector<std::complex<double>> reference_dft(const std::vector<std::complex<float>> &x)
+{
+    const size_t n = x.size();
+    std::vector<std::complex<double>> out(n);
+    for (size_t k = 0; k < n; ++k)
+    {
+        for (size_t j = 0; j < n; ++j)
+        {
+            const double angle = -2.0 * std::numbers::pi * static_cast<double>((j * k) % n) /
+                                 static_cast<double>(n);
+            out[k] += std::complex<double>(x[j].real(), x[j].imag()) * std::polar(1.0, angle);
+        }
+    }
+    return out;
+}
+
+// single-precision FFT error grows with log n and the magnitude of the inputs
+double tolerance(size_t n)
+{
+    return 2e-6 * std::sqrt(static_cast<double>(n)) * std::log2(static_cast<double>(n) + 1.0);
+}
+
+} // namespace
+
+TEST(SimdFftTest, ComplexMatchesReferenceDft)
+{
+    for (const size_t n : {1, 2, 4, 8, 16, 32, 64, 128, 256, 512, 2048})
+    {
+        const auto x = random_signal(n, static_cast<unsigned>(n));
+        const auto expected = reference_dft(x);
+        std::vector<std::complex<float>> out(n);
+        fft_plan(n).forward(x, out);
+        for (size_t k = 0; k < n; ++k)
+        {
+            EXPECT_NEAR(out[k].real(), expected[k].real(), tolerance(n)) << n << " " << k;
+            EXPECT_NEAR(out[k].imag(), expected[k].imag(), tolerance(n)) << n << " " << k;
+        }
+    }
+}
+
+TEST(SimdFftTest, InverseRoundTripsAndSplitMatches)
+{
+    for (const size_t n : {1, 2, 16, 32, 128, 1024, 1 << 15})
+    {
+        const fft_plan &plan = fft_plan::cached(n);
+        EXPECT_EQ(&plan, &fft_plan::cached(n));
+        const auto x = random_signal(n, static_cast<unsigned>(n) + 1);
+        std::vector<std::complex<float>> spectrum(n);
+        std::vector<std::complex<float>> back(n);
+        fft(x, spectrum);
+        ifft(spectrum, back);
+        for (size_t i = 0; i < n; ++i)
+        {
+            EXPECT_NEAR(back[i].real(), x[i].real(), 1e-5);
+            EXPECT_NEAR(back[i].imag(), x[i].imag(), 1e-5);
+        }
+
+        std::vector<float> re(n), im(n), sre(n), sim(n);
+        deinterleave(x, {re, im});
+        plan.forward({re, im}, {sre, sim});
+        for (size_t k = 0; k < n; ++k)
+        {
+            EXPECT_EQ(sre[k], spectrum[k].real());
+            EXPECT_EQ(sim[k], spectrum[k].imag());
+        }
+        plan.inverse({sre, sim}, {sre, sim});
+        for (size_t i = 0; i < n; ++i)
+            EXPECT_NEAR(sre[i], x[i].real(), 1e-5);
+    }
+}
+
+TEST(SimdFftTest, RealMatchesComplex)
+{
+    for (const size_t n : {2, 4, 8, 32, 64, 256, 4096})
+    {
+        std::mt19937 rng(static_cast<unsigned>(n));
+        std::uniform_real_distribution<float> dist(-1.0f, 1.0f);
+        std::vector<float> x(n);
+        for (auto &v : x)
+            v = dist(rng);
+        std::vector<std::complex<float>> as_complex(x.begin(), x.end());
+        std::vector<std::complex<float>> expected(n);
+        fft(as_complex, expected);
+
+        std::vector<std::complex<float>> spectrum(n / 2 + 1);
+        rfft(x, spectrum);
+        for (size_t k = 0; k <= n / 2; ++k)
+        {
+            EXPECT_NEAR(spectrum[k].real(), expected[k].real(), tolerance(n)) << n << " " << k;
+            EXPECT_NEAR(spectrum[k].imag(), expected[k].imag(), tolerance(n)) << n << " " << k;
+        }
+
+        std::vector<float> back(n);
+        irfft(spectrum, back);
+        for (size_t i = 0; i < n; ++i)
+            EXPECT_NEAR(back[i], x[i], 1e-5) << n << " " << i;
+
+        // imaginary parts in the DC and Nyquist bins, as a complex filter leaves them, are
+        // dropped rather than mixed into the signal
+        spectrum[0].imag(5.0f);
+        spectrum[n / 2].imag(-3.0f);
+        std::vector<float> filtered(n);
+        irfft(spectrum, filtered);
+        for (size_t i = 0; i < n; ++i)
+            EXPECT_NEAR(filtered[i], back[i], 1e-6) << n << " " << i;
+    }
+}
+
+TEST(SimdFftTest, BatchesMatchSingleTransforms)
+{
+    constexpr size_t n = 64;
+    constexpr size_t count = 37;
+    const auto x = random_signal(n * count, 3);
+    const fft_plan plan(n);
+    std::vector<std::complex<float>> batched(x.size());
+    plan.forward_batch(x, batched, 4);
+    std::vector<std::complex<float>> single(n);
+    for (size_t b = 0; b < count; ++b)
+    {
+        plan.forward(std::span(x).subspan(b * n, n), single);
+        for (size_t k = 0; k < n; ++k)
+            EXPECT_EQ(batched[b * n + k], single[k]);
+    }
+    std::vector<std::complex<float>> back(x.size());
+    plan.inverse_batch(batched, back, 0);
+    for (size_t i = 0; i < x.size(); ++i)
+        EXPECT_NEAR(back[i].real(), x[i].real(), 1e-5);
+
+    const real_fft_plan rplan(n);
+    std::vector<float> reals(n * count);
+    for (size_t i = 0; i < reals.size(); ++i)
+        reals[i] = x[i].real();
+    std::vector<std::complex<float>> rbatched(count * (n / 2 + 1));
+    rplan.forward_batch(reals, rbatched, 3);
+    std::vector<std::complex<float>> rsingle(n / 2 + 1);
+    rplan.forward(std::span(reals).subspan(5 * n, n), rsingle);
+    for (size_t k = 0; k <= n / 2; ++k)
+        EXPECT_EQ(rbatched[5 * (n / 2 + 1) + k], rsingle[k]);
+    std::vector<float> rback(reals.size());
+    rplan.inverse_batch(rbatched, rback);
+    for (size_t i = 0; i < reals.size(); ++i)
+        EXPECT_NEAR(rback[i], reals[i], 1e-5);
+}
+
+TEST(SimdFftTest, InvalidSizesThrow)
+{
+    EXPECT_THROW(fft_plan(0), std::invalid_argument);
+    EXPECT_THROW(fft_plan(48), std::invalid_argument);
+    EXPECT_THROW(real_fft_plan(1), std::invalid_argument);
+    const fft_plan plan(16);
+    std::vector<std::complex<float>> in(16), out(8);
+    EXPECT_THROW(plan.forward(in, out), std::invalid_argument);
+    std::vector<std::complex<float>> batch(40);
+    EXPECT_THROW(plan.forward_batch(batch, batch), std::invalid_argument);
+}
+
+} // namespace simdlib
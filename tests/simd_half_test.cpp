@@ -0,0 +1,157 @@
+#include <gtest/gtest.h>
+#include "../include/simdlib/simd_half.hpp"
+#include <bit>
+#include <cmath>
+#include <random>
+#include <vector>
+
+namespace simdlib
+{
+
+TEST(SimdHalfTest, ScalarConversionMatchesF16C)
+{
+    for (uint32_t bits = 0; bits <= 0xFFFF; ++bits)
+    {
+        const auto h = static_cast<uint16_t>(bits);
+        const float expected = _cvtsh_ss(h);
+        const float actual = f16_to_float(h);
+        if (std::isnan(expected))
+        {
+            EXPECT_TRUE(std::isnan(actual));
+        }
+        else
+        {
+            ASSERT_EQ(std::bit_cast<uint32_t>(actual), std::bit_cast<uint32_t>(expected))
+                << "bits = " << bits;
+        }
+    }
+
+    std::mt19937 rng(5);
+    for (int i = 0; i < 1000000; ++i)
+    {
+        const float value = std::bit_cast<float>(static_cast<uint32_t>(rng()));
+        if (std::isnan(value))
+            continue;
+        ASSERT_EQ(float_to_f16(value), _cvtss_sh(value, _MM_FROUND_TO_NEAREST_INT))
+            << "value = " << value;
+    }
+}
+
+TEST(SimdHalfTest, LoadStoreHalf)
+{
+    const uint16_t halves[8] = {0x3C00, 0xC000, 0x3800, 0x0000, 0x7C00, 0x0001, 0x7BFF, 0x4248};
+    const auto vec = load_half<8>(halves);
+    EXPECT_EQ(vec[0], 1.0f);
+    EXPECT_EQ(vec[1], -2.0f);
+    EXPECT_EQ(vec[2], 0.5f);
+    EXPECT_EQ(vec[3], 0.0f);
+    EXPECT_TRUE(std::isinf(vec[4]));
+    EXPECT_EQ(vec[5], 0x1p-24f);
+    EXPECT_EQ(vec[6], 65504.0f);
+    EXPECT_EQ(vec[7], 3.140625f);
+
+    uint16_t out[8] = {};
+    store_half(out, vec);
+    for (size_t i = 0; i < 8; ++i)
+    {
+        EXPECT_EQ(out[i], halves[i]);
+    }
+
+    const auto vec4 = load_half<4>(halves);
+    uint16_t out4[4] = {};
+    store_half(out4, vec4);
+    for (size_t i = 0; i < 4; ++i)
+    {
+        EXPECT_EQ(vec4[i], vec[i]);
+        EXPECT_EQ(out4[i], halves[i]);
+    }
+}
+
+TEST(SimdHalfTest, LoadStoreBf16)
+{
+    simd_vector<float, 8> vec(1.0f, -2.5f, 1.00390625f, 1.01171875f, INFINITY, NAN, 3.0e38f,
+                              -0.0f);
+    uint16_t out[8] = {};
+    store_bf16(out, vec);
+    for (size_t i = 0; i < 8; ++i)
+    {
+        EXPECT_EQ(out[i], float_to_bf16(vec[i])) << "i = " << i;
+    }
+    EXPECT_EQ(out[2], 0x3F80); // tie rounds to even
+    EXPECT_EQ(out[3], 0x3F82); // tie rounds to even
+    EXPECT_TRUE(std::isnan(bf16_to_float(out[5])));
+
+    const auto back = load_bf16<8>(out);
+    const auto back4 = load_bf16<4>(out + 4);
+    EXPECT_EQ(back[0], 1.0f);
+    EXPECT_EQ(back[1], -2.5f);
+    EXPECT_TRUE(std::isinf(back[4]));
+    EXPECT_TRUE(std::isinf(back4[0]));
+    EXPECT_TRUE(std::isnan(back4[1]));
+}
+
+TEST(SimdHalfTest, BulkConversionRoundTrip)
+{
+    std::mt19937 rng(9);
+    std::uniform_real_distribution<float> dist(-1000.0f, 1000.0f);
+    std::vector<float> values(1037);
+    for (auto &v : values)
+        v = dist(rng);
+
+    std::vector<uint16_t> halves(values.size());
+    std::vector<uint16_t> bf16s(values.size());
+    std::vector<float> from_half(values.size());
+    std::vector<float> from_bf16(values.size());
+    float_to_f16(values, halves);
+    float_to_bf16(values, bf16s);
+    f16_to_float(halves, from_half);
+    bf16_to_float(bf16s, from_bf16);
+
+    for (size_t i = 0; i < values.size(); ++i)
+    {
+        EXPECT_EQ(halves[i], float_to_f16(values[i]));
+        EXPECT_EQ(bf16s[i], float_to_bf16(values[i]));
+        EXPECT_EQ(from_half[i], f16_to_float(halves[i]));
+        EXPECT_EQ(from_bf16[i], bf16_to_float(bf16s[i]));
+    }
+}
+
+TEST(SimdHalfTest, MixedPrecisionDotAndL2)
+{
+    std::mt19937 rng(13);
+    std::uniform_real_distribution<float> dist(-1.0f, 1.0f);
+    const size_t n = 301;
+    std::vector<float> a(n);
+    std::vector<float> b(n);
+    for (size_t i = 0; i < n; ++i)
+    {
+        a[i] = dist(rng);
+        b[i] = dist(rng);
+    }
+    std::vector<uint16_t> a_half(n);
+    std::vector<uint16_t> a_bf16(n);
+    float_to_f16(a, a_half);
+    float_to_bf16(a, a_bf16);
+
+    double dot_half_ref = 0.0;
+    double dot_bf16_ref = 0.0;
+    double l2_half_ref = 0.0;
+    double l2_bf16_ref = 0.0;
+    for (size_t i = 0; i < n; ++i)
+    {
+        const double ah = f16_to_float(a_half[i]);
+        const double ab = bf16_to_float(a_bf16[i]);
+        dot_half_ref += ah * b[i];
+        dot_bf16_ref += ab * b[i];
+        l2_half_ref += (ah - b[i]) * (ah - b[i]);
+        l2_bf16_ref += (ab - b[i]) * (ab - b[i]);
+    }
+
+    EXPECT_NEAR(dot_f16(a_half, b), dot_half_ref, 1e-4);
+    EXPECT_NEAR(dot_bf16(a_bf16, b), dot_bf16_ref, 1e-4);
+    EXPECT_NEAR(l2_squared_f16(a_half, b), l2_half_ref, 1e-4);
+    EXPECT_NEAR(l2_squared_bf16(a_bf16, b), l2_bf16_ref, 1e-4);
+    EXPECT_THROW(dot_f16(std::span<const uint16_t>(a_half).first(3), b), std::invalid_argument);
+}
+
+} // namespace simdlib
@@ -0,0 +1,132 @@
+#include <gtest/gtest.h>
+#include "../include/simdlib/simd_hash.hpp"
+#include <random>
+#include <string_view>
+#include <vector>
+
+namespace simdlib
+{
+
+namespace
+{
+
+// bit-at-a-time CRC-32C straight from the definition
+uint32_t reference_crc32c(std::span<const std::byte> data)
+{
+    uint32_t crc = ~uint32_t{0};
+    for (const std::byte b : data)
+    {
+        crc ^= static_cast<uint32_t>(b);
+        for (int k = 0; k < 8; ++k)
+            crc = (crc >> 1) ^ ((crc & 1) ? 0x82F63B78u : 0);
+    }
+    return ~crc;
+}
+
+std::vector<std::byte> random_bytes(size_t n, unsigned seed)
+{
+    std::mt19937 rng(seed);
+    std::vector<std::byte> bytes(n);
+    for (auto &b : bytes)
+        b = static_cast<std::byte>(rng());
+    return bytes;
+}
+
+} // namespace
+
+TEST(SimdHashTest, LanesMatchScalarHashes)
+{
+    std::mt19937_64 rng(1);
+    for (const size_t n : {0, 1, 7, 8, 9, 100, 70001})
+    {
+        std::vector<uint32_t> keys32(n);
+        std::vector<uint64_t> keys64(n);
+        for (size_t i = 0; i < n; ++i)
+        {
+            keys64[i] = rng();
+            keys32[i] = static_cast<uint32_t>(keys64[i]);
+        }
+        std::vector<uint32_t> out(n);
+        hash_keys(keys32, out, 17u, 3);
+        for (size_t i = 0; i < n; ++i)
+            EXPECT_EQ(out[i], hash32(keys32[i], 17u)) << i;
+        hash_keys(keys64, out, uint64_t{1} << 40);
+        for (size_t i = 0; i < n; ++i)
+            EXPECT_EQ(out[i], hash64(keys64[i], uint64_t{1} << 40)) << i;
+
+        partition_keys(keys32, 1000, out, 5u, 0);
+        for (size_t i = 0; i < n; ++i)
+            EXPECT_EQ(out[i], partition_of(hash32(keys32[i], 5u), 1000)) << i;
+        partition_keys(keys64, 7, out, uint64_t{5});
+        for (size_t i = 0; i < n; ++i)
+            EXPECT_EQ(out[i], partition_of(hash64(keys64[i], 5), 7)) << i;
+    }
+}
+
+TEST(SimdHashTest, KnownValuesAndSpread)
+{
+    // murmur3 finalizer outputs
+    EXPECT_EQ(hash32(0), 0u);
+    EXPECT_EQ(hash32(1), 0x514E28B7u);
+    EXPECT_EQ(hash64(1), static_cast<uint32_t>(0xB456BCFC34C2CB2Cull));
+
+    // sequential keys land evenly across partitions
+    constexpr uint32_t partitions = 16;
+    std::vector<uint32_t> keys(1 << 16);
+    for (size_t i = 0; i < keys.size(); ++i)
+        keys[i] = static_cast<uint32_t>(i);
+    std::vector<uint32_t> buckets(keys.size());
+    partition_keys(keys, partitions, buckets);
+    std::vector<size_t> counts(partitions);
+    for (const uint32_t b : buckets)
+    {
+        ASSERT_LT(b, partitions);
+        ++counts[b];
+    }
+    for (const size_t c : counts)
+        EXPECT_NEAR(static_cast<double>(c), keys.size() / partitions, 0.05 * keys.size() / 16);
+}
+
+TEST(SimdHashTest, Crc32cMatchesReference)
+{
+    const std::string_view check = "123456789";
+    EXPECT_EQ(crc32c(std::as_bytes(std::span(check))), 0xE3069283u);
+    const std::vector<std::byte> zeros(32);
+    EXPECT_EQ(crc32c(zeros), 0x8A9136AAu);
+    EXPECT_EQ(crc32c({}), 0u);
+
+    // sizes around the three-stream block boundaries, from an unaligned start
+    constexpr size_t wide = 3 * 8192;
+    const auto bytes = random_bytes(2 * wide + 3 * 256 + 100, 2);
+    const size_t sizes[] = {1, 7, 767, 768, 769, wide - 1, wide, 2 * wide + 3 * 256 + 99};
+    for (const size_t n : sizes)
+    {
+        const auto data = std::span(bytes).subspan(1, n);
+        EXPECT_EQ(crc32c(data), reference_crc32c(data)) << n;
+        // continuing a checksum equals checksumming the whole
+        const size_t cut = n / 3;
+        EXPECT_EQ(crc32c(data.subspan(cut), crc32c(data.first(cut))), crc32c(data)) << n;
+    }
+}
+
+TEST(SimdHashTest, Crc32cBlocks)
+{
+    const auto bytes = random_bytes(1000003, 3);
+    constexpr size_t block = 4096;
+    std::vector<uint32_t> out((bytes.size() + block - 1) / block);
+    crc32c_blocks(bytes, block, out, 4);
+    for (size_t b = 0; b < out.size(); ++b)
+    {
+        const size_t n = std::min(block, bytes.size() - b * block);
+        EXPECT_EQ(out[b], crc32c(std::span(bytes).subspan(b * block, n))) << b;
+    }
+
+    std::vector<uint32_t> wrong(out.size() + 1);
+    EXPECT_THROW(crc32c_blocks(bytes, block, wrong), std::invalid_argument);
+    EXPECT_THROW(crc32c_blocks(bytes, 0, out), std::invalid_argument);
+    std::vector<uint32_t> keys(9), short_out(8);
+    EXPECT_THROW(hash_keys(keys, short_out), std::invalid_argument);
+    EXPECT_THROW(partition_keys(keys, 0, keys), std::invalid_argument);
+}
+
+} // namespace simdlib
@@ -0,0 +1,90 @@
+#include <gtest/gtest.h>
+#include "../include/simdlib/simd_histogram.hpp"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <random>
+#include <vector>
+
+namespace simdlib
+{
+
+static std::vector<float> random_values(size_t n, float lo, float hi, unsigned seed)
+{
+    std::mt19937 rng(seed);
+    std::uniform_real_distribution<float> dist(lo, hi);
+    std::vector<float> values(n);
+    for (auto &v : values)
+        v = dist(rng);
+    return values;
+}
+
+TEST(SimdHistogramTest, BucketizeFewEdges)
+{
+    const std::vector<float> edges = {-1.0f, 0.0f, 2.5f, 10.0f};
+    const std::vector<float> values = {-5.0f, -1.0f, -0.5f, 0.0f, 1.0f, 2.5f,
+                                       3.0f,  9.99f, 10.0f, 11.0f, NAN};
+    std::vector<uint32_t> out(values.size());
+    bucketize(values, edges, out);
+
+    const std::vector<uint32_t> expected = {0, 1, 1, 2, 2, 3, 3, 3, 4, 4, 0};
+    EXPECT_EQ(out, expected);
+}
+
+TEST(SimdHistogramTest, BucketizeManyEdges)
+{
+    std::vector<float> edges = random_values(1000, -100.0f, 100.0f, 1);
+    std::sort(edges.begin(), edges.end());
+    const std::vector<float> values = random_values(100003, -120.0f, 120.0f, 2);
+
+    std::vector<uint32_t> out(values.size());
+    bucketize(values, edges, out, 4);
+
+    for (size_t i = 0; i < values.size(); ++i)
+    {
+        const auto expected = std::upper_bound(edges.begin(), edges.end(), values[i]);
+        ASSERT_EQ(out[i], static_cast<uint32_t>(expected - edges.begin())) << "i = " << i;
+    }
+}
+
+TEST(SimdHistogramTest, Histogram)
+{
+    std::vector<float> values = random_values(250007, -1.0f, 11.0f, 3);
+    values[5] = 10.0f;
+    values[6] = NAN;
+    const size_t bins = 37;
+    const float lo = 0.0f;
+    const float hi = 10.0f;
+
+    std::vector<uint64_t> expected(bins);
+    const float scale = static_cast<float>(bins) / (hi - lo);
+    for (const float v : values)
+    {
+        if (v >= lo && v <= hi)
+            ++expected[std::min(static_cast<size_t>((v - lo) * scale), bins - 1)];
+    }
+
+    EXPECT_EQ(histogram(values, bins, lo, hi), expected);
+    EXPECT_EQ(histogram(values, bins, lo, hi, 3), expected);
+}
+
+TEST(SimdHistogramTest, HistogramRangeNarrowerThanItsBins)
+{
+    // bins / (hi - lo) overflows to inf, so v == lo has position 0 * inf = NaN; the vector body
+    // and the scalar tail both count it in the last bin
+    const float hi = std::numeric_limits<float>::denorm_min();
+    std::vector<float> values(11, 0.0f);
+    values[3] = hi;
+    values[9] = hi;
+    const std::vector<uint64_t> hist = histogram(values, 16, 0.0f, hi);
+    EXPECT_EQ(hist[15], values.size());
+}
+
+TEST(SimdHistogramTest, HistogramRejectsBadRange)
+{
+    const std::vector<float> values(8, 1.0f);
+    EXPECT_THROW(histogram(values, 0, 0.0f, 1.0f), std::invalid_argument);
+    EXPECT_THROW(histogram(values, 4, 1.0f, 1.0f), std::invalid_argument);
+}
+
+} // namespace simdlib
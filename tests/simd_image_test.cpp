@@ -0,0 +1,122 @@
+#include <gtest/gtest.h>
+#include "../include/simdlib/simd_image.hpp"
+#include <cmath>
+#include <limits>
+#include <random>
+#include <vector>
+
+namespace simdlib
+{
+
+namespace
+{
+
+std::vector<uint8_t> random_pixels(size_t pixels, unsigned seed)
+{
+    std::mt19937 rng(seed);
+    std::vector<uint8_t> rgba(4 * pixels);
+    for (auto &b : rgba)
+        b = static_cast<uint8_t>(rng());
+    return rgba;
+}
+
+// the usual ImageNet statistics
+pixel_normalization imagenet()
+{
+    pixel_normalization norm;
+    norm.mean = {0.485f, 0.456f, 0.406f, 0.5f};
+    norm.stddev = {0.229f, 0.224f, 0.225f, 0.5f};
+    return norm;
+}
+
+} // namespace
+
+TEST(SimdImageTest, ToPlanarMatchesScalar)
+{
+    const pixel_normalization norm = imagenet();
+    for (const size_t pixels : {0, 1, 7, 8, 9, 100, 40003})
+    {
+        const auto rgba = random_pixels(pixels, static_cast<unsigned>(pixels));
+        for (const size_t planes : {3, 4})
+        {
+            std::vector<float> planar(planes * pixels);
+            rgba8_to_planar(rgba, planar, norm, 3);
+            for (size_t i = 0; i < pixels; ++i)
+            {
+                for (size_t c = 0; c < planes; ++c)
+                {
+                    const float expected =
+                        (rgba[4 * i + c] * norm.scale - norm.mean[c]) / norm.stddev[c];
+                    EXPECT_NEAR(planar[c * pixels + i], expected, 1e-5f) << i << " " << c;
+                }
+            }
+        }
+    }
+}
+
+TEST(SimdImageTest, RoundTripsBytes)
+{
+    for (const auto &norm : {pixel_normalization{}, imagenet()})
+    {
+        for (const size_t pixels : {5, 64, 1001})
+        {
+            const auto rgba = random_pixels(pixels, static_cast<unsigned>(pixels) + 1);
+            std::vector<float> planar(4 * pixels);
+            rgba8_to_planar(rgba, planar, norm);
+            std::vector<uint8_t> back(rgba.size());
+            planar_to_rgba8(planar, back, norm, 0);
+            EXPECT_EQ(back, rgba);
+
+            // without an alpha plane the pixels come back opaque
+            std::vector<float> rgb(3 * pixels);
+            rgba8_to_planar(rgba, rgb, norm);
+            planar_to_rgba8(rgb, back, norm);
+            for (size_t i = 0; i < pixels; ++i)
+            {
+                EXPECT_EQ(back[4 * i], rgba[4 * i]);
+                EXPECT_EQ(back[4 * i + 2], rgba[4 * i + 2]);
+                EXPECT_EQ(back[4 * i + 3], 255);
+            }
+        }
+    }
+}
+
+TEST(SimdImageTest, SaturatesAndRounds)
+{
+    // eleven pixels, so the last three go through the tail
+    const float nan = std::numeric_limits<float>::quiet_NaN();
+    const std::vector<float> values = {-1.0f, 2.0f, 0.502f, nan, 1e20f, -1e20f, 0.1f / 255.0f,
+                                       0.6f / 255.0f, 1.0f, 0.0f, 254.4f / 255.0f};
+    const size_t pixels = values.size();
+    std::vector<float> planar(4 * pixels);
+    for (size_t c = 0; c < 4; ++c)
+        std::copy(values.begin(), values.end(), planar.begin() + static_cast<long>(c * pixels));
+    std::vector<uint8_t> rgba(4 * pixels);
+    planar_to_rgba8(planar, rgba);
+    const std::vector<uint8_t> expected = {0, 255, 128, 0, 255, 0, 0, 1, 255, 0, 254};
+    for (size_t i = 0; i < pixels; ++i)
+    {
+        for (size_t c = 0; c < 4; ++c)
+            EXPECT_EQ(rgba[4 * i + c], expected[i]) << i << " " << c;
+    }
+}
+
+TEST(SimdImageTest, InvalidArgumentsThrow)
+{
+    std::vector<uint8_t> rgba(16);
+    std::vector<float> planar(10);
+    EXPECT_THROW(rgba8_to_planar(rgba, planar), std::invalid_argument);
+    EXPECT_THROW(planar_to_rgba8(planar, rgba), std::invalid_argument);
+    std::vector<uint8_t> ragged(15);
+    std::vector<float> fits(12);
+    EXPECT_THROW(rgba8_to_planar(ragged, fits), std::invalid_argument);
+
+    pixel_normalization norm;
+    norm.stddev[1] = 0.0f;
+    EXPECT_THROW(rgba8_to_planar(rgba, fits, norm), std::invalid_argument);
+    norm = {};
+    norm.scale = 0.0f;
+    EXPECT_THROW(planar_to_rgba8(fits, rgba, norm), std::invalid_argument);
+}
+
+} // namespace simdlib
@@ -0,0 +1,183 @@
+#include <gtest/gtest.h>
+#include "../include/simdlib/simd_interp.hpp"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <random>
+#include <vector>
+
+namespace simdlib
+{
+
+namespace
+{
+
+std::vector<float> random_floats(size_t n, float lo, float hi, unsigned seed)
+{
+    std::mt19937 rng(seed);
+    std::uniform_real_distribution<float> dist(lo, hi);
+    std::vector<float> values(n);
+    for (auto &v : values)
+        v = dist(rng);
+    return values;
+}
+
+// strictly increasing knots with uneven gaps
+std::vector<float> random_knots(size_t n, unsigned seed)
+{
+    auto gaps = random_floats(n, 0.01f, 1.0f, seed);
+    std::vector<float> knots(n);
+    float x = -3.0f;
+    for (size_t k = 0; k < n; ++k)
+        knots[k] = x += gaps[k];
+    return knots;
+}
+
+// the upper_bound and lerp the kernels replace, in double
+double reference(const std::vector<float> &knots, const std::vector<float> &values, float x)
+{
+    if (x <= knots.front())
+        return values.front();
+    if (x >= knots.back())
+        return values.back();
+    const size_t k =
+        static_cast<size_t>(std::upper_bound(knots.begin(), knots.end(), x) - knots.begin()) - 1;
+    const double f = (double{x} - knots[k]) / (double{knots[k + 1]} - knots[k]);
+    return values[k] + f * (double{values[k + 1]} - values[k]);
+}
+
+void expect_matches(const interp_table &table, const std::vector<float> &knots,
+                    const std::vector<float> &values, const std::vector<float> &xs)
+{
+    std::vector<float> out(xs.size());
+    interp1d(xs, table, out);
+    for (size_t i = 0; i < xs.size(); ++i)
+    {
+        const double expected = reference(knots, values, xs[i]);
+        EXPECT_NEAR(out[i], expected, 1e-4 * (1.0 + std::abs(expected)))
+            << "x = " << xs[i] << ", " << values.size() << " values";
+        EXPECT_NEAR(table(xs[i]), expected, 1e-4 * (1.0 + std::abs(expected)));
+    }
+}
+
+} // namespace
+
+TEST(SimdInterpTest, KnotTablesMatchReference)
+{
+    // one and two register tables, counted gathers up to 64 knots, searched gathers past that
+    for (const size_t n : {2, 5, 8, 9, 16, 17, 64, 65, 5000})
+    {
+        const auto knots = random_knots(n, static_cast<unsigned>(n));
+        const auto values = random_floats(n, -10.0f, 10.0f, static_cast<unsigned>(n) + 1);
+        const interp_table table(knots, values);
+        auto xs = random_floats(1001, knots.front() - 1.0f, knots.back() + 1.0f, 7);
+        xs.insert(xs.end(), knots.begin(), knots.end());
+        expect_matches(table, knots, values, xs);
+
+        // exact at the knots
+        std::vector<float> out(knots.size());
+        interp1d(knots, table, out);
+        EXPECT_EQ(out, values);
+    }
+}
+
+TEST(SimdInterpTest, UniformTablesMatchReference)
+{
+    for (const size_t n : {2, 3, 8, 9, 16, 17, 1025})
+    {
+        const auto values = random_floats(n, -1.0f, 1.0f, static_cast<unsigned>(n));
+        const interp_table table(-2.0f, 6.0f, values);
+        ASSERT_TRUE(table.uniform());
+        std::vector<float> knots(n);
+        for (size_t k = 0; k < n; ++k)
+            knots[k] = -2.0f + 8.0f * static_cast<float>(k) / static_cast<float>(n - 1);
+        expect_matches(table, knots, values, random_floats(999, -3.0f, 7.0f, 8));
+    }
+}
+
+TEST(SimdInterpTest, OffsetUniformTablesKeepTheirFraction)
+{
+    // a narrow domain far from 0, where a step is close to the spacing of the floats in it
+    for (const float lo : {12345.678f, -54321.1f, 0.3f})
+    {
+        const float hi = lo + 0.7f;
+        const auto values = random_floats(1001, -1.0f, 1.0f, 14);
+        const interp_table table(lo, hi, values);
+        const auto xs = random_floats(4099, lo, hi, 15);
+        std::vector<float> out(xs.size());
+        interp1d(xs, table, out);
+        const double steps = static_cast<double>(values.size() - 1);
+        for (size_t i = 0; i < xs.size(); ++i)
+        {
+            const double t =
+                std::clamp((double{xs[i]} - lo) / (double{hi} - lo) * steps, 0.0, steps);
+            const size_t k = std::min(static_cast<size_t>(t), values.size() - 2);
+            const double expected = values[k] + (t - k) * (double{values[k + 1]} - values[k]);
+            EXPECT_NEAR(out[i], expected, 1e-3) << "lo = " << lo << ", x = " << xs[i];
+            EXPECT_NEAR(table(xs[i]), expected, 1e-3) << "lo = " << lo << ", x = " << xs[i];
+        }
+    }
+}
+
+TEST(SimdInterpTest, EndsClampAndNaNPropagates)
+{
+    const float inf = std::numeric_limits<float>::infinity();
+    const float nan = std::numeric_limits<float>::quiet_NaN();
+    const std::vector<float> xs = {-inf, -5.0f, nan, 0.0f, 1.0f, 2.0f, inf, 100.0f, nan, -0.0f};
+    for (const size_t n : {4, 12, 40, 200})
+    {
+        const auto values = random_floats(n, 1.0f, 2.0f, 9);
+        const auto knots = random_knots(n, 10);
+        for (const auto &table :
+             {interp_table(knots, values), interp_table(knots.front(), knots.back(), values)})
+        {
+            std::vector<float> out(xs.size());
+            interp1d(xs, table, out);
+            EXPECT_EQ(out[0], values.front());
+            EXPECT_EQ(out[1], values.front());
+            EXPECT_TRUE(std::isnan(out[2]));
+            EXPECT_EQ(out[6], values.back());
+            EXPECT_EQ(out[7], values.back());
+            EXPECT_TRUE(std::isnan(out[8]));
+            EXPECT_TRUE(std::isnan(table(nan)));
+        }
+    }
+}
+
+TEST(SimdInterpTest, ThreadsAndTailsAgree)
+{
+    const auto knots = random_knots(300, 11);
+    const auto values = random_floats(300, 0.0f, 1.0f, 12);
+    const interp_table table(knots, values);
+    const auto xs = random_floats(100003, knots.front(), knots.back(), 13);
+    std::vector<float> serial(xs.size()), threaded(xs.size());
+    interp1d(xs, table, serial);
+    interp1d(xs, table, threaded, 3);
+    EXPECT_EQ(serial, threaded);
+
+    // a lone tail lane gives what it gives inside a full vector
+    std::vector<float> one(1);
+    interp1d(std::span<const float>(xs).subspan(5, 1), table, one);
+    EXPECT_EQ(one[0], serial[5]);
+}
+
+TEST(SimdInterpTest, InvalidArgumentsThrow)
+{
+    const std::vector<float> values = {1.0f, 2.0f, 3.0f};
+    EXPECT_THROW(interp_table(std::vector<float>{0.0f, 1.0f}, values), std::invalid_argument);
+    EXPECT_THROW(interp_table(std::vector<float>{0.0f, 1.0f, 1.0f}, values),
+                 std::invalid_argument);
+    EXPECT_THROW(interp_table(std::vector<float>{0.0f, std::nanf(""), 2.0f}, values),
+                 std::invalid_argument);
+    EXPECT_THROW(interp_table(std::vector<float>{0.0f}, std::vector<float>{1.0f}),
+                 std::invalid_argument);
+    EXPECT_THROW(interp_table(1.0f, 1.0f, values), std::invalid_argument);
+    EXPECT_THROW(interp_table(0.0f, std::numeric_limits<float>::infinity(), values),
+                 std::invalid_argument);
+
+    const interp_table table(0.0f, 1.0f, values);
+    std::vector<float> xs(10), out(9);
+    EXPECT_THROW(interp1d(xs, table, out), std::invalid_argument);
+}
+
+} // namespace simdlib
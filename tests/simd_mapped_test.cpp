@@ -0,0 +1,103 @@
+#include <gtest/gtest.h>
+#include "../include/simdlib/simd_mapped.hpp"
+#include <filesystem>
+#include <fstream>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace simdlib
+{
+
+static std::vector<float> random_values(size_t n, unsigned seed)
+{
+    std::mt19937 rng(seed);
+    std::uniform_real_distribution<float> dist(-100.0f, 100.0f);
+    std::vector<float> values(n);
+    for (auto &v : values)
+        v = dist(rng);
+    return values;
+}
+
+// a float32 file removed again when the test ends
+class temp_column
+{
+  public:
+    temp_column(const std::vector<float> &values, size_t extra_bytes = 0)
+        : path_(std::filesystem::temp_directory_path() /
+                ("simdlib_mapped_" + std::to_string(::getpid()) + "_" +
+                 std::to_string(counter_++) + ".f32"))
+    {
+        std::ofstream out(path_, std::ios::binary);
+        out.write(reinterpret_cast<const char *>(values.data()),
+                  static_cast<std::streamsize>(values.size() * sizeof(float)));
+        out.write("xyz", static_cast<std::streamsize>(extra_bytes));
+    }
+
+    ~temp_column()
+    {
+        std::filesystem::remove(path_);
+    }
+
+    [[nodiscard]] std::string path() const
+    {
+        return path_.string();
+    }
+
+  private:
+    static inline int counter_ = 0;
+    std::filesystem::path path_;
+};
+
+TEST(SimdMappedTest, MapsFileInPlace)
+{
+    const std::vector<float> values = random_values(1003, 7);
+    const temp_column file(values);
+    const mapped_column column(file.path());
+    ASSERT_EQ(column.size(), values.size());
+    EXPECT_EQ(reinterpret_cast<uintptr_t>(column.data()) % AVX_ALIGNMENT, 0u);
+    EXPECT_EQ(column.vector_count(), values.size() / AVX_SIZE);
+    EXPECT_EQ(column.tail().size(), values.size() % AVX_SIZE);
+    for (size_t i = 0; i < column.vector_count(); ++i)
+    {
+        const simd_vector<float, AVX_SIZE> vec = column.vector(i);
+        for (size_t lane = 0; lane < AVX_SIZE; ++lane)
+            ASSERT_EQ(vec[lane], values[i * AVX_SIZE + lane]);
+    }
+}
+
+TEST(SimdMappedTest, StreamingReductionsMatchVector)
+{
+    const std::vector<float> values = random_values(2500007, 8);
+    const temp_column file(values);
+    const mapped_column column(file.path(), false);
+    EXPECT_DOUBLE_EQ(reduce_sum(column), reduce_sum(values));
+    EXPECT_EQ(reduce_min(column, 3), reduce_min(values));
+    EXPECT_EQ(reduce_max(column, 3), reduce_max(values));
+
+    std::vector<float> out(values.size());
+    const auto square = [](simd_vector<float, AVX_SIZE> v) { return v * v; };
+    transform_values(column, out, square, 2);
+    for (size_t i = 0; i < values.size(); i += 997)
+        EXPECT_EQ(out[i], values[i] * values[i]);
+}
+
+TEST(SimdMappedTest, MoveAndErrors)
+{
+    const temp_column empty(std::vector<float>{});
+    const mapped_column none(empty.path());
+    EXPECT_EQ(none.size(), 0u);
+    EXPECT_EQ(reduce_sum(none), 0.0);
+
+    const temp_column file(random_values(16, 9));
+    mapped_column a(file.path());
+    mapped_column b(std::move(a));
+    EXPECT_EQ(a.size(), 0u);
+    EXPECT_EQ(b.size(), 16u);
+
+    const temp_column ragged(random_values(4, 10), 2);
+    EXPECT_THROW(mapped_column(ragged.path()), std::runtime_error);
+    EXPECT_THROW(mapped_column("/nonexistent/simdlib.f32"), std::system_error);
+}
+
+} // namespace simdlib
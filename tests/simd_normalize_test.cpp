@@ -0,0 +1,163 @@
+#include <gtest/gtest.h>
+#include "../include/simdlib/simd_normalize.hpp"
+#include <cmath>
+#include <limits>
+#include <random>
+#include <vector>
+
+namespace simdlib
+{
+
+namespace
+{
+
+std::vector<float> random_row(size_t n, float lo, float hi, unsigned seed)
+{
+    std::mt19937 rng(seed);
+    std::uniform_real_distribution<float> dist(lo, hi);
+    std::vector<float> row(n);
+    for (auto &v : row)
+        v = dist(rng);
+    return row;
+}
+
+double reference_lse(const std::vector<float> &row)
+{
+    double m = -std::numeric_limits<double>::infinity();
+    for (const float v : row)
+        m = std::max(m, static_cast<double>(v));
+    double s = 0.0;
+    for (const float v : row)
+        s += std::exp(static_cast<double>(v) - m);
+    return m + std::log(s);
+}
+
+} // namespace
+
+TEST(SimdNormalizeTest, VectorExp)
+{
+    for (float x = -87.0f; x < 88.0f; x += 0.173f)
+    {
+        const float r = exp(simd_vector<float, AVX_SIZE>(x))[3];
+        EXPECT_NEAR(r, std::exp(x), std::exp(x) * 3e-7f) << "x = " << x;
+    }
+    EXPECT_EQ(exp(simd_vector<float, AVX_SIZE>(-std::numeric_limits<float>::infinity()))[0], 0.0f);
+    EXPECT_TRUE(std::isnan(exp(simd_vector<float, AVX_SIZE>(NAN))[0]));
+}
+
+TEST(SimdNormalizeTest, LogSumExpAndSoftmax)
+{
+    for (const size_t n : {1, 3, 8, 13, 32, 33, 70, 1000})
+    {
+        const std::vector<float> row = random_row(n, -40.0f, 40.0f, static_cast<unsigned>(n));
+        const double lse = reference_lse(row);
+        EXPECT_NEAR(log_sum_exp(row), lse, 1e-5 * std::max(1.0, std::abs(lse))) << "n = " << n;
+
+        std::vector<float> out(n);
+        softmax(row, out);
+        double total = 0.0;
+        for (size_t i = 0; i < n; ++i)
+        {
+            const double expected = std::exp(static_cast<double>(row[i]) - lse);
+            EXPECT_NEAR(out[i], expected, 1e-6 + 1e-5 * expected) << "n = " << n << ", i = " << i;
+            total += out[i];
+        }
+        EXPECT_NEAR(total, 1.0, 1e-5);
+
+        log_softmax(row, out);
+        for (size_t i = 0; i < n; ++i)
+            EXPECT_NEAR(out[i], row[i] - lse, 1e-4) << "n = " << n << ", i = " << i;
+    }
+    EXPECT_EQ(log_sum_exp({}), -std::numeric_limits<float>::infinity());
+}
+
+TEST(SimdNormalizeTest, SoftmaxEdgeCases)
+{
+    // large values would overflow a naive exp, -inf entries get exactly zero
+    std::vector<float> row = {1000.0f, 999.0f, -std::numeric_limits<float>::infinity(), 1000.0f,
+                              998.0f};
+    softmax(row, row);
+    const double z = 2.0 + std::exp(-1.0) + std::exp(-2.0);
+    EXPECT_NEAR(row[0], 1.0 / z, 1e-6);
+    EXPECT_NEAR(row[1], std::exp(-1.0) / z, 1e-6);
+    EXPECT_EQ(row[2], 0.0f);
+    EXPECT_NEAR(row[4], std::exp(-2.0) / z, 1e-6);
+
+    std::vector<float> with_nan = {1.0f, NAN, 2.0f};
+    EXPECT_TRUE(std::isnan(log_sum_exp(with_nan)));
+
+    std::vector<float> out(2);
+    EXPECT_THROW(softmax(row, out), std::invalid_argument);
+}
+
+TEST(SimdNormalizeTest, LayerNorm)
+{
+    for (const size_t n : {1, 5, 16, 37, 768})
+    {
+        // far from zero, where an unshifted sum of squares loses the variance
+        const std::vector<float> row = random_row(n, 1000.0f, 1004.0f, static_cast<unsigned>(n));
+        const std::vector<float> gamma = random_row(n, 0.5f, 2.0f, 1);
+        const std::vector<float> beta = random_row(n, -1.0f, 1.0f, 2);
+        double mean = 0.0;
+        for (const float v : row)
+            mean += v;
+        mean /= static_cast<double>(n);
+        double var = 0.0;
+        for (const float v : row)
+            var += (v - mean) * (v - mean);
+        var /= static_cast<double>(n);
+        const double rstd = 1.0 / std::sqrt(var + 1e-5);
+
+        std::vector<float> plain(n);
+        std::vector<float> affine(n);
+        layer_norm(row, plain);
+        layer_norm(row, affine, gamma, beta);
+        for (size_t i = 0; i < n; ++i)
+        {
+            const double y = (row[i] - mean) * rstd;
+            EXPECT_NEAR(plain[i], y, 2e-3) << "n = " << n << ", i = " << i;
+            EXPECT_NEAR(affine[i], y * gamma[i] + beta[i], 4e-3) << "n = " << n << ", i = " << i;
+        }
+    }
+
+    std::vector<float> row(8, 1.0f);
+    std::vector<float> gamma(7, 1.0f);
+    EXPECT_THROW(layer_norm(row, row, gamma, gamma), std::invalid_argument);
+    EXPECT_THROW(layer_norm(row, row, row, {}), std::invalid_argument);
+}
+
+TEST(SimdNormalizeTest, RowsMatchSingleRows)
+{
+    const size_t rows = 300;
+    const size_t cols = 77;
+    const std::vector<float> src = random_row(rows * cols, -5.0f, 5.0f, 3);
+    const std::vector<float> gamma = random_row(cols, 0.5f, 2.0f, 4);
+    const std::vector<float> beta = random_row(cols, -1.0f, 1.0f, 5);
+
+    std::vector<float> lse(rows);
+    std::vector<float> soft(src.size());
+    std::vector<float> log_soft(src.size());
+    std::vector<float> norm(src.size());
+    log_sum_exp_rows(src, cols, lse, 4);
+    softmax_rows(src, soft, cols, 4);
+    log_softmax_rows(src, log_soft, cols, 4);
+    layer_norm_rows(src, norm, cols, gamma, beta, 1e-5f, 4);
+
+    std::vector<float> expected(cols);
+    for (size_t r = 0; r < rows; ++r)
+    {
+        const std::span<const float> row(src.data() + r * cols, cols);
+        EXPECT_EQ(lse[r], log_sum_exp(row));
+        softmax(row, expected);
+        EXPECT_TRUE(std::equal(expected.begin(), expected.end(), soft.begin() + r * cols));
+        log_softmax(row, expected);
+        EXPECT_TRUE(std::equal(expected.begin(), expected.end(), log_soft.begin() + r * cols));
+        layer_norm(row, expected, gamma, beta);
+        EXPECT_TRUE(std::equal(expected.begin(), expected.end(), norm.begin() + r * cols));
+    }
+
+    EXPECT_THROW(softmax_rows(src, soft, 76), std::invalid_argument);
+    EXPECT_THROW(log_sum_exp_rows(src, cols, soft), std::invalid_argument);
+}
+
+} // namespace simdlib
@@ -0,0 +1,53 @@
+#include <gtest/gtest.h>
+#include "../include/simdlib/simd_parallel.hpp"
+#include <atomic>
+#include <stdexcept>
+#include <vector>
+
+namespace simdlib
+{
+
+TEST(SimdParallelTest, ChunksCoverTheRange)
+{
+    const size_t n = 10007;
+    std::vector<int> hits(n, 0);
+    parallel_for(n, 4,
+                 [&](size_t begin, size_t end, size_t)
+                 {
+                     EXPECT_EQ(begin % AVX_SIZE, 0u);
+                     for (size_t i = begin; i < end; ++i)
+                         ++hits[i];
+                 });
+    EXPECT_EQ(hits, std::vector<int>(n, 1));
+}
+
+TEST(SimdParallelTest, WorkerExceptionsReachTheCaller)
+{
+    // a throw on a worker thread is rethrown here instead of terminating, after the other
+    // chunks have run to completion
+    std::atomic<size_t> finished{0};
+    EXPECT_THROW(parallel_for(4000, 4,
+                              [&](size_t, size_t, size_t chunk)
+                              {
+                                  if (chunk == 2)
+                                      throw std::runtime_error("chunk failed");
+                                  ++finished;
+                              }),
+                 std::runtime_error);
+    EXPECT_EQ(finished.load(), 3u);
+
+    // the lowest throwing chunk wins, the caller's own included
+    try
+    {
+        parallel_for(4000, 3,
+                     [](size_t, size_t, size_t chunk)
+                     { throw std::out_of_range(chunk == 0 ? "first" : "later"); });
+        FAIL() << "parallel_for did not rethrow";
+    }
+    catch (const std::out_of_range &e)
+    {
+        EXPECT_STREQ(e.what(), "first");
+    }
+}
+
+} // namespace simdlib
@@ -0,0 +1,111 @@
+#include <gtest/gtest.h>
+#include "../include/simdlib/simd_parse.hpp"
+#include <charconv>
+#include <cmath>
+#include <cstdio>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace simdlib
+{
+
+static float reference(const std::string &token)
+{
+    float value = 0.0f;
+    const char *begin = token.data() + (token[0] == '+' ? 1 : 0);
+    std::from_chars(begin, token.data() + token.size(), value);
+    return value;
+}
+
+TEST(SimdParseTest, SingleTokens)
+{
+    const std::vector<std::string> tokens = {
+        "0", "-0", "+1", "42", "-17.25", ".5", "5.", "-.125e1", "1e10", "1E-10",
+        "3.4028235e38", "1.17549435e-38", "1e-45", "123456789", "0.1", "0.30000001",
+        "16777217", "9007199254740993", "1.00000006", "2.5e+3", "7e22", "1e23", "0.000001234",
+        "12345678901234567890", "1.5e-40", "100000000e-8",
+    };
+    for (const std::string &token : tokens)
+    {
+        const float expected = reference(token);
+        const float value = parse_float(token);
+        EXPECT_EQ(std::bit_cast<uint32_t>(value), std::bit_cast<uint32_t>(expected)) << token;
+    }
+    EXPECT_TRUE(std::isinf(parse_float("1e39")));
+    EXPECT_TRUE(std::isinf(parse_float("-1e500")));
+    EXPECT_LT(parse_float("-1e500"), 0.0f);
+    EXPECT_EQ(parse_float("1e-500"), 0.0f);
+    EXPECT_TRUE(std::isinf(parse_float("inf")));
+    EXPECT_TRUE(std::isnan(parse_float("nan")));
+}
+
+TEST(SimdParseTest, MalformedTokensThrow)
+{
+    for (const char *token : {"-", ".", "1e", "1.2.3", "abc", "1e+", "+-1", "--1", "0x10", "1,5"})
+        EXPECT_THROW(parse_float(token), std::invalid_argument) << token;
+    EXPECT_THROW(parse_float(""), std::invalid_argument);
+    EXPECT_THROW(parse_floats("1 2 x 4"), std::invalid_argument);
+}
+
+TEST(SimdParseTest, RoundTripsRandomFloats)
+{
+    std::mt19937 rng(1);
+    std::uniform_real_distribution<float> mantissa(-10.0f, 10.0f);
+    std::uniform_int_distribution<int> exponent(-40, 38);
+    std::string text;
+    std::vector<float> expected;
+    char buf[64];
+    for (int i = 0; i < 20000; ++i)
+    {
+        const float v = mantissa(rng) * std::pow(10.0f, static_cast<float>(exponent(rng) % 8));
+        const char *format = i % 3 == 0 ? "%.9g" : (i % 3 == 1 ? "%.3f" : "%.6e");
+        std::snprintf(buf, sizeof(buf), format, static_cast<double>(v));
+        text += buf;
+        text += i % 7 == 0 ? "\n" : (i % 5 == 0 ? " , " : ",");
+        expected.push_back(reference(buf));
+    }
+    const aligned_vector<float> values = parse_floats(text);
+    ASSERT_EQ(values.size(), expected.size());
+    EXPECT_EQ(reinterpret_cast<uintptr_t>(values.data()) % AVX_ALIGNMENT, 0u);
+    for (size_t i = 0; i < values.size(); ++i)
+        ASSERT_EQ(std::bit_cast<uint32_t>(values[i]), std::bit_cast<uint32_t>(expected[i])) << i;
+}
+
+TEST(SimdParseTest, SeparatorsAndTokensAtEdges)
+{
+    EXPECT_TRUE(parse_floats("").empty());
+    EXPECT_TRUE(parse_floats(" \n\t ,, \r\n").empty());
+    const aligned_vector<float> values = parse_floats("  1;2 ;; 3\t4\r\n5;6", ';');
+    EXPECT_EQ(values, (aligned_vector<float>{1, 2, 3, 4, 5, 6}));
+
+    // tokens straddling the 32-byte blocks and ending exactly at the end of the text
+    std::string text;
+    for (int i = 0; i < 100; ++i)
+        text += std::to_string(i) + ".5" + std::string(static_cast<size_t>(i % 4), ' ') + ",";
+    text += "-12345.678e-2";
+    const aligned_vector<float> many = parse_floats(text);
+    ASSERT_EQ(many.size(), 101u);
+    for (int i = 0; i < 100; ++i)
+        EXPECT_EQ(many[static_cast<size_t>(i)], static_cast<float>(i) + 0.5f);
+    EXPECT_EQ(many.back(), reference("-12345.678e-2"));
+}
+
+TEST(SimdParseTest, Columns)
+{
+    const std::string text = "1,2,3\n4.5, 5.5 ,6.5\r\n\n-7,8e1,9\n";
+    const auto columns = parse_columns(text);
+    ASSERT_EQ(columns.size(), 3u);
+    EXPECT_EQ(columns[0], (aligned_vector<float>{1.0f, 4.5f, -7.0f}));
+    EXPECT_EQ(columns[1], (aligned_vector<float>{2.0f, 5.5f, 80.0f}));
+    EXPECT_EQ(columns[2], (aligned_vector<float>{3.0f, 6.5f, 9.0f}));
+
+    EXPECT_TRUE(parse_columns("").empty());
+    EXPECT_THROW(parse_columns("1,2\n3\n"), std::invalid_argument);
+    EXPECT_THROW(parse_columns("1,2\n3,4,5\n"), std::invalid_argument);
+    EXPECT_THROW(parse_columns("1,2\n3,,4\n"), std::invalid_argument);
+    EXPECT_THROW(parse_columns("1,2,\n3,4\n"), std::invalid_argument);
+    EXPECT_EQ(parse_columns("1  2\n3\t4", ' ').size(), 2u);
+}
+
+} // namespace simdlib
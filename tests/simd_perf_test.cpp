@@ -0,0 +1,98 @@
+#include <gtest/gtest.h>
+#include "../include/simdlib/simd_histogram.hpp"
+#include "../include/simdlib/simd_perf.hpp"
+#include <string>
+#include <vector>
+
+namespace simdlib
+{
+
+TEST(SimdPerfTest, CountersAdvance)
+{
+    const perf_counters &counters = perf_counters::thread_local_instance();
+    if (!counters.available())
+        GTEST_SKIP() << "perf_event_open is not permitted here";
+
+    const perf_sample begin = counters.read();
+    volatile float sink = 0.0f;
+    for (int i = 0; i < 100000; ++i)
+        sink = sink + 1.0f;
+    const perf_sample delta = counters.read() - begin;
+    if (delta.has(perf_event::instructions))
+    {
+        EXPECT_GT(delta[perf_event::instructions], 100000u);
+    }
+    if (delta.has(perf_event::cycles))
+    {
+        EXPECT_GT(delta[perf_event::cycles], 0u);
+    }
+}
+
+TEST(SimdPerfTest, ScopeRecordsIntoRegistry)
+{
+    perf_registry &registry = perf_registry::instance();
+    registry.reset();
+    for (int i = 0; i < 3; ++i)
+    {
+        const perf_scope scope("test_kernel", 64);
+    }
+
+    const auto stats = registry.snapshot();
+    ASSERT_EQ(stats.count("test_kernel"), 1u);
+    EXPECT_EQ(stats.at("test_kernel").calls, 3u);
+    EXPECT_EQ(stats.at("test_kernel").bytes, 192u);
+    registry.reset();
+    EXPECT_TRUE(registry.snapshot().empty());
+}
+
+TEST(SimdPerfTest, JsonDump)
+{
+    perf_registry &registry = perf_registry::instance();
+    registry.reset();
+    EXPECT_EQ(registry.to_json(), "{}\n");
+
+    perf_sample delta;
+    delta.values[static_cast<size_t>(perf_event::cycles)] = 100;
+    delta.valid[static_cast<size_t>(perf_event::cycles)] = true;
+    delta.values[static_cast<size_t>(perf_event::instructions)] = 250;
+    delta.valid[static_cast<size_t>(perf_event::instructions)] = true;
+    registry.record("scan \"a\"", 1000, 400, delta);
+    registry.record("scan \"a\"", 1000, 400, delta);
+
+    const std::string json = registry.to_json();
+    EXPECT_NE(json.find("\"scan \\\"a\\\"\": {\"calls\": 2, \"nanoseconds\": 2000, \"bytes\": 800"),
+              std::string::npos)
+        << json;
+    EXPECT_NE(json.find("\"cycles\": 200"), std::string::npos);
+    EXPECT_NE(json.find("\"instructions\": 500"), std::string::npos);
+    EXPECT_NE(json.find("\"ipc\": 2.5"), std::string::npos);
+    EXPECT_NE(json.find("\"bytes_per_cycle\": 4"), std::string::npos);
+    EXPECT_EQ(json.find("llc_misses"), std::string::npos);
+
+    // control characters in a kernel name come out as \u escapes
+    registry.reset();
+    registry.record("tab\tnew\nline\x1f", 1, 0, perf_sample{});
+    EXPECT_EQ(registry.to_json(), "{\n  \"tab\\u0009new\\u000aline\\u001f\": {\"calls\": 1, "
+                                  "\"nanoseconds\": 1, \"bytes\": 0}\n}\n");
+    registry.reset();
+}
+
+TEST(SimdPerfTest, KernelsAreInstrumentedOnlyWhenEnabled)
+{
+    perf_registry &registry = perf_registry::instance();
+    registry.reset();
+    const std::vector<float> values(1000, 0.5f);
+    histogram(values, 4, 0.0f, 1.0f);
+
+    const auto stats = registry.snapshot();
+#ifdef SIMDLIB_PERF
+    ASSERT_EQ(stats.count("histogram"), 1u);
+    EXPECT_EQ(stats.at("histogram").calls, 1u);
+    EXPECT_EQ(stats.at("histogram").bytes, values.size() * sizeof(float));
+#else
+    EXPECT_TRUE(stats.empty());
+#endif
+    registry.reset();
+}
+
+} // namespace simdlib
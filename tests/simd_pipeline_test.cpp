@@ -0,0 +1,178 @@
+#include <gtest/gtest.h>
+#include "../include/simdlib/simd_half.hpp"
+#include "../include/simdlib/simd_pipeline.hpp"
+#include <algorithm>
+#include <atomic>
+#include <numeric>
+#include <random>
+#include <set>
+#include <vector>
+
+namespace simdlib
+{
+
+namespace
+{
+
+// a source handing out consecutive slices of input, count values per chunk
+template <typename T> auto slice_source(const std::vector<T> &input, size_t count)
+{
+    return [&input, count](pipeline_chunk &chunk)
+    {
+        const size_t begin = chunk.index() * count;
+        if (begin >= input.size())
+            return false;
+        const size_t n = std::min(count, input.size() - begin);
+        const std::span<T> values = chunk.resize<T>(n);
+        std::copy(input.begin() + static_cast<std::ptrdiff_t>(begin),
+                  input.begin() + static_cast<std::ptrdiff_t>(begin + n), values.begin());
+        return true;
+    };
+}
+
+} // namespace
+
+TEST(SimdPipelineTest, ChunksFlowInOrderThroughStages)
+{
+    std::vector<int32_t> input(10007);
+    std::iota(input.begin(), input.end(), -500);
+    pipeline_options options;
+    options.chunk_bytes = 1000 * sizeof(int32_t);
+
+    std::vector<int32_t> output;
+    std::vector<size_t> order;
+    const size_t chunks = run_pipeline(
+        options, slice_source(input, 1000),
+        [](pipeline_chunk &chunk)
+        {
+            for (auto &v : chunk.values<int32_t>())
+                v *= 3;
+        },
+        [&](pipeline_chunk &chunk)
+        {
+            order.push_back(chunk.index());
+            const auto values = chunk.values<int32_t>();
+            output.insert(output.end(), values.begin(), values.end());
+        });
+
+    EXPECT_EQ(chunks, 11u);
+    std::vector<size_t> expected_order(11);
+    std::iota(expected_order.begin(), expected_order.end(), size_t{0});
+    EXPECT_EQ(order, expected_order);
+    ASSERT_EQ(output.size(), input.size());
+    for (size_t i = 0; i < input.size(); ++i)
+        EXPECT_EQ(output[i], 3 * input[i]) << i;
+}
+
+TEST(SimdPipelineTest, DecodeWidensThroughTheSpareBuffer)
+{
+    // half-precision input decoded to floats, transformed, written back as halves
+    std::mt19937 rng(1);
+    std::uniform_real_distribution<float> dist(-4.0f, 4.0f);
+    std::vector<uint16_t> input(50003);
+    for (auto &h : input)
+        h = float_to_f16(dist(rng));
+    pipeline_options options;
+    options.chunk_bytes = 4096 * sizeof(float);
+
+    std::vector<float> output(input.size());
+    const simd_vector<float, AVX_SIZE> scale(0.5f);
+    const simd_vector<float, AVX_SIZE> shift(1.0f);
+    run_pipeline(
+        options, slice_source(input, 4096),
+        [](pipeline_chunk &chunk)
+        {
+            const auto halves = chunk.values<uint16_t>();
+            f16_to_float(halves, chunk.spare<float>(halves.size()));
+            chunk.commit<float>(halves.size());
+        },
+        pipeline_transform([&](const simd_vector<float, AVX_SIZE> &x)
+                           { return x.fmadd(scale, shift); }),
+        [&](pipeline_chunk &chunk)
+        {
+            const auto values = chunk.values<float>();
+            std::copy(values.begin(), values.end(), output.begin() + chunk.index() * 4096);
+        });
+
+    for (size_t i = 0; i < input.size(); ++i)
+        EXPECT_FLOAT_EQ(output[i], f16_to_float(input[i]) * 0.5f + 1.0f) << i;
+}
+
+TEST(SimdPipelineTest, ThePoolBoundsChunksInFlight)
+{
+    std::vector<float> input(100000, 1.0f);
+    for (const size_t pool : {0, 1, 2, 5})
+    {
+        pipeline_options options;
+        options.chunk_bytes = 256 * sizeof(float);
+        options.chunks = pool;
+        const size_t limit = pool != 0 ? pool : 2 * 4;
+        std::atomic<size_t> in_flight{0};
+        size_t peak = 0;
+        std::set<const void *> buffers;
+        double total = 0.0;
+        const auto source = slice_source(input, 256);
+        run_pipeline(
+            options,
+            [&](pipeline_chunk &chunk)
+            {
+                const bool more = source(chunk);
+                if (more)
+                    peak = std::max(peak, ++in_flight);
+                return more;
+            },
+            [](pipeline_chunk &) {}, pipeline_transform([](auto x) { return x + x; }),
+            [&](pipeline_chunk &chunk)
+            {
+                buffers.insert(&chunk);
+                for (const float v : chunk.values<float>())
+                    total += v;
+                --in_flight;
+            });
+        EXPECT_LE(peak, limit) << pool;
+        EXPECT_LE(buffers.size(), limit) << pool;
+        EXPECT_EQ(total, 2.0 * static_cast<double>(input.size())) << pool;
+    }
+}
+
+TEST(SimdPipelineTest, EmptyStreamsAndErrors)
+{
+    const pipeline_options options;
+    size_t calls = 0;
+    EXPECT_EQ(run_pipeline(
+                  options, [](pipeline_chunk &) { return false; },
+                  [&](pipeline_chunk &) { ++calls; }),
+              0u);
+    EXPECT_EQ(calls, 0u);
+
+    // a failing stage stops an endless source and its exception reaches the caller
+    EXPECT_THROW(run_pipeline(
+                     options,
+                     [](pipeline_chunk &chunk) { return chunk.resize<float>(8).size() > 0; },
+                     [](pipeline_chunk &chunk)
+                     {
+                         if (chunk.index() == 3)
+                             throw std::runtime_error("stage failed");
+                     },
+                     [](pipeline_chunk &) {}),
+                 std::runtime_error);
+
+    // so does a source overfilling its chunk
+    EXPECT_THROW(run_pipeline(
+                     options,
+                     [&](pipeline_chunk &chunk)
+                     {
+                         chunk.resize<float>(options.chunk_bytes / sizeof(float) + 1);
+                         return true;
+                     },
+                     [](pipeline_chunk &) {}),
+                 std::invalid_argument);
+
+    pipeline_options empty;
+    empty.chunk_bytes = 0;
+    EXPECT_THROW(run_pipeline(
+                     empty, [](pipeline_chunk &) { return false; }, [](pipeline_chunk &) {}),
+                 std::invalid_argument);
+}
+
+} // namespace simdlib
@@ -0,0 +1,115 @@
+#include <gtest/gtest.h>
+#include "../include/simdlib/simd_quantize.hpp"
+#include <cmath>
+#include <random>
+#include <vector>
+
+namespace simdlib
+{
+
+TEST(SimdQuantizeTest, QuantizeRoundsAndSaturates)
+{
+    const std::vector<float> values = {0.0f, 0.5f, 1.5f, -0.5f, 2.0f,  -2.0f, 1000.0f, -1000.0f,
+                                       0.26f, 63.4f, NAN, -63.6f, 0.74f, 12.0f, -12.0f, 1.0f,
+                                       3.0f,  -3.0f, 7.5f, 8.5f,  0.0f,  0.25f, 0.75f, 100.0f,
+                                       -100.0f, 1.25f, 2.5f, -2.5f, 30.0f, 31.0f, 32.0f, 33.0f,
+                                       5.0f,  -5.0f};
+    const quant_params params{0.5f, 0};
+    std::vector<int8_t> q(values.size());
+    quantize<int8_t>(values, q, params);
+
+    for (size_t i = 0; i < values.size(); ++i)
+    {
+        float expected = std::isnan(values[i]) ? -128.0f : std::nearbyint(values[i] / 0.5f);
+        expected = std::clamp(expected, -128.0f, 127.0f);
+        EXPECT_EQ(q[i], static_cast<int8_t>(expected)) << "i = " << i;
+    }
+}
+
+TEST(SimdQuantizeTest, RoundTripUnsigned)
+{
+    std::mt19937 rng(21);
+    std::uniform_real_distribution<float> dist(-3.0f, 5.0f);
+    std::vector<float> values(1000);
+    for (auto &v : values)
+        v = dist(rng);
+
+    const quant_params params = compute_quant_params<uint8_t>(values);
+    std::vector<uint8_t> q(values.size());
+    std::vector<float> restored(values.size());
+    quantize<uint8_t>(values, q, params);
+    dequantize<uint8_t>(q, restored, params);
+
+    EXPECT_NEAR(params.scale, 8.0f / 255.0f, 1e-3f);
+    for (size_t i = 0; i < values.size(); ++i)
+    {
+        EXPECT_NEAR(restored[i], values[i], params.scale * 0.5f + 1e-6f) << "i = " << i;
+    }
+}
+
+TEST(SimdQuantizeTest, PerChannel)
+{
+    const size_t channels = 3;
+    const size_t inner = 37;
+    std::vector<float> values(channels * inner);
+    for (size_t c = 0; c < channels; ++c)
+    {
+        for (size_t j = 0; j < inner; ++j)
+            values[c * inner + j] = static_cast<float>(c + 1) * (static_cast<float>(j) - 18.0f);
+    }
+    std::vector<quant_params> params(channels);
+    for (size_t c = 0; c < channels; ++c)
+        params[c] = compute_quant_params<int8_t>(std::span(values).subspan(c * inner, inner));
+
+    std::vector<int8_t> q(values.size());
+    std::vector<float> restored(values.size());
+    quantize_per_channel<int8_t>(values, q, params);
+    dequantize_per_channel<int8_t>(q, restored, params);
+
+    for (size_t c = 0; c < channels; ++c)
+    {
+        for (size_t j = 0; j < inner; ++j)
+        {
+            EXPECT_NEAR(restored[c * inner + j], values[c * inner + j],
+                        params[c].scale * 0.5f + 1e-5f);
+        }
+    }
+    EXPECT_THROW(quantize_per_channel<int8_t>(values, q, std::span(params).first(2)),
+                 std::invalid_argument);
+}
+
+TEST(SimdQuantizeTest, DotProducts)
+{
+    std::mt19937 rng(17);
+    std::uniform_int_distribution<int> byte(0, 255);
+    for (size_t n : {5, 32, 100, 1025})
+    {
+        std::vector<uint8_t> a(n);
+        std::vector<int8_t> b(n);
+        std::vector<int8_t> c(n);
+        for (size_t i = 0; i < n; ++i)
+        {
+            a[i] = static_cast<uint8_t>(byte(rng));
+            b[i] = static_cast<int8_t>(byte(rng) - 128);
+            c[i] = static_cast<int8_t>(byte(rng) - 128);
+        }
+        // worst case for saturating pair sums
+        a[0] = 255;
+        a[1] = 255;
+        b[0] = -128;
+        b[1] = -128;
+        c[0] = -128;
+
+        int32_t expected_ub = 0;
+        int32_t expected_bb = 0;
+        for (size_t i = 0; i < n; ++i)
+        {
+            expected_ub += static_cast<int32_t>(a[i]) * b[i];
+            expected_bb += static_cast<int32_t>(c[i]) * b[i];
+        }
+        EXPECT_EQ(dot(a, b), expected_ub) << "n = " << n;
+        EXPECT_EQ(dot(c, b), expected_bb) << "n = " << n;
+    }
+}
+
+} // namespace simdlib
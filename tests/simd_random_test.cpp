@@ -0,0 +1,168 @@
+#include <gtest/gtest.h>
+#include "../include/simdlib/simd_random.hpp"
+#include <cmath>
+#include <utility>
+#include <vector>
+
+namespace simdlib
+{
+
+namespace
+{
+
+std::array<uint32_t, AVX_SIZE> words_of(__m256i vec)
+{
+    std::array<uint32_t, AVX_SIZE> words{};
+    _mm256_storeu_si256(reinterpret_cast<__m256i *>(words.data()), vec);
+    return words;
+}
+
+template <typename Draw> void expect_moments(Draw draw, double mean, double variance)
+{
+    const size_t n = size_t{1} << 20;
+    double sum = 0.0;
+    double sum_sq = 0.0;
+    for (size_t i = 0; i < n; i += AVX_SIZE)
+    {
+        const simd_vector<float, AVX_SIZE> v = draw();
+        for (size_t k = 0; k < AVX_SIZE; ++k)
+        {
+            sum += v[k];
+            sum_sq += static_cast<double>(v[k]) * v[k];
+        }
+    }
+    const double m = sum / static_cast<double>(n);
+    EXPECT_NEAR(m, mean, 5e-3);
+    EXPECT_NEAR(sum_sq / static_cast<double>(n) - m * m, variance, 5e-3 * (variance + 0.1));
+}
+
+} // namespace
+
+TEST(SimdRandomTest, PhiloxKnownAnswers)
+{
+    // Random123 test vectors for philox4x32-10
+    philox_x8 zero(0, 0, 0);
+    const detail::word_block a = zero.next_block();
+    const std::array<uint32_t, 4> expected_zero = {0x6627e8d5, 0xe169c58d, 0xbc57ac4c,
+                                                   0x9b00dbd8};
+    for (size_t j = 0; j < 4; ++j)
+        EXPECT_EQ(words_of(a.words[j])[0], expected_zero[j]) << "word " << j;
+
+    // lane 7 of the last block holds the all-ones counter
+    philox_x8 ones(~uint64_t{0}, ~uint64_t{0}, (~uint64_t{0}) >> 3);
+    const detail::word_block b = ones.next_block();
+    const std::array<uint32_t, 4> expected_ones = {0x408f276d, 0x41c83b0e, 0xa20bc7c6,
+                                                   0x6d5451fd};
+    for (size_t j = 0; j < 4; ++j)
+        EXPECT_EQ(words_of(b.words[j])[7], expected_ones[j]) << "word " << j;
+}
+
+TEST(SimdRandomTest, XoshiroLaneZeroMatchesScalar)
+{
+    uint64_t sm = 77;
+    const uint64_t a = detail::splitmix64(sm);
+    const uint64_t b = detail::splitmix64(sm);
+    std::array<uint32_t, 4> s = {static_cast<uint32_t>(a), static_cast<uint32_t>(a >> 32),
+                                 static_cast<uint32_t>(b), static_cast<uint32_t>(b >> 32)};
+
+    xoshiro128p_x8 gen(77);
+    for (int i = 0; i < 100; ++i)
+    {
+        const std::array<uint32_t, AVX_SIZE> lanes = words_of(gen.next_u32());
+        EXPECT_EQ(lanes[0], s[0] + s[3]) << "step " << i;
+        for (size_t k = 1; k < AVX_SIZE; ++k)
+            EXPECT_NE(lanes[k], lanes[0]);
+        const uint32_t t = s[1] << 9;
+        s[2] ^= s[0];
+        s[3] ^= s[1];
+        s[1] ^= s[2];
+        s[0] ^= s[3];
+        s[2] ^= t;
+        s[3] = (s[3] << 11) | (s[3] >> 21);
+    }
+}
+
+TEST(SimdRandomTest, UniformMoments)
+{
+    xoshiro128p_x8 xoshiro(1);
+    expect_moments([&] { return xoshiro.uniform(); }, 0.5, 1.0 / 12.0);
+    philox_x8 philox(2);
+    expect_moments([&] { return philox.uniform(); }, 0.5, 1.0 / 12.0);
+
+    std::vector<float> values(100003);
+    fill_uniform(values, 3, 0, -2.0f, 5.0f);
+    for (const float v : values)
+    {
+        ASSERT_GE(v, -2.0f);
+        ASSERT_LT(v, 5.0f);
+    }
+}
+
+TEST(SimdRandomTest, UniformRangeExcludesHi)
+{
+    // the maximal word gives u = 1 - 2^-24, and u * 1 + 1 rounds to 2 in float
+    const simd_vector<float, AVX_SIZE> u = detail::to_unit(_mm256_set1_epi32(-1));
+    ASSERT_EQ(u[0], 1.0f - 0x1.0p-24f);
+    ASSERT_EQ(detail::affine(u, 1.0f, 1.0f)[0], 2.0f);
+    for (const auto &[lo, hi] : {std::pair{1.0f, 2.0f}, {-2.0f, 5.0f}, {0.0f, 1.0f},
+                                 {1000.0f, 1000.5f}, {-1.0f, -0.5f}})
+    {
+        const float v = detail::uniform_in(u, lo, hi - lo, detail::uniform_top(lo, hi))[0];
+        EXPECT_LT(v, hi) << "[" << lo << ", " << hi << ")";
+        EXPECT_GE(v, lo) << "[" << lo << ", " << hi << ")";
+    }
+    // the smallest word still maps to lo
+    const simd_vector<float, AVX_SIZE> zero = detail::to_unit(_mm256_setzero_si256());
+    EXPECT_EQ(detail::uniform_in(zero, 1.0f, 1.0f, detail::uniform_top(1.0f, 2.0f))[0], 1.0f);
+}
+
+TEST(SimdRandomTest, NormalMoments)
+{
+    xoshiro128p_x8 xoshiro(4);
+    expect_moments([&] { return xoshiro.normal(); }, 0.0, 1.0);
+    philox_x8 philox(5);
+    expect_moments([&] { return philox.normal(); }, 0.0, 1.0);
+
+    std::vector<float> values(size_t{1} << 20);
+    fill_normal(values, 6, 0, 3.0f, 2.0f);
+    size_t within = 0;
+    for (const float v : values)
+    {
+        ASSERT_TRUE(std::isfinite(v));
+        within += std::abs(v - 3.0f) < 2.0f;
+    }
+    EXPECT_NEAR(static_cast<double>(within) / static_cast<double>(values.size()), 0.6827, 3e-3);
+}
+
+TEST(SimdRandomTest, FillsAreReproducible)
+{
+    const size_t n = 600003;
+    std::vector<float> one(n);
+    std::vector<float> many(n);
+    fill_uniform(one, 9, 1, 0.0f, 1.0f, 1);
+    fill_uniform(many, 9, 1, 0.0f, 1.0f, 4);
+    EXPECT_EQ(one, many);
+
+    philox_x8 gen(9, 1);
+    for (size_t i = 0; i < 4096; i += AVX_SIZE)
+    {
+        const simd_vector<float, AVX_SIZE> v = gen.uniform();
+        for (size_t k = 0; k < AVX_SIZE; ++k)
+            ASSERT_EQ(one[i + k], v[k]) << "i = " << i + k;
+    }
+
+    std::vector<float> other_stream(n);
+    fill_uniform(other_stream, 9, 2);
+    EXPECT_NE(one, other_stream);
+
+    fill_normal(one, 10, 0, 0.0f, 1.0f, 1);
+    fill_normal(many, 10, 0, 0.0f, 1.0f, 3);
+    EXPECT_EQ(one, many);
+    philox_x8 normals(10);
+    normals.seek(100);
+    const simd_vector<float, AVX_SIZE> z = normals.normal();
+    for (size_t k = 0; k < AVX_SIZE; ++k)
+        EXPECT_EQ(one[100 * philox_x8::block_size + k], z[k]);
+}
+
+} // namespace simdlib
@@ -0,0 +1,76 @@
+#include <gtest/gtest.h>
+#include "../include/simdlib/simd_reduce.hpp"
+#include <cmath>
+#include <random>
+#include <vector>
+
+namespace simdlib
+{
+
+static std::vector<float> random_values(size_t n, unsigned seed)
+{
+    std::mt19937 rng(seed);
+    std::uniform_real_distribution<float> dist(-100.0f, 100.0f);
+    std::vector<float> values(n);
+    for (auto &v : values)
+        v = dist(rng);
+    return values;
+}
+
+TEST(SimdReduceTest, SpanReductions)
+{
+    for (const size_t n : {0u, 1u, 7u, 31u, 33u, 1000u, 100003u})
+    {
+        const std::vector<float> values = random_values(n, static_cast<unsigned>(n));
+        double expected_sum = 0.0;
+        float expected_min = INFINITY;
+        float expected_max = -INFINITY;
+        for (const float v : values)
+        {
+            expected_sum += v;
+            expected_min = std::min(expected_min, v);
+            expected_max = std::max(expected_max, v);
+        }
+        EXPECT_NEAR(reduce_sum(values), expected_sum, 1e-3 * std::sqrt(double(n) + 1)) << n;
+        EXPECT_EQ(reduce_min(values), expected_min) << n;
+        EXPECT_EQ(reduce_max(values), expected_max) << n;
+    }
+}
+
+TEST(SimdReduceTest, MinMaxIgnoreNan)
+{
+    std::vector<float> values(40, 1.0f);
+    values[0] = NAN;
+    values[17] = -3.0f;
+    values[33] = 9.0f;
+    values[39] = NAN;
+    EXPECT_EQ(reduce_min(values), -3.0f);
+    EXPECT_EQ(reduce_max(values), 9.0f);
+}
+
+TEST(SimdReduceTest, MultithreadedMatchesSingle)
+{
+    const std::vector<float> values = random_values(3000001, 5);
+    EXPECT_NEAR(reduce_sum(values, 4), reduce_sum(values), 0.1);
+    EXPECT_EQ(reduce_min(values, 4), reduce_min(values));
+    EXPECT_EQ(reduce_max(values, 0), reduce_max(values));
+}
+
+TEST(SimdReduceTest, TransformHandlesTailAndInPlace)
+{
+    std::vector<float> values = random_values(1029, 6);
+    std::vector<float> out(values.size());
+    const auto affine = [](simd_vector<float, AVX_SIZE> v)
+    { return v.fmadd(simd_vector<float, AVX_SIZE>(2.0f), simd_vector<float, AVX_SIZE>(1.0f)); };
+    transform_values(values, out, affine, 3);
+    for (size_t i = 0; i < values.size(); ++i)
+        EXPECT_FLOAT_EQ(out[i], values[i] * 2.0f + 1.0f);
+
+    transform_values(out, out, affine);
+    for (size_t i = 0; i < values.size(); ++i)
+        EXPECT_FLOAT_EQ(out[i], (values[i] * 2.0f + 1.0f) * 2.0f + 1.0f);
+    EXPECT_THROW(transform_values(values, std::span<float>(out).first(3), affine),
+                 std::invalid_argument);
+}
+
+} // namespace simdlib
@@ -0,0 +1,144 @@
+#include <gtest/gtest.h>
+#include "../include/simdlib/simd_rolling.hpp"
+#include <algorithm>
+#include <cmath>
+#include <random>
+#include <vector>
+
+namespace simdlib
+{
+
+static std::vector<float> random_series(size_t n, float offset, float spread, unsigned seed)
+{
+    std::mt19937 rng(seed);
+    std::uniform_real_distribution<float> dist(-spread, spread);
+    std::vector<float> values(n);
+    for (auto &v : values)
+        v = offset + dist(rng);
+    return values;
+}
+
+static std::vector<double> reference_moment(const std::vector<float> &values, size_t window,
+                                            int power)
+{
+    std::vector<double> out(values.size() - window + 1);
+    for (size_t i = 0; i < out.size(); ++i)
+    {
+        double mean = 0.0;
+        for (size_t k = 0; k < window; ++k)
+            mean += values[i + k];
+        mean /= static_cast<double>(window);
+        if (power == 1)
+        {
+            out[i] = mean * static_cast<double>(window);
+            continue;
+        }
+        double sq = 0.0;
+        for (size_t k = 0; k < window; ++k)
+            sq += (values[i + k] - mean) * (values[i + k] - mean);
+        out[i] = sq;
+    }
+    return out;
+}
+
+TEST(SimdRollingTest, SumAndMean)
+{
+    for (const size_t window : {1u, 3u, 8u, 17u, 100u})
+    {
+        const std::vector<float> values = random_series(1037, 0.0f, 10.0f, 1);
+        const std::vector<double> expected = reference_moment(values, window, 1);
+        std::vector<float> sum(expected.size());
+        std::vector<float> mean(expected.size());
+        rolling_sum(values, window, sum);
+        rolling_mean(values, window, mean);
+        for (size_t i = 0; i < expected.size(); ++i)
+        {
+            ASSERT_NEAR(sum[i], expected[i], 1e-4 * window) << window << " " << i;
+            ASSERT_NEAR(mean[i], expected[i] / window, 1e-4) << window << " " << i;
+        }
+    }
+}
+
+TEST(SimdRollingTest, SumStaysAccurateFarIntoLongSeries)
+{
+    // a plain float prefix sum reaches ~1e9 here and cannot resolve the window sums
+    const size_t window = 50;
+    const std::vector<float> values = random_series(1 << 20, 1000.0f, 1.0f, 2);
+    std::vector<float> sum(values.size() - window + 1);
+    rolling_sum(values, window, sum);
+    for (size_t i = sum.size() - 2000; i < sum.size(); ++i)
+    {
+        double expected = 0.0;
+        for (size_t k = 0; k < window; ++k)
+            expected += values[i + k];
+        ASSERT_NEAR(sum[i], expected, 0.05) << i;
+    }
+}
+
+TEST(SimdRollingTest, Variance)
+{
+    for (const size_t window : {2u, 9u, 64u})
+    {
+        // a large common offset with unit spread is the cancellation-prone case
+        const std::vector<float> values = random_series(4099, 1000.0f, 1.0f, 3);
+        const std::vector<double> expected = reference_moment(values, window, 2);
+        std::vector<float> var(expected.size());
+        std::vector<float> sample_var(expected.size());
+        rolling_variance(values, window, var);
+        rolling_variance(values, window, sample_var, 1);
+        for (size_t i = 0; i < expected.size(); ++i)
+        {
+            ASSERT_NEAR(var[i], expected[i] / window, 2e-3) << window << " " << i;
+            ASSERT_NEAR(sample_var[i], expected[i] / (window - 1), 2e-3) << window << " " << i;
+        }
+    }
+
+    const std::vector<float> constant(40, 7.25f);
+    std::vector<float> var(31);
+    rolling_variance(constant, 10, var);
+    for (const float v : var)
+        EXPECT_EQ(v, 0.0f);
+}
+
+TEST(SimdRollingTest, MinMaxMatchNaive)
+{
+    for (const size_t n : {1u, 9u, 64u, 1000u, 1003u})
+    {
+        for (const size_t window : {1u, 2u, 7u, 8u, 16u, 17u, 23u, 24u, 33u, 100u, 1000u})
+        {
+            if (window > n)
+                continue;
+            const std::vector<float> values =
+                random_series(n, 0.0f, 100.0f, static_cast<unsigned>(n * 31 + window));
+            std::vector<float> lo(n - window + 1);
+            std::vector<float> hi(n - window + 1);
+            rolling_min(values, window, lo);
+            rolling_max(values, window, hi);
+            for (size_t i = 0; i < lo.size(); ++i)
+            {
+                const auto first = values.begin() + static_cast<std::ptrdiff_t>(i);
+                const auto last = first + static_cast<std::ptrdiff_t>(window);
+                ASSERT_EQ(lo[i], *std::min_element(first, last)) << n << " " << window << " " << i;
+                ASSERT_EQ(hi[i], *std::max_element(first, last)) << n << " " << window << " " << i;
+            }
+        }
+    }
+}
+
+TEST(SimdRollingTest, ShortSeriesAndBadSizes)
+{
+    const std::vector<float> values = {1.0f, 2.0f, 3.0f};
+    std::vector<float> none;
+    rolling_sum(values, 5, none);
+    rolling_max(values, 5, none);
+
+    std::vector<float> out(2);
+    EXPECT_THROW(rolling_sum(values, 0, out), std::invalid_argument);
+    EXPECT_THROW(rolling_min(values, 3, out), std::invalid_argument);
+    EXPECT_THROW(rolling_variance(values, 2, out, 2), std::invalid_argument);
+    rolling_variance(values, 2, out, 1);
+    EXPECT_FLOAT_EQ(out[0], 0.5f);
+    EXPECT_FLOAT_EQ(out[1], 0.5f);
+}
+
+} // namespace simdlib
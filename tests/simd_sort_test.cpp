@@ -0,0 +1,142 @@
+#include <gtest/gtest.h>
+#include "../include/simdlib/simd_sort.hpp"
+#include <algorithm>
+#include <random>
+#include <vector>
+
+namespace simdlib
+{
+
+TEST(SimdSortTest, SortEightLanes)
+{
+    simd_vector<float, 8> vec(5.0f, -1.0f, 3.0f, 7.0f, 0.0f, 2.0f, 6.0f, -4.0f);
+    sort(vec);
+
+    const float expected[] = {-4.0f, -1.0f, 0.0f, 2.0f, 3.0f, 5.0f, 6.0f, 7.0f};
+    for (size_t i = 0; i < 8; ++i)
+    {
+        EXPECT_EQ(vec[i], expected[i]);
+    }
+}
+
+TEST(SimdSortTest, SortSixteenLanes)
+{
+    std::mt19937 rng(42);
+    std::uniform_real_distribution<float> dist(-100.0f, 100.0f);
+    for (int round = 0; round < 100; ++round)
+    {
+        std::vector<float> values(16);
+        for (auto &v : values)
+            v = dist(rng);
+        simd_vector<float, 8> lo(_mm256_loadu_ps(values.data()));
+        simd_vector<float, 8> hi(_mm256_loadu_ps(values.data() + 8));
+        sort(lo, hi);
+        std::sort(values.begin(), values.end());
+
+        for (size_t i = 0; i < 8; ++i)
+        {
+            EXPECT_EQ(lo[i], values[i]);
+            EXPECT_EQ(hi[i], values[i + 8]);
+        }
+    }
+}
+
+TEST(SimdSortTest, SortKeyValueLanes)
+{
+    simd_vector<float, 8> keys(3.0f, 1.0f, 3.0f, 0.0f, 2.0f, 1.0f, 5.0f, 4.0f);
+    __m256i values = _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7);
+    sort(keys, values);
+
+    alignas(32) uint32_t payload[8];
+    _mm256_store_si256(reinterpret_cast<__m256i *>(payload), values);
+    const float original[] = {3.0f, 1.0f, 3.0f, 0.0f, 2.0f, 1.0f, 5.0f, 4.0f};
+    for (size_t i = 0; i < 8; ++i)
+    {
+        if (i > 0)
+        {
+            EXPECT_LE(keys[i - 1], keys[i]);
+        }
+        EXPECT_EQ(original[payload[i]], keys[i]);
+    }
+    std::sort(payload, payload + 8);
+    for (uint32_t i = 0; i < 8; ++i)
+    {
+        EXPECT_EQ(payload[i], i);
+    }
+}
+
+TEST(SimdSortTest, SortArrays)
+{
+    std::mt19937 rng(7);
+    std::uniform_real_distribution<float> dist(-1000.0f, 1000.0f);
+    for (size_t n : {0, 1, 7, 16, 17, 31, 100, 1000, 65537})
+    {
+        std::vector<float> values(n);
+        for (auto &v : values)
+            v = dist(rng);
+        std::vector<float> expected = values;
+        std::sort(expected.begin(), expected.end());
+
+        sort(std::span<float>(values));
+        EXPECT_EQ(values, expected) << "n = " << n;
+    }
+}
+
+TEST(SimdSortTest, SortArraysWithDuplicates)
+{
+    std::mt19937 rng(11);
+    std::uniform_int_distribution<int> dist(0, 3);
+    std::vector<float> values(10000);
+    for (auto &v : values)
+        v = static_cast<float>(dist(rng));
+    values[17] = std::numeric_limits<float>::infinity();
+    std::vector<float> expected = values;
+    std::sort(expected.begin(), expected.end());
+
+    sort(std::span<float>(values));
+    EXPECT_EQ(values, expected);
+
+    std::vector<float> constant(5000, 1.5f);
+    sort(std::span<float>(constant));
+    EXPECT_TRUE(std::all_of(constant.begin(), constant.end(), [](float v) { return v == 1.5f; }));
+}
+
+TEST(SimdSortTest, SortKeyValueArrays)
+{
+    std::mt19937 rng(3);
+    std::uniform_int_distribution<int> dist(-50, 50);
+    for (size_t n : {5, 16, 40, 20000})
+    {
+        std::vector<float> keys(n);
+        std::vector<uint32_t> values(n);
+        for (size_t i = 0; i < n; ++i)
+        {
+            keys[i] = static_cast<float>(dist(rng));
+            values[i] = static_cast<uint32_t>(i);
+        }
+        keys[n / 2] = std::numeric_limits<float>::infinity();
+        const std::vector<float> original = keys;
+
+        sort_key_value(keys, values);
+
+        EXPECT_TRUE(std::is_sorted(keys.begin(), keys.end())) << "n = " << n;
+        for (size_t i = 0; i < n; ++i)
+        {
+            EXPECT_EQ(original[values[i]], keys[i]);
+        }
+        std::sort(values.begin(), values.end());
+        for (size_t i = 0; i < n; ++i)
+        {
+            EXPECT_EQ(values[i], i);
+        }
+    }
+}
+
+TEST(SimdSortTest, SortKeyValueSizeMismatch)
+{
+    std::vector<float> keys(4);
+    std::vector<uint32_t> values(3);
+    EXPECT_THROW(sort_key_value(keys, values), std::invalid_argument);
+}
+
+} // namespace simdlib
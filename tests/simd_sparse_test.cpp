@@ -0,0 +1,153 @@
+#include <gtest/gtest.h>
+#include "../include/simdlib/simd_sparse.hpp"
+#include <cmath>
+#include <random>
+#include <vector>
+
+namespace simdlib
+{
+
+namespace
+{
+
+// rows of very uneven length, a few of them empty
+csr_matrix random_csr(size_t rows, size_t cols, unsigned seed)
+{
+    std::mt19937 rng(seed);
+    std::uniform_int_distribution<uint32_t> col(0, static_cast<uint32_t>(cols - 1));
+    std::uniform_real_distribution<float> val(-1.0f, 1.0f);
+    csr_matrix a;
+    a.rows = rows;
+    a.cols = cols;
+    for (size_t r = 0; r < rows; ++r)
+    {
+        const size_t length = r % 11 == 0 ? 0 : (rng() % 4 == 0 ? rng() % 70 : rng() % 6);
+        for (size_t j = 0; j < length; ++j)
+        {
+            a.col_idx.push_back(col(rng));
+            a.values.push_back(val(rng));
+        }
+        a.row_ptr.push_back(a.values.size());
+    }
+    return a;
+}
+
+std::vector<double> reference_spmv(const csr_matrix &a, const std::vector<float> &x)
+{
+    std::vector<double> y(a.rows);
+    for (size_t r = 0; r < a.rows; ++r)
+    {
+        for (uint64_t j = a.row_ptr[r]; j < a.row_ptr[r + 1]; ++j)
+            y[r] += static_cast<double>(a.values[j]) * x[a.col_idx[j]];
+    }
+    return y;
+}
+
+} // namespace
+
+TEST(SimdSparseTest, CsrAndSellMatchReference)
+{
+    for (const size_t rows : {1, 7, 8, 61, 1000})
+    {
+        const csr_matrix a = random_csr(rows, 300, static_cast<unsigned>(rows));
+        std::vector<float> x(a.cols);
+        for (size_t i = 0; i < x.size(); ++i)
+            x[i] = std::sin(static_cast<float>(i));
+        const std::vector<double> expected = reference_spmv(a, x);
+
+        std::vector<float> y(rows, NAN);
+        spmv(a, x, y);
+        for (size_t r = 0; r < rows; ++r)
+            EXPECT_NEAR(y[r], expected[r], 1e-4) << "csr, rows = " << rows << ", r = " << r;
+
+        for (const size_t sigma : {1, 8, 64, 4096})
+        {
+            const sell_matrix s = to_sell(a, sigma);
+            EXPECT_GE(s.stored(), a.nonzeros());
+            std::fill(y.begin(), y.end(), NAN);
+            spmv(s, x, y);
+            for (size_t r = 0; r < rows; ++r)
+                EXPECT_NEAR(y[r], expected[r], 1e-4)
+                    << "sell, rows = " << rows << ", sigma = " << sigma << ", r = " << r;
+        }
+    }
+}
+
+TEST(SimdSparseTest, PaddingNeverReadsX)
+{
+    // no row touches column 0, so an infinite x[0] must not turn the padded short rows into NaN
+    csr_matrix a = random_csr(203, 300, 5);
+    a.cols += 1;
+    for (auto &c : a.col_idx)
+        ++c;
+    std::vector<float> x(a.cols, 0.5f);
+    for (const float bad : {INFINITY, NAN})
+    {
+        x[0] = bad;
+        std::vector<float> expected(a.rows);
+        spmv(a, x, expected);
+        for (const size_t sigma : {1, 64})
+        {
+            std::vector<float> y(a.rows, NAN);
+            spmv(to_sell(a, sigma), x, y);
+            for (size_t r = 0; r < a.rows; ++r)
+            {
+                ASSERT_TRUE(std::isfinite(y[r])) << "sigma = " << sigma << ", r = " << r;
+                EXPECT_NEAR(y[r], expected[r], 1e-4) << "sigma = " << sigma << ", r = " << r;
+            }
+        }
+    }
+}
+
+TEST(SimdSparseTest, SortingWindowCutsPadding)
+{
+    const csr_matrix a = random_csr(4096, 1000, 3);
+    const sell_matrix unsorted = to_sell(a, 1);
+    const sell_matrix sorted = to_sell(a, 512);
+    EXPECT_LT(sorted.stored(), unsorted.stored());
+    EXPECT_EQ(sorted.chunks(), 512u);
+    for (size_t c = 0; c <= sorted.chunks(); ++c)
+        EXPECT_EQ(sorted.chunk_ptr[c] % AVX_SIZE, 0u);
+}
+
+TEST(SimdSparseTest, ThreadedMatchesSingleThreaded)
+{
+    const csr_matrix a = random_csr(40000, 5000, 4);
+    ASSERT_GT(a.nonzeros(), 3 * detail::spmv_min_chunk);
+    std::vector<float> x(a.cols);
+    for (size_t i = 0; i < x.size(); ++i)
+        x[i] = std::cos(static_cast<float>(i));
+    const sell_matrix s = to_sell(a);
+
+    std::vector<float> one(a.rows);
+    std::vector<float> many(a.rows, NAN);
+    spmv(a, x, one, 1);
+    spmv(a, x, many, 3);
+    EXPECT_EQ(one, many);
+    spmv(s, x, one, 1);
+    std::fill(many.begin(), many.end(), NAN);
+    spmv(s, x, many, 3);
+    EXPECT_EQ(one, many);
+}
+
+TEST(SimdSparseTest, RejectsBadInput)
+{
+    csr_matrix a = random_csr(10, 20, 5);
+    std::vector<float> x(20);
+    std::vector<float> y(10);
+    EXPECT_THROW(spmv(a, std::span<const float>(x).first(19), y), std::invalid_argument);
+    EXPECT_THROW(to_sell(a, 12), std::invalid_argument);
+    a.row_ptr.pop_back();
+    EXPECT_THROW(spmv(a, x, y), std::invalid_argument);
+
+    csr_matrix b = random_csr(10, 20, 6);
+    b.col_idx.back() = 20;
+    EXPECT_THROW(to_sell(b), std::invalid_argument);
+
+    // an empty matrix is fine
+    const csr_matrix empty;
+    spmv(empty, {}, {});
+    spmv(to_sell(empty), {}, {});
+}
+
+} // namespace simdlib
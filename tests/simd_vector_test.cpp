@@ -117,6 +117,28 @@ TEST(SimdVectorTest, DivisionInPlace)
     }
 }
 
+TEST(SimdVectorTest, FusedMultiplyAdd)
+{
+    simd_vector<float, 4> vec1(2.0f);
+    simd_vector<float, 4> vec2(3.0f);
+    simd_vector<float, 4> vec3(1.0f);
+    auto result = fmadd(vec1, vec2, vec3);
+
+    for (size_t i = 0; i < 4; ++i)
+    {
+        EXPECT_EQ(result[i], 7.0f);
+    }
+
+    simd_vector<float, 8> vec4(2.0f);
+    simd_vector<float, 8> vec5(-0.5f);
+    auto result8 = vec4.fmadd(vec5, simd_vector<float, 8>(4.0f));
+
+    for (size_t i = 0; i < 8; ++i)
+    {
+        EXPECT_EQ(result8[i], 3.0f);
+    }
+}
+
 TEST(SimdVectorTest, Equality)
 {
     simd_vector<float, 4> vec1(1.0f);
@@ -222,6 +244,14 @@ TEST(SimdVectorTest, HorizontalMin)
     EXPECT_EQ(result, 1.0f);
 }
 
+TEST(SimdVectorTest, HorizontalReductionsAvx)
+{
+    simd_vector<float, 8> vec(3.0f, -7.0f, 1.0f, 8.0f, 2.0f, 5.0f, -1.0f, 4.0f);
+    EXPECT_EQ(vec.horizontal_sum(), 15.0f);
+    EXPECT_EQ(vec.horizontal_max(), 8.0f);
+    EXPECT_EQ(vec.horizontal_min(), -7.0f);
+}
+
 TEST(SimdVectorTest, Shuffle)
 {
     simd_vector<float, 4> vec(1.0f, 2.0f, 3.0f, 4.0f);
@@ -256,6 +286,32 @@ TEST(SimdVectorTest, Blend)
     EXPECT_EQ(result[3], 8.0f);
 }
 
+TEST(SimdVectorTest, BitwiseMasks)
+{
+    simd_vector<float, 4> vec(1.0f, -2.0f, 3.0f, -4.0f);
+    auto positive = vec > simd_vector<float, 4>(0.0f);
+    auto small = vec < simd_vector<float, 4>(2.0f);
+    EXPECT_EQ(positive.movemask(), 0b0101);
+    EXPECT_EQ(small.movemask(), 0b1011);
+    EXPECT_EQ((positive & small).movemask(), 0b0001);
+    EXPECT_EQ((positive | small).movemask(), 0b1111);
+    EXPECT_EQ((positive ^ small).movemask(), 0b1110);
+    EXPECT_EQ(positive.andnot(small).movemask(), 0b1010);
+    EXPECT_EQ(vec.movemask(), 0b1010);
+
+    // masks select lanes: keep the positive values, zero the rest
+    auto kept = positive & vec;
+    EXPECT_EQ(kept[0], 1.0f);
+    EXPECT_EQ(kept[1], 0.0f);
+
+    simd_vector<float, 8> wide(-1.0f);
+    wide &= simd_vector<float, 8>(1.0f) == simd_vector<float, 8>(1.0f);
+    EXPECT_EQ(wide.movemask(), 0xFF);
+    wide ^= wide;
+    EXPECT_EQ(wide.movemask(), 0);
+    EXPECT_EQ(wide[3], 0.0f);
+}
+
 } // namespace simdlib
 
 int main(int argc, char **argv)